@@ -0,0 +1,24 @@
+#include "DroSimStats.h"
+
+DEFINE_STAT(STAT_DroSim_ManagerTick);
+DEFINE_STAT(STAT_DroSim_InitSimulation);
+DEFINE_STAT(STAT_DroSim_HandleSimulationEnd);
+DEFINE_STAT(STAT_DroSim_SpawnDrones);
+DEFINE_STAT(STAT_DroSim_AssignZones);
+DEFINE_STAT(STAT_DroSim_RandomStep);
+DEFINE_STAT(STAT_DroSim_RandomNewDestination);
+DEFINE_STAT(STAT_DroSim_SweepStep);
+DEFINE_STAT(STAT_DroSim_SweepNewDestination);
+DEFINE_STAT(STAT_DroSim_SpiralStep);
+DEFINE_STAT(STAT_DroSim_SpiralNewDestination);
+DEFINE_STAT(STAT_DroSim_DetectObjectives);
+
+DEFINE_STAT(STAT_DroSim_Substeps);
+DEFINE_STAT(STAT_DroSim_DetectionChecks);
+DEFINE_STAT(STAT_DroSim_DestinationRetries);
+
+DEFINE_STAT(STAT_DroSim_SimsCompleted);
+DEFINE_STAT(STAT_DroSim_SimsPerSecond);
+DEFINE_STAT(STAT_DroSim_Coverage);
+
+CSV_DEFINE_CATEGORY_MODULE(DROSIM_API, DroSim, true);
@@ -1,59 +1,41 @@
 #include "Drone.h"
 
-#include "DroneSpiral.h"
+#include "DroSimStats.h"
 #include "DroneSweep.h"
 
 ADrone::ADrone()
 {
-	PrimaryActorTick.bCanEverTick = true;
+	// Drones are stepped by the manager, which owns the simulation clock
+	PrimaryActorTick.bCanEverTick = false;
 
-	// Creation of a mesh component for the drones
-	StaticMesh = CreateDefaultSubobject<UStaticMeshComponent>(TEXT("StaticMesh"));
-	RootComponent = StaticMesh;
-	//static ConstructorHelpers::FObjectFinder<UStaticMesh> MeshAsset(TEXT("/Engine/BasicShapes/Cube.Cube"));
-	static ConstructorHelpers::FObjectFinder<UStaticMesh> MeshAsset(TEXT("/Game/Meshes/Drone_Mesh"));
-	if (MeshAsset.Succeeded()) StaticMesh->SetStaticMesh(MeshAsset.Object);
-
-	// Loading config from .ini file
-	LoadConfig();
+	SceneRoot = CreateDefaultSubobject<USceneComponent>(TEXT("SceneRoot"));
+	RootComponent = SceneRoot;
 }
 
 
 /**
- * Loading configuration from .ini file
+ * Copies the values the drone needs from the shared configuration snapshot.
  *
- * Sets initial values to variables.
+ * Called by the manager between SpawnActorDeferred and FinishSpawning, before BeginPlay().
  */
-void ADrone::LoadConfig()
+void ADrone::ApplyConfig(const DroSimCore::FSimConfig& Config)
 {
-	FString ConfigFilePath = FPaths::ProjectContentDir() + TEXT("SimConfig.ini");
-	ConfigFilePath = FConfigCacheIni::NormalizeConfigIniPath(ConfigFilePath);
-
-	GConfig->LoadFile(ConfigFilePath);
+	TickInterval = Config.Step;
 	
-	GConfig->GetInt(TEXT("sim/global"), TEXT("sim_speed"), SimulationSpeed, ConfigFilePath);
+	MovementTolerance = Config.MovementTolerance;
+	MovementDistance = Config.MovementDistance;
 	
-	GConfig->GetFloat(TEXT("sim/global"), TEXT("step"), TickInterval, ConfigFilePath);
+	EnvSize = FVector2D(Config.EnvSize.X, Config.EnvSize.Y);
+	GroundOffset = Config.GroundOffset;
 	
-	GConfig->GetFloat(TEXT("sim/drones"), TEXT("movement_tolerance"), MovementTolerance, ConfigFilePath);
-	GConfig->GetFloat(TEXT("sim/drones"), TEXT("movement_distance"), MovementDistance, ConfigFilePath);
+	SpiralRadius = Config.SpiralRadius;
+	WanderDistance = Config.WanderDistance;
+	WanderSteps = Config.WanderSteps;
+	SpiralIncrementFactor = Config.SpiralIncrementFactor;
+	DrawsConcentricCircles = Config.DrawsConcentricCircles;
+	NbCirclePoints = Config.NbCirclePoints;
 	
-	GConfig->GetDouble(TEXT("sim/global"), TEXT("environment_X_length"), EnvSize.X, ConfigFilePath);
-	GConfig->GetDouble(TEXT("sim/global"), TEXT("environment_Y_length"), EnvSize.Y, ConfigFilePath);
-
-	GConfig->GetFloat(TEXT("sim/drones"), TEXT("ground_offset"), GroundOffset, ConfigFilePath);
-
-	if (this->GetClass() == ADroneSpiral::StaticClass())
-	{
-		GConfig->GetFloat(TEXT("sim/drones/spiral"), TEXT("spiral_radius"), SpiralRadius, ConfigFilePath);
-		GConfig->GetFloat(TEXT("sim/drones/spiral"), TEXT("wander_distance"), WanderDistance, ConfigFilePath);
-		GConfig->GetInt(TEXT("sim/drones/spiral"), TEXT("wander_steps"), WanderSteps, ConfigFilePath);
-		GConfig->GetFloat(TEXT("sim/drones/spiral"), TEXT("spiral_increment_factor"), SpiralIncrementFactor, ConfigFilePath);
-		GConfig->GetBool(TEXT("sim/drones/spiral"), TEXT("concentric_circles"), DrawsConcentricCircles, ConfigFilePath);
-		GConfig->GetInt(TEXT("sim/drones/spiral"), TEXT("circle_points"), NbCirclePoints, ConfigFilePath);
-	}
-	else if (this->GetClass() == ADroneSweep::StaticClass())
-		GConfig->GetFloat(TEXT("sim/drones/sweep"), TEXT("sweep_height"), SweepHeight, ConfigFilePath);
+	SweepHeight = Config.SweepHeight;
 }
 
 
@@ -63,8 +45,6 @@ void ADrone::LoadConfig()
 void ADrone::BeginPlay()
 {
 	Super::BeginPlay();
-
-	SetActorTickInterval(TickInterval);
 }
 
 
@@ -77,13 +57,11 @@ void ADrone::SetNewDestination() {}
 
 
 /**
- * Update function.
- *
- * This function is called every TickInterval seconds, as set in BeginPlay().
+ * Advances the drone by one substep of TickInterval simulated seconds.
  *
- * @param DeltaTime Time elapsed since last frame.
+ * Overridden by derived Drone classes, which move the drone after this sets up its first destination.
  */
-void ADrone::Tick(float DeltaTime)
+void ADrone::StepSimulation()
 {
 	if (Init)
 	{
@@ -92,23 +70,55 @@ void ADrone::Tick(float DeltaTime)
 		
 		if (this->GetClass() == ADroneSweep::StaticClass())
 		{
-			if (AssignedZone[1].X + AssignedZone[0].Y != 0)
-				SetDestinationManual(FVector(AssignedZone[1].X,AssignedZone[0].Y,GroundOffset));
-			SweepLength = AssignedZone[1].Y - AssignedZone[0].Y;
-			LeftYBound = AssignedZone[0].Y;
+			if (AssignedZone.Min.X + AssignedZone.Min.Y != 0)
+				SetDestinationManual(FVector(AssignedZone.Min.X,AssignedZone.Min.Y,GroundOffset));
+			SweepLength = AssignedZone.Max.Y - AssignedZone.Min.Y;
+			LeftYBound = AssignedZone.Min.Y;
 		}
 		else
 		{
 			SetDestinationManual(FVector(
-		(AssignedZone[0].X + AssignedZone[1].X) / 2.0,
-		(AssignedZone[0].Y + AssignedZone[1].Y) / 2.0,
+		(AssignedZone.Max.X + AssignedZone.Min.X) / 2.0,
+		(AssignedZone.Min.Y + AssignedZone.Max.Y) / 2.0,
 		GroundOffset));
 		}
 		
 		Init = false;
 	}
-	//DrawDebugSphere(GetWorld(), CurrentDestination, 50, 8, FColor::Yellow, false, TickInterval*SimulationSpeed); // Current destination tracker
-	Super::Tick(DeltaTime);
+	//DrawDebugSphere(GetWorld(), CurrentDestination, 50, 8, FColor::Yellow, false, TickInterval); // Current destination tracker
+}
+
+
+/**
+ * Puts a pooled drone back in its initial state for a new simulation.
+ *
+ * The actor is expected to have been moved to its spawn location beforehand.
+ */
+void ADrone::ResetForSimulation(const int NewID, IManagerInterface* NewManager, const FBox2D& NewZone, const DroSimCore::FSimRandom& NewRandom)
+{
+	ID = NewID;
+	Manager = NewManager;
+	AssignedZone = NewZone;
+	Random = NewRandom;
+	
+	Init = true;
+	CalculatedPosition = GetActorLocation();
+	CurrentDestination = FVector::ZeroVector;
+	MoveDirection = FVector(1.0f,0,0);
+	SweepLength = 0;
+	LeftYBound = 0;
+	
+	ResetStrategyState();
+}
+
+
+/**
+ * Shows or hides a pooled drone and enables or disables its collision accordingly.
+ */
+void ADrone::SetPooledActive(const bool bActive)
+{
+	SetActorHiddenInGame(!bActive);
+	SetActorEnableCollision(bActive);
 }
 
 
@@ -128,8 +138,19 @@ void ADrone::SetDestinationManual(const FVector& NewDestination)
  */
 bool ADrone::IsOutOfBounds(const FVector& Point) const
 {
-	return Point.X < AssignedZone[1].X
-		|| Point.Y < AssignedZone[0].Y
-		|| Point.X > AssignedZone[0].X
-		|| Point.Y > AssignedZone[1].Y;
+	return Point.X < AssignedZone.Min.X
+		|| Point.Y < AssignedZone.Min.Y
+		|| Point.X > AssignedZone.Max.X
+		|| Point.Y > AssignedZone.Max.Y;
+}
+
+
+/**
+ * Same as IsOutOfBounds, for rejection sampling loops: every rejected point is counted as a retry.
+ */
+bool ADrone::IsRejected(const FVector& Point) const
+{
+	const bool bIsRejected = IsOutOfBounds(Point);
+	if (bIsRejected) INC_DWORD_STAT(STAT_DroSim_DestinationRetries);
+	return bIsRejected;
 }
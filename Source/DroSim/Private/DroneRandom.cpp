@@ -1,42 +1,36 @@
 #include "DroneRandom.h"
+
+#include "DroSimStats.h"
 #include "Manager.h"
 
 /**
- * Update function.
- *
- * This function is called every TickInterval seconds, as set in BeginPlay().
+ * Advances the drone by one substep of TickInterval simulated seconds.
  *
- * @param DeltaTime Time elapsed since last frame.
+ * Called by the manager, which owns the simulation clock.
  */
-void ADroneRandom::Tick(float DeltaTime)
+void ADroneRandom::StepSimulation()
 {
-	Super::Tick(DeltaTime);
+	DROSIM_SCOPE(RandomStep);
+	Super::StepSimulation();
 
-	CalculatedPosition = GetActorLocation();
-	
-	for (int i = 0; i < SimulationSpeed; i++)
-	{
-		// Calculate the Drone's next location
-		FVector NextLocation = CalculatedPosition + MoveDirection * MovementSpeed * TickInterval;
-		float DistanceToDestination = FVector::Dist(CalculatedPosition, CurrentDestination);
-		float NextDistanceToDestination = FVector::Dist(NextLocation, CurrentDestination);
-	
-		// If the Drone is close enough or has passed its destination, it is considered arrived
-		if (DistanceToDestination <= MovementTolerance)
-		{
-			CalculatedPosition = CurrentDestination;
-			SetNewDestination();
-		}
-		else if (NextDistanceToDestination >= DistanceToDestination) NextLocation = CurrentDestination;
-	
-		CalculatedPosition = NextLocation;
+	const FVector PreviousPosition = CalculatedPosition;
 
-		if (Manager->IsObjectiveNear(CalculatedPosition)) Manager->ObjectiveFound();
+	// Calculate the Drone's next location
+	FVector NextLocation = CalculatedPosition + MoveDirection * MovementSpeed * TickInterval;
+	float DistanceToDestination = FVector::Dist(CalculatedPosition, CurrentDestination);
+	float NextDistanceToDestination = FVector::Dist(NextLocation, CurrentDestination);
+
+	// If the Drone is close enough or has passed its destination, it is considered arrived
+	if (DistanceToDestination <= MovementTolerance)
+	{
+		CalculatedPosition = CurrentDestination;
+		SetNewDestination();
 	}
+	else if (NextDistanceToDestination >= DistanceToDestination) NextLocation = CurrentDestination;
+
+	CalculatedPosition = NextLocation;
 
-	SetActorLocation(CalculatedPosition);
-	SetActorRotation(MoveDirection.Rotation());
-	DrawDebugCircle(GetWorld(),CalculatedPosition,Manager->GetVisionRadius(),32,FColor::Yellow,false,TickInterval,0,10,FVector(0,1,0),FVector(1,0,0),false);
+	Manager->DetectObjectives(PreviousPosition, CalculatedPosition);
 }
 
 
@@ -47,12 +41,13 @@ void ADroneRandom::Tick(float DeltaTime)
  */
 void ADroneRandom::SetNewDestination()
 {
+	DROSIM_SCOPE(RandomNewDestination);
 	do
 	{
 		// Random direction vector in a cone
 		FVector NewMoveDirection = FVector(
-                			MoveDirection.X + FMath::RandRange(-1.0f,1.0f),
-                			MoveDirection.Y + FMath::RandRange(-1.0f,1.0f),
+                			MoveDirection.X + Random.RandRange(-1.0f,1.0f),
+                			MoveDirection.Y + Random.RandRange(-1.0f,1.0f),
                 			0);
 
 		// Normalize the direction vector
@@ -62,6 +57,6 @@ void ADroneRandom::SetNewDestination()
 		
         CurrentDestination = CalculatedPosition + MoveDirection * MovementDistance;
 	}
-	while (IsOutOfBounds(CurrentDestination));
+	while (IsRejected(CurrentDestination));
 	// Redo if the next destination is outside environment limits
 }
@@ -1,41 +1,35 @@
 #include "DroneSpiral.h"
 
+#include "DroSimStats.h"
+
 /**
- * Update function.
- *
- * This function is called every TickInterval seconds, as set in BeginPlay().
+ * Advances the drone by one substep of TickInterval simulated seconds.
  *
- * @param DeltaTime Time elapsed since last frame.
+ * Called by the manager, which owns the simulation clock.
  */
-void ADroneSpiral::Tick(float DeltaTime)
+void ADroneSpiral::StepSimulation()
 {
-	Super::Tick(DeltaTime);
+	DROSIM_SCOPE(SpiralStep);
+	Super::StepSimulation();
 
-	CalculatedPosition = GetActorLocation();
-	
-	for (int i = 0; i < SimulationSpeed; i++)
-	{
-		// Calculate the Drone's next location
-		FVector NextLocation = CalculatedPosition + MoveDirection * MovementSpeed * TickInterval;
-		float DistanceToDestination = FVector::Dist(CalculatedPosition, CurrentDestination);
-		float NextDistanceToDestination = FVector::Dist(NextLocation, CurrentDestination);
+	const FVector PreviousPosition = CalculatedPosition;
 
-		// If the Drone is close enough or has passed its destination, it is considered arrived
-		if (DistanceToDestination <= MovementTolerance)
-		{
-			if (--Wander == 0) SetCircle();
-			SetNewDestination();
-		}
-		else if (NextDistanceToDestination >= DistanceToDestination) NextLocation = CurrentDestination;
-	
-		CalculatedPosition = NextLocation;
+	// Calculate the Drone's next location
+	FVector NextLocation = CalculatedPosition + MoveDirection * MovementSpeed * TickInterval;
+	float DistanceToDestination = FVector::Dist(CalculatedPosition, CurrentDestination);
+	float NextDistanceToDestination = FVector::Dist(NextLocation, CurrentDestination);
 
-		if (Manager->IsObjectiveNear(CalculatedPosition)) Manager->ObjectiveFound();
+	// If the Drone is close enough or has passed its destination, it is considered arrived
+	if (DistanceToDestination <= MovementTolerance)
+	{
+		if (--Wander == 0) SetCircle();
+		SetNewDestination();
 	}
+	else if (NextDistanceToDestination >= DistanceToDestination) NextLocation = CurrentDestination;
+
+	CalculatedPosition = NextLocation;
 
-	SetActorLocation(CalculatedPosition);
-	SetActorRotation(MoveDirection.Rotation());
-	DrawDebugCircle(GetWorld(),CalculatedPosition,Manager->GetVisionRadius(),32,FColor::Yellow,false,TickInterval,0,10,FVector(0,1,0),FVector(1,0,0),false);
+	Manager->DetectObjectives(PreviousPosition, CalculatedPosition);
 }
 
 
@@ -46,6 +40,7 @@ void ADroneSpiral::Tick(float DeltaTime)
  */
 void ADroneSpiral::SetNewDestination()
 {
+	DROSIM_SCOPE(SpiralNewDestination);
 	if (Wander > 0) GetRandomDirection();
 	else // Making spiral
 	{
@@ -117,13 +112,31 @@ void ADroneSpiral::GetRandomDirection()
 	do
 	{
 		FVector NewMoveDirection = FVector(
-		MoveDirection.X + FMath::RandRange(-1.0f,1.0f),
-		MoveDirection.Y + FMath::RandRange(-1.0f,1.0f),
+		MoveDirection.X + Random.RandRange(-1.0f,1.0f),
+		MoveDirection.Y + Random.RandRange(-1.0f,1.0f),
 		0);
 		float Magnitude = NewMoveDirection.Size();
 		if (Magnitude > UE_SMALL_NUMBER) MoveDirection = NewMoveDirection / Magnitude;
 		else MoveDirection = NewMoveDirection;
 		CurrentDestination = CalculatedPosition + MoveDirection * WanderDistance;
 	}
-	while (IsOutOfBounds(CurrentDestination));
-}
\ No newline at end of file
+	while (IsRejected(CurrentDestination));
+}
+
+
+/**
+ * Resets the wandering and spiral progress of a pooled drone.
+ */
+void ADroneSpiral::ResetStrategyState()
+{
+	Wander = WanderSteps;
+	Precision = 0;
+	HotSpot = FVector::ZeroVector;
+	SpotCertainty = -1;
+	CirclePoints.Empty();
+	CurrentCirclePointId = 0;
+	CurrentIntermediatePoint = FVector::ZeroVector;
+	CurrentCircleCenter = FVector::ZeroVector;
+	CurrentCircleCount = 0;
+	CurrentSpiralIncrementFactor = 0;
+}
@@ -1,41 +1,35 @@
 #include "DroneSweep.h"
 
+#include "DroSimStats.h"
+
 /**
- * Update function.
- *
- * This function is called every TickInterval seconds, as set in BeginPlay().
+ * Advances the drone by one substep of TickInterval simulated seconds.
  *
- * @param DeltaTime Time elapsed since last frame.
+ * Called by the manager, which owns the simulation clock.
  */
-void ADroneSweep::Tick(float DeltaTime)
+void ADroneSweep::StepSimulation()
 {
-	Super::Tick(DeltaTime);
+	DROSIM_SCOPE(SweepStep);
+	Super::StepSimulation();
 
-	CalculatedPosition = GetActorLocation();
-
-	for (int i = 0; i < SimulationSpeed; i++)
-	{
-		// Calculate the Drone's next location
-		FVector NextLocation = CalculatedPosition + MoveDirection * MovementSpeed * TickInterval;
-		float DistanceToDestination = FVector::Dist(CalculatedPosition, CurrentDestination);
-		float NextDistanceToDestination = FVector::Dist(NextLocation, CurrentDestination);
-	
-		// If the Drone is close enough or has passed its destination, it is considered arrived
-		if (DistanceToDestination <= MovementTolerance)
-		{
-			CalculatedPosition = CurrentDestination;
-			SetNewDestination();
-		}
-		else if (NextDistanceToDestination >= DistanceToDestination) NextLocation = CurrentDestination;
+	const FVector PreviousPosition = CalculatedPosition;
 
-		CalculatedPosition = NextLocation;
+	// Calculate the Drone's next location
+	FVector NextLocation = CalculatedPosition + MoveDirection * MovementSpeed * TickInterval;
+	float DistanceToDestination = FVector::Dist(CalculatedPosition, CurrentDestination);
+	float NextDistanceToDestination = FVector::Dist(NextLocation, CurrentDestination);
 
-		if (Manager->IsObjectiveNear(CalculatedPosition)) Manager->ObjectiveFound();
+	// If the Drone is close enough or has passed its destination, it is considered arrived
+	if (DistanceToDestination <= MovementTolerance)
+	{
+		CalculatedPosition = CurrentDestination;
+		SetNewDestination();
 	}
+	else if (NextDistanceToDestination >= DistanceToDestination) NextLocation = CurrentDestination;
 
-	SetActorLocation(CalculatedPosition);
-	SetActorRotation(MoveDirection.Rotation());
-	DrawDebugCircle(GetWorld(),CalculatedPosition,Manager->GetVisionRadius(),32,FColor::Yellow,false,TickInterval,0,10,FVector(0,1,0),FVector(1,0,0),false);
+	CalculatedPosition = NextLocation;
+
+	Manager->DetectObjectives(PreviousPosition, CalculatedPosition);
 }
 
 
@@ -46,6 +40,7 @@ void ADroneSweep::Tick(float DeltaTime)
  */
 void ADroneSweep::SetNewDestination()
 {
+	DROSIM_SCOPE(SweepNewDestination);
 	if (GoesUp && CalculatedPosition.X >= SweepHeight * HeightCount)
 	{
 		if (LeftToRight) MoveDirection = FVector(0,1.0f,0);
@@ -70,8 +65,20 @@ void ADroneSweep::SetNewDestination()
 			CurrentDestination = CalculatedPosition - MoveDirection * MovementDistance;
 			TopToBottom = !TopToBottom;
 		}
-		else if (LeftToRight) CurrentDestination = CalculatedPosition + MoveDirection * (AssignedZone[1].Y - CalculatedPosition.Y);
-        else CurrentDestination = CalculatedPosition + MoveDirection * (CalculatedPosition.Y - AssignedZone[0].Y);
+		else if (LeftToRight) CurrentDestination = CalculatedPosition + MoveDirection * (AssignedZone.Max.Y - CalculatedPosition.Y);
+        else CurrentDestination = CalculatedPosition + MoveDirection * (CalculatedPosition.Y - AssignedZone.Min.Y);
 	}
 	
 }
+
+
+/**
+ * Resets the sweep progress of a pooled drone.
+ */
+void ADroneSweep::ResetStrategyState()
+{
+	GoesUp = true;
+	TopToBottom = false;
+	LeftToRight = true;
+	HeightCount = 0;
+}
@@ -1,12 +1,14 @@
 #include "Manager.h"
 
-#include "Misc/ConfigCacheIni.h"
-#include "DrawDebugHelpers.h"
+#include <algorithm>
+
+#include "DroSimStats.h"
 #include "Drone.h"
 #include "DroneRandom.h"
 #include "DroneSweep.h"
 #include "DroneSpiral.h"
 #include "Objective.h"
+#include "SimCore/SimDetection.h"
 
 
 AManager::AManager()
@@ -20,6 +22,20 @@ AManager::AManager()
 	static ConstructorHelpers::FObjectFinder<UStaticMesh> MeshAsset(TEXT("/Game/Meshes/Ship_Mesh"));
 	if (MeshAsset.Succeeded()) StaticMesh->SetStaticMesh(MeshAsset.Object); 
 
+	// Every drone is an instance of a single mesh, in world space, instead of an actor with its own mesh
+	DroneMeshes = CreateDefaultSubobject<UInstancedStaticMeshComponent>(TEXT("DroneMeshes"));
+	DroneMeshes->SetupAttachment(RootComponent);
+	DroneMeshes->SetAbsolute(true, true, true);
+	DroneMeshes->SetCollisionEnabled(ECollisionEnabled::NoCollision);
+	static ConstructorHelpers::FObjectFinder<UStaticMesh> DroneMeshAsset(TEXT("/Game/Meshes/Drone_Mesh"));
+	if (DroneMeshAsset.Succeeded()) DroneMeshes->SetStaticMesh(DroneMeshAsset.Object);
+
+	// Batched line drawing, instead of one debug draw call per line
+	EnvironmentLines = CreateDefaultSubobject<ULineBatchComponent>(TEXT("EnvironmentLines"));
+	EnvironmentLines->SetupAttachment(RootComponent);
+	VisionLines = CreateDefaultSubobject<ULineBatchComponent>(TEXT("VisionLines"));
+	VisionLines->SetupAttachment(RootComponent);
+
 	// Loading config from .ini file
 	LoadConfig();
 }
@@ -28,41 +44,42 @@ AManager::AManager()
 /**
  * Loading configuration from .ini file
  *
- * Sets initial values to variables.
+ * The file is parsed and validated once into a read-only snapshot, which is handed to every Drone and Objective
+ * spawned. Sets initial values to variables.
  */
 void AManager::LoadConfig()
 {
-	FString ConfigFilePath = FPaths::ProjectContentDir() + TEXT("SimConfig.ini");
-	ConfigFilePath = FConfigCacheIni::NormalizeConfigIniPath(ConfigFilePath);
+	const FString ConfigFilePath = FPaths::ProjectContentDir() + TEXT("SimConfig.ini");
 
-	GConfig->LoadFile(ConfigFilePath);
-	
-	GConfig->GetDouble(TEXT("sim/global"), TEXT("environment_X_length"), EnvSize.X, ConfigFilePath);
-	GConfig->GetDouble(TEXT("sim/global"), TEXT("environment_Y_length"), EnvSize.Y, ConfigFilePath);
-	GConfig->GetFloat(TEXT("sim/objective"), TEXT("min_distance_ratio"), ObjectiveMinDistanceRatio, ConfigFilePath);
-	GConfig->GetInt(TEXT("sim/manager"), TEXT("env_max_columns"), ColMax, ConfigFilePath);
-
-	GConfig->GetInt(TEXT("sim/global"), TEXT("sim_speed"), SimulationSpeed, ConfigFilePath);
-	GConfig->GetFloat(TEXT("sim/global"), TEXT("step"), TickInterval, ConfigFilePath);
-	GConfig->GetInt(TEXT("sim/manager"), TEXT("sim_group_size"), SimGroupSize, ConfigFilePath);
-	GConfig->GetInt(TEXT("sim/global"), TEXT("lines_thickness"), LinesThickness, ConfigFilePath);
-
-	GConfig->GetInt(TEXT("sim/drones"), TEXT("strategy"), StrategyID, ConfigFilePath);
-	GConfig->GetFloat(TEXT("sim/drones"), TEXT("ground_offset"), DronesGroundOffset, ConfigFilePath);
-
-	GConfig->GetFloat(TEXT("sim/drones"), TEXT("min_speed"), MinSpeed, ConfigFilePath);
-	GConfig->GetFloat(TEXT("sim/drones"), TEXT("max_speed"), MaxSpeed, ConfigFilePath);
-	GConfig->GetInt(TEXT("sim/manager"), TEXT("min_drones"), MinNumDrones, ConfigFilePath);
-	GConfig->GetInt(TEXT("sim/manager"), TEXT("max_drones"), MaxNumDrones, ConfigFilePath);
-	GConfig->GetFloat(TEXT("sim/drones"), TEXT("battery_capacity"), BatteryCapacity, ConfigFilePath);
-	GConfig->GetFloat(TEXT("sim/drones"), TEXT("battery_weight"), BatteryWeight, ConfigFilePath);
-	GConfig->GetInt(TEXT("sim/drones"), TEXT("min_battery_count"), MinBatteryCount, ConfigFilePath);
-	GConfig->GetInt(TEXT("sim/drones"), TEXT("max_battery_count"), MaxBatteryCount, ConfigFilePath);
-	GConfig->GetFloat(TEXT("sim/drones"), TEXT("initial_weight"), InitialWeight, ConfigFilePath);
-	GConfig->GetFloat(TEXT("sim/drones"), TEXT("vision_radius"), VisionRadius, ConfigFilePath);
+	std::string Error;
+	Config = DroSimCore::FSimConfig::LoadShared(TCHAR_TO_UTF8(*FPaths::ConvertRelativePathToFull(ConfigFilePath)), Error);
+	if (!Config)
+	{
+		UE_LOG(LogTemp, Warning, TEXT("Invalid %s : %hs, using default values"), *ConfigFilePath, Error.c_str());
+		Config = std::make_shared<const DroSimCore::FSimConfig>();
+	}
 	
-	GConfig->GetFloat(TEXT("sim/manager"), TEXT("speed_increment"), SpeedIncrement, ConfigFilePath);
-	GConfig->GetInt(TEXT("sim/manager"), TEXT("drone_increment"), DroneIncrement, ConfigFilePath);
+	EnvSize = FVector2D(Config->EnvSize.X, Config->EnvSize.Y);
+	ObjectiveMinDistanceRatio = Config->ObjectiveMinDistanceRatio;
+
+	SimulationSpeed = Config->SimulationSpeed;
+	TickInterval = Config->Step;
+	bIsMaxThroughput = Config->IsMaxThroughput;
+	bUsesCoreBackend = Config->Backend == DroSimCore::ESimBackend::Core;
+	FrameBudgetMs = Config->FrameBudgetMs;
+	MaxStepsPerFrame = Config->MaxStepsPerFrame;
+	SimGroupSize = Config->SimGroupSize;
+	LinesThickness = Config->LinesThickness;
+
+	StrategyID = (int)Config->Strategy;
+	DronesGroundOffset = Config->GroundOffset;
+
+	VisionRadius = Config->VisionRadius;
+
+	// -DroSimNoRender and -DroSimRender override the config, for farm runs
+	bIsRenderEnabled = Config->IsRenderEnabled;
+	if (FParse::Param(FCommandLine::Get(), TEXT("DroSimNoRender"))) bIsRenderEnabled = false;
+	if (FParse::Param(FCommandLine::Get(), TEXT("DroSimRender"))) bIsRenderEnabled = true;
 }
 
 
@@ -72,214 +89,471 @@ void AManager::LoadConfig()
 void AManager::BeginPlay()
 {
 	Super::BeginPlay();
-	
-	SetActorTickInterval(TickInterval);
 
-	// Initial config for the first group of simulations
-	GroupSpeed = MinSpeed;
-	GroupNumDrones = MinNumDrones;
-	GroupBatteryCount = MinBatteryCount;
-	MaxTimePerSim = CalculateMaximumAutonomy();
+	// Same search as DroSimCli, it picks the first group of simulations and every following one
+	Search = DroSimCore::FSimSearch::Make(*Config);
+	Search->SetLogger([](const std::string& Text) { UE_LOG(LogTemp, Warning, TEXT("%hs"), Text.c_str()); });
 
-	const int SimSec = (int)(TickInterval * SimulationSpeed);
-	UE_LOG(LogTemp,Warning,TEXT("Current simulation speed : 1 simulated second = %d real second%hs"),
-		SimSec, SimSec > 1 ? "s" : "");
+	// A fixed seed replays the same sweep, see DroSimCli --replay for single simulations
+	SweepSeed = Config->Seed != 0 ? Config->Seed : (uint32)FMath::Rand();
 
-	PrintSimConfigRecap();
+	// Search state saved to checkpoint_file between groups, -DroSimResume continues from it
+	int64 RecordsSize = -1;
+	if (!Config->CheckpointFile.empty())
+	{
+		CheckpointPath = TCHAR_TO_UTF8(*FPaths::ConvertRelativePathToFull(FPaths::ProjectDir(), UTF8_TO_TCHAR(Config->CheckpointFile.c_str())));
+		NextCheckpointTime = FPlatformTime::Seconds() + Config->CheckpointInterval;
+		if (FParse::Param(FCommandLine::Get(), TEXT("DroSimResume"))) LoadCheckpoint(RecordsSize);
+	}
+	RefreshGroupParams();
+	UE_LOG(LogTemp,Warning,TEXT("Seed : %u"), SweepSeed);
+
+	// Per-simulation records, appended to records_file (relative to the project directory)
+	if (!Config->RecordsFile.empty())
+	{
+		const FString RecordsPath = FPaths::ConvertRelativePathToFull(FPaths::ProjectDir(), UTF8_TO_TCHAR(Config->RecordsFile.c_str()));
+		std::string Error;
+		if (!RecordWriter.Open(TCHAR_TO_UTF8(*RecordsPath), Error, RecordsSize))
+			UE_LOG(LogTemp, Warning, TEXT("%hs, simulations will not be recorded"), Error.c_str());
+	}
+
+	// Groups already run are read from cache_dir. Actors do not step exactly as the headless core does,
+	// so their outcomes are kept apart from the ones of DroSimCli, which the core backend shares
+	if (!Config->CacheDir.empty())
+	{
+		FString CacheDir = FPaths::ConvertRelativePathToFull(FPaths::ProjectDir(), UTF8_TO_TCHAR(Config->CacheDir.c_str()));
+		if (!bUsesCoreBackend) CacheDir /= TEXT("engine");
+		std::string Error;
+		if (!GroupCache.Open(TCHAR_TO_UTF8(*CacheDir), Error))
+			UE_LOG(LogTemp, Warning, TEXT("%hs, groups will not be cached"), Error.c_str());
+	}
+
+	if (!bIsRenderEnabled)
+	{
+		UE_LOG(LogTemp,Warning,TEXT("Render-free mode : drones and visuals are not drawn"));
+		StaticMesh->SetVisibility(false);
+		DroneMeshes->SetVisibility(false);
+	}
+
+	if (bUsesCoreBackend)
+		UE_LOG(LogTemp,Warning,TEXT("Core backend : drones and objectives are simulated without actors"));
+
+	if (bIsMaxThroughput)
+		UE_LOG(LogTemp,Warning,TEXT("Max throughput mode : simulating for %g ms per frame"), FrameBudgetMs);
+	else
+		UE_LOG(LogTemp,Warning,TEXT("Current simulation speed : 1 real second = %d simulated second%hs"),
+			SimulationSpeed, SimulationSpeed > 1 ? "s" : "");
+
+	Search->PrintSimConfigRecap();
 	
 	ManageNewSimulation();
 }
 
 
 /**
- * Prints to screen a recap of the current group settings.
+ * Last function to be executed before destruction, writes the records still in memory.
  */
-void AManager::PrintSimConfigRecap() const
+void AManager::EndPlay(const EEndPlayReason::Type EndPlayReason)
 {
-	UE_LOG(LogTemp, Warning, TEXT("Trying with %d drone%hs at %d m/s"),
-		GroupNumDrones, GroupNumDrones > 1 ? "s" : "",(int)GroupSpeed);
-	
-	UE_LOG(LogTemp,Warning,TEXT("Maximum autonomy : %d min (%d simulated seconds)"),
-		(int)floor(MaxTimePerSim / 60),
-		(int)(MaxTimePerSim / (TickInterval * SimulationSpeed)));
+	RecordWriter.Close();
+	Super::EndPlay(EndPlayReason);
 }
 
 
 /**
- * Update function.
+ * Update function, called every frame.
  *
- * This function is called every TickInterval seconds, as set in BeginPlay().
+ * The manager owns the simulation clock: entities only move in fixed substeps of TickInterval simulated seconds.
+ * By default sim_speed simulated seconds are run per real second; in max throughput mode, as many substeps as
+ * frame_budget_ms allows are run instead, so sweeps are bound by the CPU rather than by frame pacing.
  *
  * @param DeltaTime Time elapsed since last frame.
  */
 void AManager::Tick(float DeltaTime)
 {
+	DROSIM_SCOPE(ManagerTick);
 	Super::Tick(DeltaTime);
-	
-	CurrentSimulatedTime += DeltaTime * SimulationSpeed;
-	
-	if (CurrentSimulatedTime >= MaxTimePerSim) HandleSimulationEnd();
+
+	int Steps = 0;
+	if (bIsMaxThroughput)
+	{
+		// The clock is only read every few substeps, a substep is much cheaper than the call
+		const double Deadline = FPlatformTime::Seconds() + FrameBudgetMs / 1000.0;
+		while (!SimulationHasEnded && Steps < MaxStepsPerFrame)
+		{
+			StepSimulation();
+			if (++Steps % 16 == 0 && FPlatformTime::Seconds() >= Deadline) break;
+		}
+	}
+	else
+	{
+		StepAccumulator += DeltaTime * SimulationSpeed;
+		while (!SimulationHasEnded && StepAccumulator >= TickInterval && Steps < MaxStepsPerFrame)
+		{
+			StepSimulation();
+			StepAccumulator -= TickInterval;
+			Steps++;
+		}
+		// Substeps a slow frame could not run are dropped rather than piled up for the next frames
+		if (Steps == MaxStepsPerFrame) StepAccumulator = 0;
+	}
+
+	INC_DWORD_STAT_BY(STAT_DroSim_Substeps, Steps);
+	CSV_CUSTOM_STAT(DroSim, Substeps, Steps, ECsvCustomStatOp::Set);
+	SET_FLOAT_STAT(STAT_DroSim_Coverage, GetCoverage() * 100);
+	CSV_CUSTOM_STAT(DroSim, Coverage, GetCoverage() * 100, ECsvCustomStatOp::Set);
+	UpdateThroughputStats();
+
+	if (bIsRenderEnabled && !SimulationHasEnded)
+	{
+		DrawDrones();
+		if (CoreSimulation) DrawCoreSimulation();
+		else
+		{
+			for (AObjective* o : CurrentSimulatedObjectives) o->SyncActor();
+			DrawVisionCircles();
+		}
+	}
 }
 
 
 /**
- * Management function.
+ * Advances the objectives, then every drone, by one substep of TickInterval simulated seconds.
  *
- * The execution flow always comes back to this function unless the simulation is over.
+ * The simulation ends after the substep in which enough objectives are found, at the moment of the contact that
+ * completed it, or once the maximum time is reached, or with the energy model once every drone has emptied its
+ * battery.
+ * With the core backend, the substep is run by the core simulation instead.
  */
-void AManager::ManageNewSimulation()
+void AManager::StepSimulation()
 {
-	if (CurrentGroupSim++ == SimGroupSize) // End of current group
-        {
-			// If >50% of simulations result in a success, the configuration is successful
-			if (SimGroupSize == 1) MutateSimulationParameters(SuccessfulSim == 1);
-        	else MutateSimulationParameters(SuccessfulSim >= SimGroupSize/2);
-        	SuccessfulSim = 0;
-        	CurrentGroupSim = 1;
-        }
-	InitSimulation();
+	if (CoreSimulation)
+	{
+		// Same simulation as DroSimCli, the manager only reads its outcome
+		const bool IsRunning = CoreSimulation->Step();
+		CurrentSimulatedTime = CoreSimulation->GetCurrentSimulatedTime();
+		if (IsRunning) return;
+		if (CoreSimulation->GetOutcome().Found) ObjectiveFound();
+		else if (CoreSimulation->GetOutcome().EndedHopeless)
+			UE_LOG(LogTemp,Warning,TEXT("Hopeless after %d min"),(int)(CurrentSimulatedTime/60));
+		else if (CoreSimulation->GetOutcome().EndedDepleted)
+			UE_LOG(LogTemp,Warning,TEXT("Every battery empty after %d min"),(int)(CurrentSimulatedTime/60));
+		HandleSimulationEnd();
+		return;
+	}
+
+	SubstepStartTime = CurrentSimulatedTime;
+	CurrentSimulatedTime += TickInterval;
+
+	// Paths of the objectives over the substep, the grid has to be refit before they move
+	for (int i = 0; i < CurrentSimulatedObjectives.Num(); i++)
+	{
+		const FVector& Position = CurrentSimulatedObjectives[i]->GetCalculatedPosition();
+		ObjectiveStarts[i] = DroSimCore::FSimVec3(Position.X,Position.Y,Position.Z);
+	}
+	if (CurrentSimulatedObjectives.Num() > 1)
+		ObjectiveGrid.Refit(ObjectiveStarts, IsObjectiveFound, Config->ObjectiveIsMoving ? Config->ObjectiveSpeed * TickInterval : 0);
+	for (int i = 0; i < CurrentSimulatedObjectives.Num(); i++)
+	{
+		CurrentSimulatedObjectives[i]->StepSimulation();
+		const FVector& Position = CurrentSimulatedObjectives[i]->GetCalculatedPosition();
+		ObjectiveEnds[i] = DroSimCore::FSimVec3(Position.X,Position.Y,Position.Z);
+	}
+
+	for (int i = 0; i < CurrentSimulatedDrones.Num(); i++)
+	{
+		// Drones with an empty battery stay where they are
+		if (Config->EnergyModel && DroneEnergies[i] <= 0) continue;
+		const FVector PreviousPosition = CurrentSimulatedDrones[i]->GetCalculatedPosition();
+		const FVector PreviousDirection = CurrentSimulatedDrones[i]->GetMoveDirection();
+		CurrentSimulatedDrones[i]->StepSimulation();
+		if (Config->EnergyModel) DrainBattery(i, PreviousPosition, PreviousDirection);
+	}
+
+	// A drone moved later may have seen an objective earlier in the substep, contacts are only settled now
+	if (NumFoundObjectives >= Config->RequiredObjectives())
+	{
+		CurrentSimulatedTime = GetCompletionTime();
+		ObjectiveFound();
+	}
+
+	if (ReportedSimID == SimID || CurrentSimulatedTime >= MaxTimePerSim)
+	{
+		HandleSimulationEnd();
+		return;
+	}
+	if (Config->EnergyModel && NumActiveDrones == 0)
+	{
+		UE_LOG(LogTemp,Warning,TEXT("Every battery empty after %d min"),(int)(CurrentSimulatedTime/60));
+		HandleSimulationEnd();
+		return;
+	}
+
+	if (++StepsSinceCoverageStamp >= CoverageStampInterval) StampCoverage();
+	if (Config->CoverageEarlyStop && CurrentSimulatedTime >= NextHopelessCheck)
+	{
+		// Heuristic, see DroSimCore::FSimCoverage::IsHopeless: drones stalled outside the objective's reach are
+		// assumed to stay there, so the simulation ends as failed before the maximum time
+		NextHopelessCheck = CurrentSimulatedTime + Config->CoverageStallTime / 10;
+		if (IsHopeless())
+		{
+			UE_LOG(LogTemp,Warning,TEXT("Hopeless after %d min"),(int)(CurrentSimulatedTime/60));
+			HandleSimulationEnd();
+		}
+	}
 }
 
 
 /**
- * Mutates configuration of the current group of simulations, based on the outcome it gave.
- * 
- * @param IsGroupSuccessful True if the current group configuration is successful, false otherwise.
+ * Takes the energy of a substep of flight from the battery of a drone, and that of its turn if it picked a new
+ * direction, as DroSimCore::FSimulation::DrainBatteries does. A drone whose battery runs out during a substep still
+ * completes it.
  */
-void AManager::MutateSimulationParameters(const bool IsGroupSuccessful)
+void AManager::DrainBattery(const int DroneIndex, const FVector& PreviousPosition, const FVector& PreviousDirection)
 {
-	if (IsGroupSuccessful)
+	const ADrone* Drone = CurrentSimulatedDrones[DroneIndex];
+	const FVector& Direction = Drone->GetMoveDirection();
+	const double Speed = FMath::Min(FVector::Dist(PreviousPosition, Drone->GetCalculatedPosition()) / TickInterval, (double)GroupSpeed);
+	double& Energy = DroneEnergies[DroneIndex];
+	Energy -= Config->MovePower(Speed, GroupBatteryCount) * TickInterval + DroneHoverStepEnergy;
+	if (Direction != PreviousDirection)
+		Energy -= DroneTurnEnergyPerRadian * FMath::Acos(FMath::Clamp(Direction.GetSafeNormal() | PreviousDirection.GetSafeNormal(), -1., 1.));
+	if (Energy <= 0) NumActiveDrones--;
+}
+
+
+/**
+ * Starts the coverage map of the zones of the current drones.
+ */
+void AManager::ResetCoverage()
+{
+	Coverage.Reset(*Config, *CurrentZones);
+
+	// Drones move less than the stamp distance between two stamps
+	CoverageStampInterval = FMath::Max(1, (int)(Coverage.GetStampDistance() / (GroupSpeed * TickInterval)));
+	NextHopelessCheck = 0;
+	StampCoverage();
+}
+
+
+/**
+ * Adds the ground seen from the current drone positions to the coverage map.
+ */
+void AManager::StampCoverage()
+{
+	StepsSinceCoverageStamp = 0;
+	for (const ADrone* d : CurrentSimulatedDrones)
 	{
-		UE_LOG(LogTemp, Warning, TEXT("Success"));
-		UE_LOG(LogTemp,Warning,TEXT("Average of %d min to find"),(int)(SummedTimesToFind/SuccessfulSim/60));
-		
-		// Calculate the least amount of batteries required
-		CalculateMinBatteryCountForGroup();
-		UE_LOG(LogTemp, Warning, TEXT("Consumes %d Wh over %d batter%hs (total capacity of %d Wh)"),
-			(int)CurrentConsumption, GroupBatteryCount, GroupBatteryCount > 1 ? "ies" : "y", (int)(GroupBatteryCount * BatteryCapacity));
+		const FVector& Position = d->GetCalculatedPosition();
+		Coverage.Stamp(d->ID - 1, DroSimCore::FSimVec3(Position.X,Position.Y,Position.Z), CurrentSimulatedTime);
 	}
-	else UE_LOG(LogTemp, Warning, TEXT("Fail"));
-	
-	SummedTimesToFind = 0;
-	
-	if (!IsCurveFound || IsGroupSuccessful)
+}
+
+
+/**
+ * Moment the objective completing the simulation was found, see DroSimCore::FSimConfig::RequiredObjectives.
+ */
+float AManager::GetCompletionTime() const
+{
+	std::vector<float> FoundTimes;
+	for (const float Time : ObjectiveFoundTimes) if (Time >= 0) FoundTimes.push_back(Time);
+	const int Rank = Config->RequiredObjectives() - 1;
+	std::nth_element(FoundTimes.begin(), FoundTimes.begin() + Rank, FoundTimes.end());
+	return FoundTimes[Rank];
+}
+
+
+/**
+ * Whether too few of the objectives not found yet can still be found to complete the simulation.
+ */
+bool AManager::IsHopeless() const
+{
+	const int RequiredObjectives = Config->RequiredObjectives();
+	int ReachableObjectives = NumFoundObjectives;
+	for (int i = 0; i < CurrentSimulatedObjectives.Num() && ReachableObjectives < RequiredObjectives; i++)
 	{
-		// We overwrite the saved config as we don't need it right now
-        PreviousSpeed = GroupSpeed;
-        PreviousBatteryCount = GroupBatteryCount;
+		const FVector& Position = CurrentSimulatedObjectives[i]->GetCalculatedPosition();
+		if (!IsObjectiveFound[i] && !Coverage.IsHopeless(DroSimCore::FSimVec3(Position.X,Position.Y,Position.Z), CurrentSimulatedTime))
+			ReachableObjectives++;
 	}
-	
-	if (IsCurveFound && IsMaxFound)
-	{
-		if (IsGroupSuccessful && GroupSpeed - SpeedIncrement >= MinSpeed) GroupSpeed -= SpeedIncrement;
-        else
-        {
-            SlowConfigs.Add({
-            	PreviousSpeed,
-            	(float)GroupNumDrones,
-            	(float)PreviousBatteryCount,
-            	InitialWeight + PreviousBatteryCount * BatteryWeight});
-            
-            GroupNumDrones += DroneIncrement;
-            
-            // We save the current config for later comparison
-            PreviousSpeed = GroupSpeed;
-            PreviousBatteryCount = GroupBatteryCount;
-        }
+	return ReachableObjectives < RequiredObjectives;
+}
+
+
+/**
+ * Covered fraction of the zones of the current simulation, between 0 and 1.
+ *
+ * The core backend only maps coverage with coverage_early_stop, 0 otherwise.
+ */
+float AManager::GetCoverage() const
+{
+	if (CoreSimulation) return CoreSimulation->IsTrackingCoverage() ? CoreSimulation->GetCoverage() : 0;
+	return Coverage.GetCoverage();
+}
+
+
+/**
+ * Refreshes the simulations per second stat, averaged over the last second or so.
+ */
+void AManager::UpdateThroughputStats()
+{
+	const double Now = FPlatformTime::Seconds();
+	if (ThroughputWindowStart == 0) ThroughputWindowStart = Now;
+	if (Now - ThroughputWindowStart < 1) return;
+
+	const float SimsPerSecond = ThroughputWindowSims / (Now - ThroughputWindowStart);
+	SET_FLOAT_STAT(STAT_DroSim_SimsPerSecond, SimsPerSecond);
+	CSV_CUSTOM_STAT(DroSim, SimsPerSecond, SimsPerSecond, ECsvCustomStatOp::Set);
+	ThroughputWindowStart = Now;
+	ThroughputWindowSims = 0;
+}
+
+
+/**
+ * Management function.
+ *
+ * The execution flow always comes back to this function unless the simulation is over.
+ */
+void AManager::ManageNewSimulation()
+{
+	// If >50% of simulations result in a success, the configuration is successful.
+	// Depending on early_stopping, the group can end as soon as its verdict is settled
+	const DroSimCore::ESimGroupVerdict Verdict = DroSimCore::EvaluateGroup(*Config, CurrentGroupSim, SuccessfulSim);
+	if (Verdict != DroSimCore::ESimGroupVerdict::Undecided) // End of current group
+	{
+		DroSimCore::FSimGroupOutcome Outcome;
+		Outcome.RunSims = CurrentGroupSim;
+		Outcome.SuccessfulSims = SuccessfulSim;
+		Outcome.SummedTimesToFind = SummedTimesToFind;
+		for (const DroSimCore::FSimOutcome& SimOutcome : GroupOutcomes)
+			if (SimOutcome.Found) Outcome.SummedConsumptions += SimOutcome.Consumption;
+		Outcome.IsSuccessful = Verdict == DroSimCore::ESimGroupVerdict::Success;
+		Outcome.FirstSimulationID = Config->CommonRandomNumbers ? 0 : GroupFirstSimID;
+		Outcome.Outcomes = GroupOutcomes;
+		if (GroupCache.IsOpen()) GroupCache.Add(*Config, Search->GetGroupParams(), SweepSeed, GroupFirstSimID, Outcome);
+		EndGroup(Outcome);
 	}
-	else
+
+	// Groups a previous sweep already ran are not simulated again
+	while (CurrentGroupSim == 0 && !Search->IsFinished() && ApplyCachedGroup()) {}
+	if (Search->IsFinished())
 	{
-		if (!IsCurveFound && IsGroupSuccessful)
-		{
-			// Found the first valid configuration
-			SlowConfigs.Add({
-				GroupSpeed,
-				(float)GroupNumDrones,
-				(float)GroupBatteryCount,
-				DRONEWEIGHT(GroupBatteryCount)});
-			IsCurveFound = true;
-			UE_LOG(LogTemp,Warning,TEXT("Curve found"));
-		}
-		if (GroupSpeed + SpeedIncrement <= MaxSpeed)
-			GroupSpeed += SpeedIncrement;
-		else if (IsCurveFound)
-		{
-			// Found the maximum speed drones need to go at
-			FastConfig.push_back(GroupSpeed);
-			FastConfig.push_back(GroupBatteryCount);
-			FastConfig.push_back(DRONEWEIGHT(GroupBatteryCount));
-			IsMaxFound = true;
-			UE_LOG(LogTemp,Warning,TEXT("Max speed found"));
-			GroupNumDrones += DroneIncrement;
-			GroupSpeed -= SpeedIncrement;
-		}
-		else
-		{
-			GroupNumDrones += DroneIncrement;
-			GroupSpeed = MinSpeed;
-		}
+		EndSweep();
+		return;
 	}
-	
-	// Calculate the maximum autonomy of the battery in minutes
-	MaxTimePerSim = CalculateMaximumAutonomy();
-	
-	UE_LOG(LogTemp, Warning, TEXT("----------------------------"));
-	PrintSimConfigRecap();
+
+	if (CurrentGroupSim == 0) GroupFirstSimID = SimID;
+	CurrentGroupSim++;
+	InitSimulation();
 }
 
 
 /**
- * Calculates the autonomy a drone can have with the highest battery capacity.
- *
- * @returns Maximum autonomy of the drone.
+ * Copies the parameters of the group the search runs next, which the drones and the coverage map read.
  */
-float AManager::CalculateMaximumAutonomy() const
+void AManager::RefreshGroupParams()
 {
-	return 60 * 60 * BatteryCapacity * MaxBatteryCount / (pow(GroupSpeed,2) * DRONEWEIGHT(MaxBatteryCount)/2.0);
+	const DroSimCore::FSimGroupParams Params = Search->GetGroupParams();
+	GroupSpeed = Params.Speed;
+	GroupNumDrones = Params.NumDrones;
+	GroupBatteryCount = Params.BatteryCount;
+	MaxTimePerSim = Params.MaxTimePerSim;
 }
 
 
 /**
- * Calculates the minimum battery capacity a drone has to have to be successful with the current settings.
+ * Reports the outcome of the current group to the search and moves on to the group it picks next.
+ *
+ * Every group takes up sim_group_size simulation IDs, however many of its simulations ran, as in
+ * DroSimCore::FSimSweep::Run: the same group gets the same IDs, and so the same random streams and records, in
+ * both frontends.
+ *
+ * @param Outcome Verdict, successes and times to find of the current group.
  */
-void AManager::CalculateMinBatteryCountForGroup()
+void AManager::EndGroup(const DroSimCore::FSimGroupOutcome& Outcome)
 {
-	for (int i = 0; i <= MaxBatteryCount; i++)
+	SimID = GroupFirstSimID + SimGroupSize;
+	SimulationCount += Outcome.RunSims;
+	Search->ReportGroup(Outcome);
+	RefreshGroupParams();
+	SummedTimesToFind = 0;
+	SuccessfulSim = 0;
+	CurrentGroupSim = 0;
+	GroupOutcomes.clear();
+	GroupID++;
+
+	if (!CheckpointPath.empty() && FPlatformTime::Seconds() >= NextCheckpointTime)
 	{
-		CurrentConsumption = SummedTimesToFind/SuccessfulSim/60.0/60.0 * pow(GroupSpeed,2) * DRONEWEIGHT(i)/2.0;
-		if (CurrentConsumption <= BatteryCapacity * i)
-        	{
-        		GroupBatteryCount = i;
-        		return;
-        	}
+		SaveCheckpoint();
+		NextCheckpointTime = FPlatformTime::Seconds() + Config->CheckpointInterval;
 	}
-	GroupBatteryCount = MaxBatteryCount;
-	ThrowUnexpectedWarning(TEXT("Selected config requires more batteries than allowed !"));
 }
 
 
 /**
- * Prints a warning with the mention "UNEXPECTED".
+ * Ends the current group with the outcome the group cache holds for it, if any.
+ *
+ * The group is recorded and takes up simulation IDs as if it had been simulated.
+ *
+ * @returns False if the group has to be simulated.
  */
-void AManager::ThrowUnexpectedWarning(const wchar_t* Text)
+bool AManager::ApplyCachedGroup()
 {
-	UE_LOG(LogTemp,Warning,TEXT("UNEXPECTED : %s"), Text);
+	GroupFirstSimID = SimID;
+	DroSimCore::FSimGroupOutcome Outcome;
+	if (!GroupCache.IsOpen() || !GroupCache.Find(*Config, Search->GetGroupParams(), SweepSeed, SimID, Outcome)) return false;
+
+	UE_LOG(LogTemp,Warning,TEXT("Group read from the cache : %d/%d successful simulations"), Outcome.SuccessfulSims, Outcome.RunSims);
+	if (RecordWriter.IsOpen())
+		for (int i = 0; i < Outcome.RunSims; i++)
+		{
+			const DroSimCore::FSimOutcome& SimOutcome = Outcome.Outcomes[i];
+			RecordWriter.Add(DroSimCore::MakeSimRecord(*Config, Outcome.FirstSimulationID + i, GroupID, GroupSpeed, GroupNumDrones,
+				SweepSeed, SimOutcome.Found, SimOutcome.FlightTime, SimOutcome.Consumption));
+		}
+	EndGroup(Outcome);
+	return true;
 }
 
 
 /**
  * Performs the initialization for a new simulation.
  *
- * It spawns an Objective and Drones and draws visuals.
+ * It places Objectives and Drones, taken from the pools when possible, and draws visuals. The core backend
+ * creates a core simulation instead, which places them as plain data.
  */
 void AManager::InitSimulation()
 {
-	// Objective
-	ObjectiveSpawnPoint = FVector(
-		FMath::RandRange(EnvSize.X*ObjectiveMinDistanceRatio,EnvSize.X),
-		FMath::RandRange(0.,EnvSize.Y),
-		GetActorLocation().Z);
-	CurrentSimulatedObjective = GetWorld()->SpawnActor<AObjective>(AObjective::StaticClass(), ObjectiveSpawnPoint, GetActorRotation());
+	DROSIM_SCOPE(InitSimulation);
+	// Random streams of this simulation, same keys as the headless sweep
+	StreamSimulationID = Config->CommonRandomNumbers ? CurrentGroupSim - 1 : SimID;
+	SimulationRandom = DroSimCore::FSimRandom::ForStream(SweepSeed, StreamSimulationID);
+
+	if (bUsesCoreBackend)
+	{
+		// Drone state lives in the arrays of the simulation's drone batch, the strategies only run on arrivals
+		CurrentZones = &DroSimCore::FSimZoneCache::Shared().Get(*Config, GroupNumDrones);
+		CoreSimulation = std::make_unique<DroSimCore::FSimulation>(*Config, Search->GetGroupParams(), SweepSeed, StreamSimulationID);
+		if (bIsRenderEnabled) DrawEnvironment();
+		SimID++;
+		return;
+	}
+
+	// Objectives, drawn one after the other
+	for (int i = 0; i < Config->ObjectiveCount; i++)
+	{
+		const FVector SpawnPoint = FVector(
+			SimulationRandom.RandRange(EnvSize.X*ObjectiveMinDistanceRatio,EnvSize.X),
+			SimulationRandom.RandRange(0.,EnvSize.Y),
+			GetActorLocation().Z);
+		CurrentSimulatedObjectives.Add(AcquireObjective(SpawnPoint));
+	}
+	ObjectiveFoundTimes.assign(Config->ObjectiveCount, -1);
+	IsObjectiveFound.assign(Config->ObjectiveCount, 0);
+	NumFoundObjectives = 0;
+	ObjectiveStarts.resize(Config->ObjectiveCount);
+	ObjectiveEnds.resize(Config->ObjectiveCount);
+	if (Config->ObjectiveCount > 1) ObjectiveGrid.Reset(*Config);
 
 	// Drones
 	switch (StrategyID)
@@ -296,10 +570,17 @@ void AManager::InitSimulation()
 	default: break;
 	}
 
-	// Research environment limits visuals
-	FVector BoxCenter = FVector(EnvSize.X/2,EnvSize.Y/2,0);
-	FVector BoxExtent = FVector(EnvSize.X/2,EnvSize.Y/2,200);
-	DrawDebugBox(GetWorld(), BoxCenter, BoxExtent, FQuat::Identity, FColor::Green, true, -1, 0, LinesThickness);
+	// Drones carry the batteries of the group, and their weight
+	NumActiveDrones = CurrentSimulatedDrones.Num();
+	if (Config->EnergyModel)
+	{
+		DroneEnergies.Init(Config->BatteryEnergy(GroupBatteryCount), NumActiveDrones);
+		DroneHoverStepEnergy = Config->HoverPower * Config->DroneWeight(GroupBatteryCount) * TickInterval;
+		DroneTurnEnergyPerRadian = Config->TurnEnergy * Config->DroneWeight(GroupBatteryCount);
+	}
+
+	ResetCoverage();
+	if (bIsRenderEnabled) DrawEnvironment();
 
 	SimID++;
 }
@@ -312,87 +593,91 @@ void AManager::InitSimulation()
  */
 void AManager::SpawnDrones(const TSubclassOf<ADrone> DroneStrategy)
 {
-	TArray<std::vector<FVector2D>> Zones = AssignZones();
+	DROSIM_SCOPE(SpawnDrones);
+	{
+		DROSIM_SCOPE(AssignZones);
+		CurrentZones = &DroSimCore::FSimZoneCache::Shared().Get(*Config, GroupNumDrones);
+	}
 	for (int i = 0; i < GroupNumDrones; i++)
 	{
-		ADrone* d = GetWorld()->SpawnActor<ADrone>(DroneStrategy, FVector(0,200*(i+1),DronesGroundOffset), GetActorRotation());
-		d->ID = i + 1; // A unique ID
-		d->Manager = this; // A reference to the manager
-		d->AssignedZone = Zones[i];
+		ADrone* d = AcquireDrone(DroneStrategy, FVector(0,200*(i+1),DronesGroundOffset));
+		// The lowest corner of a zone is made of the X of its bottom right point and the Y of its top left point
+		const DroSimCore::FSimZone& Zone = (*CurrentZones)[i];
+		const FBox2D ZoneBox(FVector2D(Zone.BottomRight.X, Zone.TopLeft.Y), FVector2D(Zone.TopLeft.X, Zone.BottomRight.Y));
+		// A unique ID, a reference to the manager, the zone to search and a random stream
+		d->ResetForSimulation(i + 1, this, ZoneBox, DroSimCore::FSimRandom::ForStream(SweepSeed, StreamSimulationID, i + 1));
 		CurrentSimulatedDrones.Add(d);
 	}
 }
 
 
 /**
- * Divides the environment in sub-zones and assigns one zone per drone.
+ * Takes an idle drone of the given class from the pool, or spawns one if there is none left.
  *
- * A zone is a vector of two FVector2D representing the top left and bottom right points.
+ * @param DroneStrategy The derived class of Drone wanted.
+ * @param Location Where the drone starts the simulation.
  */
-TArray<std::vector<FVector2D>> AManager::AssignZones()
+ADrone* AManager::AcquireDrone(const TSubclassOf<ADrone> DroneStrategy, const FVector& Location)
 {
-	int FilledLines = floor((float)GroupNumDrones/(float)ColMax);
-	int TotalLines = ceil((float)GroupNumDrones/(float)ColMax);
-	int ZonesLastLine = GroupNumDrones - FilledLines * ColMax;
-	
-	std::vector<std::vector<std::vector<FVector2D>>> Zones;
-	
-	// Filled lines
-	for (int line = 0; line < FilledLines; line++)
+	TArray<ADrone*>& Pool = DronePool.FindOrAdd(DroneStrategy.Get());
+	if (Pool.Num() == 0)
 	{
-		std::vector<std::vector<FVector2D>> Line;
-		for (int zone = 0; zone < ColMax; zone++)
-		{
-			std::vector<FVector2D> Zone;
-        	
-			// Top left point
-			Zone.push_back(FVector2D(
-				EnvSize.X - (EnvSize.X / TotalLines) * line,
-				(EnvSize.Y / ColMax) * zone));
-
-			// Bottom right point
-			Zone.push_back(FVector2D(
-				EnvSize.X - (EnvSize.X / TotalLines) * (line + 1),
-				(EnvSize.Y / ColMax) * (zone + 1)));
-
-			Line.push_back(Zone);
-		}
-		Zones.push_back(Line);
+		const FTransform SpawnTransform(GetActorRotation(), Location);
+		ADrone* d = GetWorld()->SpawnActorDeferred<ADrone>(DroneStrategy, SpawnTransform);
+		d->ApplyConfig(*Config);
+		d->FinishSpawning(SpawnTransform);
+		if (!bIsRenderEnabled) d->SetActorHiddenInGame(true);
+		return d;
 	}
 
-	// Last line if excess zones
-	if (ZonesLastLine != 0)
+	ADrone* d = Pool.Pop(false);
+	d->SetActorLocationAndRotation(Location, GetActorRotation());
+	d->SetPooledActive(true);
+	if (!bIsRenderEnabled) d->SetActorHiddenInGame(true);
+	return d;
+}
+
+
+/**
+ * Hides a drone and gives it back to the pool.
+ */
+void AManager::ReleaseDrone(ADrone* Drone)
+{
+	Drone->SetPooledActive(false);
+	DronePool.FindOrAdd(Drone->GetClass()).Add(Drone);
+}
+
+
+/**
+ * Takes the idle objective from the pool, or spawns one if there is none.
+ *
+ * @param Location Where the objective starts the simulation.
+ */
+AObjective* AManager::AcquireObjective(const FVector& Location)
+{
+	if (ObjectivePool.Num() == 0)
 	{
-		std::vector<std::vector<FVector2D>> Line;
-		for (int zone = 0; zone < ZonesLastLine; zone++)
-		{
-			std::vector<FVector2D> Zone;
-			
-			// Top left point
-			Zone.push_back(FVector2D(
-				EnvSize.X - (EnvSize.X / TotalLines) * FilledLines,
-				(EnvSize.Y / ZonesLastLine) * zone));
-
-			// Bottom right point
-			Zone.push_back(FVector2D(
-				0,
-				(EnvSize.Y / ZonesLastLine) * (zone + 1)));
-
-			Line.push_back(Zone);
-		}
-		Zones.push_back(Line);
+		const FTransform SpawnTransform(GetActorRotation(), Location);
+		AObjective* Objective = GetWorld()->SpawnActorDeferred<AObjective>(AObjective::StaticClass(), SpawnTransform);
+		Objective->ApplyConfig(*Config);
+		Objective->FinishSpawning(SpawnTransform);
+		return Objective;
 	}
 
-	TArray<std::vector<FVector2D>> ZonesArray;
+	AObjective* Objective = ObjectivePool.Pop(false);
+	Objective->ResetForSimulation(Location);
+	Objective->SetPooledActive(true);
+	return Objective;
+}
 
-	for (const auto& line : Zones)
-		for (const std::vector<FVector2D>& zone : line)
-		{
-			DrawDebugBoxFromDiagonalPoints(zone[0],zone[1],FColor::Red,LinesThickness);
-			ZonesArray.Add(zone);
-		}
 
-	return ZonesArray;
+/**
+ * Hides an objective and gives it back to the pool.
+ */
+void AManager::ReleaseObjective(AObjective* Objective)
+{
+	Objective->SetPooledActive(false);
+	ObjectivePool.Add(Objective);
 }
 
 
@@ -401,11 +686,11 @@ TArray<std::vector<FVector2D>> AManager::AssignZones()
  */
 bool AManager::DroneDestroyedEvent()
 {
-	const int RdID = FMath::RandRange(1,GroupNumDrones);
+	const int RdID = SimulationRandom.RandRange(1,GroupNumDrones);
 	for (ADrone* d : TArray(CurrentSimulatedDrones))
 		if (d->ID == RdID)
 		{
-			d->Destroy();
+			ReleaseDrone(d);
 			CurrentSimulatedDrones.Remove(d);
 			UE_LOG(LogTemp, Warning, TEXT("Lost communication with drone %d"), RdID);
 			return true;
@@ -416,7 +701,7 @@ bool AManager::DroneDestroyedEvent()
 
 
 /**
- * Thrown by any Drone whenever it finds the Objective.
+ * Counts the current simulation as successful, completed at CurrentSimulatedTime. It ends after the current substep.
  */
 void AManager::ObjectiveFound()
 {
@@ -425,48 +710,166 @@ void AManager::ObjectiveFound()
 	SuccessfulSim++;
 	SummedTimesToFind += CurrentSimulatedTime;
 	UE_LOG(LogTemp,Warning,TEXT("Found in %d min"),(int)(CurrentSimulatedTime/60));
-	HandleSimulationEnd();
 }
 
 
 /**
  * Resets the environment to its initial state.
  *
- * This function destroys every Drones and Objective currently playing.
+ * This function gives every Drones and Objective currently playing back to the pools.
  *
  * If the stopping condition is met, results are produced and the simulation comes to an end.
  */
 void AManager::HandleSimulationEnd()
 {
-	// Destroy all drones
-	TArray<ADrone*> Copy = CurrentSimulatedDrones;
-	for (ADrone* d : Copy) if (d) d->Destroy();
+	DROSIM_SCOPE(HandleSimulationEnd);
+	if (!SimulationHasEnded)
+	{
+		UE_LOG(LogTemp,Warning,TEXT("Coverage : %.1f%%"), GetCoverage() * 100);
+		DroSimCore::FSimOutcome Outcome;
+		if (CoreSimulation) Outcome = CoreSimulation->GetOutcome();
+		else
+		{
+			// Ended at the completion time if found, when hopeless or depleted, or once the maximum time is passed
+			const bool IsEarly = CurrentSimulatedTime < MaxTimePerSim;
+			Outcome.Found = ReportedSimID == SimID;
+			Outcome.TimeToFind = Outcome.Found ? CurrentSimulatedTime : 0;
+			Outcome.EndedDepleted = !Outcome.Found && IsEarly && Config->EnergyModel && NumActiveDrones == 0;
+			Outcome.EndedHopeless = !Outcome.Found && IsEarly && !Outcome.EndedDepleted;
+			Outcome.FlightTime = FMath::Min(CurrentSimulatedTime, MaxTimePerSim);
+
+			// Hungriest drone, as DroSimCore::FSimulation measures it
+			if (!Config->EnergyModel) Outcome.Consumption = (float)Config->FlightConsumption(GroupSpeed, GroupBatteryCount, Outcome.FlightTime);
+			else
+			{
+				double MaxEnergy = 0;
+				for (const double Energy : DroneEnergies) MaxEnergy = FMath::Max(MaxEnergy, Config->BatteryEnergy(GroupBatteryCount) - Energy);
+				Outcome.Consumption = (float)(MaxEnergy / 60.0 / 60.0);
+			}
+		}
+		RecordSimulation(Outcome);
+		GroupOutcomes.push_back(Outcome);
+		INC_DWORD_STAT(STAT_DroSim_SimsCompleted);
+		CSV_CUSTOM_STAT(DroSim, SimsCompleted, 1, ECsvCustomStatOp::Accumulate);
+		ThroughputWindowSims++;
+	}
+
+	// Release all drones
+	for (ADrone* d : CurrentSimulatedDrones) if (d) ReleaseDrone(d);
 	CurrentSimulatedDrones.Empty();
 
-	// Destroy objective
-	CurrentSimulatedObjective->Destroy();
+	// Release objectives
+	for (AObjective* o : CurrentSimulatedObjectives) ReleaseObjective(o);
+	CurrentSimulatedObjectives.Reset();
+	CoreSimulation.reset();
 
-	// Clear debug shapes
-	FlushPersistentDebugLines(GetWorld());
+	// Clear visuals, the environment lines stay until the zones change
+	VisionLines->Flush();
 
 	// Reset time
 	CurrentSimulatedTime = 0;
 
 	// Set up new simulations or print results
-	if (SimulationHasEnded) return;
-	if (GroupNumDrones < MaxNumDrones) ManageNewSimulation();
-	else
+	if (!SimulationHasEnded) ManageNewSimulation();
+}
+
+
+/**
+ * Prints the results once the search is finished, and writes them to results.txt, as DroSimCli does.
+ */
+void AManager::EndSweep()
+{
+	UE_LOG(LogTemp, Warning, TEXT("----------------------------"));
+	UE_LOG(LogTemp, Warning, TEXT("End of simulations"));
+	for (const std::string& Line : DroSimCore::FormatResults(Search->GetResults()))
+		UE_LOG(LogTemp, Warning, TEXT("%hs"), Line.c_str());
+	SimulationHasEnded = true;
+	EnvironmentLines->Flush();
+	DroneMeshes->ClearInstances();
+	DrawnZones = nullptr;
+
+	// The file is created if it does not exist yet
+	const FString ResultsFile = FPaths::ConvertRelativePathToFull(FPaths::ProjectConfigDir() / TEXT("../results.txt"));
+	std::string Error;
+	if (!DroSimCore::WriteResultsToFile(TCHAR_TO_UTF8(*ResultsFile), Search->GetResults(), Error))
+		UE_LOG(LogTemp, Warning, TEXT("%hs"), Error.c_str());
+	RecordWriter.Close();
+}
+
+
+/**
+ * Queues the record of the simulation that just ended, the file is written in the background.
+ */
+void AManager::RecordSimulation(const DroSimCore::FSimOutcome& Outcome)
+{
+	if (!RecordWriter.IsOpen()) return;
+	RecordWriter.Add(DroSimCore::MakeSimRecord(*Config, StreamSimulationID, GroupID, GroupSpeed, GroupNumDrones,
+		SweepSeed, Outcome.Found, Outcome.FlightTime, Outcome.Consumption));
+}
+
+
+/**
+ * Saves the state of the sweep to checkpoint_file, between two groups.
+ *
+ * Random streams are keyed by the seed and the simulation ID, so SimID, the first ID of the next group, is all there
+ * is to their position.
+ */
+void AManager::SaveCheckpoint()
+{
+	DroSimCore::FSimCheckpoint Checkpoint;
+	Checkpoint.Producer = DroSimCore::ESimCheckpointProducer::Engine;
+	Checkpoint.SearchMode = Config->SearchMode;
+	Checkpoint.ConfigHash = Config->IniHash;
+	Checkpoint.Seed = SweepSeed;
+	Checkpoint.NextSimulationID = SimID;
+	Checkpoint.GroupCount = GroupID;
+	Checkpoint.SimulationCount = SimulationCount;
+	Checkpoint.RecordsSize = RecordWriter.IsOpen() ? (int64)RecordWriter.Sync() : -1;
+	DroSimCore::FSimArchive Ar(Checkpoint.SearchState, false);
+	Search->Serialize(Ar);
+
+	std::string Error;
+	if (!Checkpoint.Save(CheckpointPath, Error))
+		UE_LOG(LogTemp, Warning, TEXT("Checkpoint not saved : %hs"), Error.c_str());
+}
+
+
+/**
+ * Continues the sweep of the last checkpoint, from the group following it.
+ *
+ * @param OutRecordsSize Size the records file had at the checkpoint, later records are dropped.
+ * The search state is read into a new search, and nothing of the sweep changes unless the whole checkpoint is valid.
+ *
+ * @returns False if there is no usable checkpoint, the sweep then starts over.
+ */
+bool AManager::LoadCheckpoint(int64& OutRecordsSize)
+{
+	DroSimCore::FSimCheckpoint Checkpoint;
+	std::string Error;
+	if (!Checkpoint.Load(CheckpointPath, Error) || !Checkpoint.Matches(DroSimCore::ESimCheckpointProducer::Engine, *Config, Error))
+	{
+		UE_LOG(LogTemp, Warning, TEXT("%hs, starting a new sweep"), Error.c_str());
+		return false;
+	}
+
+	std::unique_ptr<DroSimCore::FSimSearch> ResumedSearch = DroSimCore::FSimSearch::Make(*Config);
+	DroSimCore::FSimArchive Ar(Checkpoint.SearchState, true);
+	ResumedSearch->Serialize(Ar);
+	if (!Ar.IsAtEnd())
 	{
-		UE_LOG(LogTemp, Warning, TEXT("----------------------------"));
-		UE_LOG(LogTemp, Warning, TEXT("%d drones reached : End of simulations"), GroupNumDrones-1);
-		UE_LOG(LogTemp, Warning, TEXT("Fast configuration :"));
-		UE_LOG(LogTemp, Warning, TEXT("speed:%d,batteries:%d,(weight:%f)"), (int)FastConfig[0], (int)FastConfig[1], FastConfig[2]);
-		UE_LOG(LogTemp, Warning, TEXT("Slow configurations :"));
-		for (const auto& sc : SlowConfigs)
-			UE_LOG(LogTemp, Warning, TEXT("speed:%d,drones:%d,batteries:%d,(weight:%f)"), (int)sc[0], (int)sc[1], (int)sc[2], sc[3]);
-		SimulationHasEnded = true;
-		WriteResultsToFile();
+		UE_LOG(LogTemp, Warning, TEXT("The search state of the checkpoint is invalid, starting a new sweep"));
+		return false;
 	}
+
+	ResumedSearch->SetLogger([](const std::string& Text) { UE_LOG(LogTemp, Warning, TEXT("%hs"), Text.c_str()); });
+	Search = std::move(ResumedSearch);
+	SweepSeed = Checkpoint.Seed;
+	SimID = (int)Checkpoint.NextSimulationID;
+	GroupID = Checkpoint.GroupCount;
+	SimulationCount = Checkpoint.SimulationCount;
+	OutRecordsSize = Checkpoint.RecordsSize;
+	UE_LOG(LogTemp, Warning, TEXT("Resuming at group %d, %d simulations already run"), GroupID, SimulationCount);
+	return true;
 }
 
 
@@ -482,66 +885,166 @@ float AManager::GetGroupDroneSpeed()
 
 
 /**
- * Appends successful configs to a result file.
+ * Draws the research environment limits and the zone of every drone.
+ *
+ * The lines are kept from one simulation to the next and only drawn again when the drone count, and so the
+ * zones, change.
  */
-void AManager::WriteResultsToFile()
+void AManager::DrawEnvironment()
 {
-	FString ResultsFile = FPaths::ProjectConfigDir();
-	ResultsFile.Append(TEXT("../results.txt"));
-	
-	IPlatformFile& FileManager = FPlatformFileManager::Get().GetPlatformFile();
+	if (DrawnZones == CurrentZones) return;
+	DrawnZones = CurrentZones;
+
+	FrameLines.Reset();
+	AddBoxLines(FrameLines, FVector(0,0,-200), FVector(EnvSize.X,EnvSize.Y,200), FColor::Green, LinesThickness);
+	for (const DroSimCore::FSimZone& Zone : *CurrentZones)
+		AddBoxLines(FrameLines,
+			FVector(Zone.TopLeft.X,Zone.TopLeft.Y,10),
+			FVector(Zone.BottomRight.X,Zone.BottomRight.Y,10),
+			FColor::Red, LinesThickness);
+
+	EnvironmentLines->Flush();
+	EnvironmentLines->DrawLines(FrameLines);
+}
 
-	// Prepare configurations for writing to file
-	TArray<FString> ConfigsToWrite;
-	
-	ConfigsToWrite.Add(FString::Printf(
-		TEXT("speed:%f,batteries:%d,(weight:%f)"),
-		FastConfig[0], (int)FastConfig[1], FastConfig[2]));
-	
-	ConfigsToWrite.Add(FString::Printf(TEXT("---")));
-	
-	for (const auto& sc : SlowConfigs) {
-		FString FormattedString = FString::Printf(
-		TEXT("speed:%f,drones:%d,batteries:%d,(weight:%f)"),
-			sc[0], (int)sc[1], (int)sc[2], sc[3]);
-		ConfigsToWrite.Add(FormattedString);
-	}
-	
-	if (FileManager.FileExists(*ResultsFile))
+
+/**
+ * Moves the drone instances to the simulated drones, in a single batch.
+ *
+ * Instances are only added or removed when the drone count changes, from one group to the next.
+ */
+void AManager::DrawDrones()
+{
+	DroneTransforms.Reset();
+	if (CoreSimulation)
 	{
-		if (FFileHelper::SaveStringArrayToFile(ConfigsToWrite,*ResultsFile))
+		const DroSimCore::FSimDroneBatch& Drones = CoreSimulation->GetDroneBatch();
+		for (int i = 0; i < Drones.Num(); i++)
 		{
-			UE_LOG(LogTemp, Warning, TEXT("Successfully written \"%d\" strings to the text file"),ConfigsToWrite.Num());
+			const DroSimCore::FSimVec3 Position = Drones.GetPosition(i);
+			const DroSimCore::FSimVec3 Direction = Drones.GetDirection(i);
+			DroneTransforms.Emplace(FVector(Direction.X,Direction.Y,Direction.Z).Rotation(), FVector(Position.X,Position.Y,Position.Z));
 		}
-		else UE_LOG(LogTemp, Warning, TEXT("Failed to write to file."));
 	}
 	else
 	{
-		UE_LOG(LogTemp, Warning, TEXT("File not found."));
-		UE_LOG(LogTemp, Warning, TEXT("Expected location: %s"),*ResultsFile);
+		for (const ADrone* d : CurrentSimulatedDrones)
+			DroneTransforms.Emplace(d->GetMoveDirection().Rotation(), d->GetCalculatedPosition());
+	}
+
+	if (DroneMeshes->GetInstanceCount() != DroneTransforms.Num())
+	{
+		DroneMeshes->ClearInstances();
+		DroneMeshes->AddInstances(DroneTransforms, false);
+	}
+	else DroneMeshes->BatchUpdateInstancesTransforms(0, DroneTransforms, false, true, true);
+}
+
+
+/**
+ * Draws the vision circle of every drone, replacing the ones of the previous tick.
+ */
+void AManager::DrawVisionCircles()
+{
+	constexpr int Segments = 32;
+	FrameLines.Reset();
+	for (const ADrone* d : CurrentSimulatedDrones)
+	{
+		const FVector Center = d->GetCalculatedPosition();
+		for (int i = 0; i < Segments; i++)
+		{
+			const double Angle0 = 2 * PI * i / Segments;
+			const double Angle1 = 2 * PI * (i + 1) / Segments;
+			FrameLines.Emplace(
+				Center + VisionRadius * FVector(FMath::Sin(Angle0), FMath::Cos(Angle0), 0),
+				Center + VisionRadius * FVector(FMath::Sin(Angle1), FMath::Cos(Angle1), 0),
+				FColor::Yellow, 0, 10, 0);
+		}
 	}
+
+	VisionLines->Flush();
+	VisionLines->DrawLines(FrameLines);
+}
+
+
+/**
+ * Draws the objectives of a core backend simulation, which has no actors: a cross per objective, red until
+ * found then green.
+ */
+void AManager::DrawCoreSimulation()
+{
+	constexpr double CrossSize = 150;
+	auto AddCross = [this](const DroSimCore::FSimVec3& Position, const FColor& Color)
+	{
+		const FVector Center(Position.X, Position.Y, Position.Z);
+		FrameLines.Emplace(Center - FVector(CrossSize,0,0), Center + FVector(CrossSize,0,0), Color, 0, 10, 0);
+		FrameLines.Emplace(Center - FVector(0,CrossSize,0), Center + FVector(0,CrossSize,0), Color, 0, 10, 0);
+	};
+
+	FrameLines.Reset();
+	const std::vector<float>& FoundTimes = CoreSimulation->GetObjectiveFoundTimes();
+	for (size_t i = 0; i < FoundTimes.size(); i++)
+		AddCross(CoreSimulation->GetObjectives()[i].GetPosition(), FoundTimes[i] < 0 ? FColor::Red : FColor::Green);
+
+	VisionLines->Flush();
+	VisionLines->DrawLines(FrameLines);
 }
 
 
 /**
- * Draws a box based on two diagonal points instead of centre and extend.
+ * Adds the edges of an axis-aligned box, flat boxes only get their 4 horizontal edges.
  */
-void AManager::DrawDebugBoxFromDiagonalPoints(const FVector2D& TopLeft, const FVector2D& BottomRight, const FColor& Color, const int& Thickness)
+void AManager::AddBoxLines(TArray<FBatchedLine>& Lines, const FVector& Min, const FVector& Max, const FColor& Color, const float Thickness)
 {
-	FVector v1 = FVector(TopLeft.X,TopLeft.Y,10);
-	FVector v2 = FVector(BottomRight.X,BottomRight.Y,10);
-	FVector Center = (v1 + v2) / 2.0f;
-	FVector Extent = (v1 - v2) / 2.0f;
-	DrawDebugBox(GetWorld(), Center, Extent, FQuat::Identity, Color, true, -1, 0, Thickness);
+	const FVector Corners[2][2][2] = {
+		{{FVector(Min.X,Min.Y,Min.Z), FVector(Min.X,Min.Y,Max.Z)}, {FVector(Min.X,Max.Y,Min.Z), FVector(Min.X,Max.Y,Max.Z)}},
+		{{FVector(Max.X,Min.Y,Min.Z), FVector(Max.X,Min.Y,Max.Z)}, {FVector(Max.X,Max.Y,Min.Z), FVector(Max.X,Max.Y,Max.Z)}}};
+	const int NumLevels = Min.Z == Max.Z ? 1 : 2;
+
+	for (int z = 0; z < NumLevels; z++)
+	{
+		Lines.Emplace(Corners[0][0][z], Corners[1][0][z], Color, 0, Thickness, 0);
+		Lines.Emplace(Corners[1][0][z], Corners[1][1][z], Color, 0, Thickness, 0);
+		Lines.Emplace(Corners[1][1][z], Corners[0][1][z], Color, 0, Thickness, 0);
+		Lines.Emplace(Corners[0][1][z], Corners[0][0][z], Color, 0, Thickness, 0);
+	}
+	if (NumLevels == 2)
+		for (int x = 0; x < 2; x++)
+			for (int y = 0; y < 2; y++)
+				Lines.Emplace(Corners[x][y][0], Corners[x][y][1], Color, 0, Thickness, 0);
 }
 
 
 /**
- * Checks whether the given drone can see the objective from its current position.
+ * Finds the objectives the given drone saw while moving from one position to another over the current substep,
+ * each at the moment of its first contact.
+ *
+ * Drone and objectives are both tested along their paths over the substep, so that neither large substeps nor
+ * the objective's own movement skip over a contact. An objective already found earlier in the substep by another
+ * drone keeps the earliest of the two contacts. With several objectives, only the ones the grid holds around the
+ * segment are tested.
  */
-bool AManager::IsObjectiveNear(const FVector& DronePos)
+void AManager::DetectObjectives(const FVector& From, const FVector& To)
 {
-	return FVector::Dist(DronePos,CurrentSimulatedObjective->GetActorLocation()) <= VisionRadius;
+	DROSIM_SCOPE(DetectObjectives);
+	INC_DWORD_STAT(STAT_DroSim_DetectionChecks);
+	const DroSimCore::FSimVec3 Start(From.X,From.Y,From.Z);
+	const DroSimCore::FSimVec3 End(To.X,To.Y,To.Z);
+	const auto TestObjective = [&](const int i)
+	{
+		if (IsObjectiveFound[i] && ObjectiveFoundTimes[i] < SubstepStartTime) return;
+		double Alpha;
+		if (!DroSimCore::FindFirstContact(Start, End, ObjectiveStarts[i], ObjectiveEnds[i], VisionRadius, Alpha)) return;
+		const float ContactTime = (float)(SubstepStartTime + Alpha * TickInterval);
+		if (ContactTime > MaxTimePerSim) return;
+		if (IsObjectiveFound[i] && ObjectiveFoundTimes[i] <= ContactTime) return;
+		if (!IsObjectiveFound[i]) NumFoundObjectives++;
+		IsObjectiveFound[i] = 1;
+		ObjectiveFoundTimes[i] = ContactTime;
+	};
+
+	if (CurrentSimulatedObjectives.Num() == 1) TestObjective(0);
+	else ObjectiveGrid.ForEachNear(Start, End, VisionRadius, TestObjective);
 }
 
 
@@ -2,7 +2,8 @@
 
 AObjective::AObjective()
 {
-	PrimaryActorTick.bCanEverTick = true;
+	// The objective is stepped by the manager, which owns the simulation clock
+	PrimaryActorTick.bCanEverTick = false;
 
 	// Creation of a mesh component for the objective
 	StaticMesh = CreateDefaultSubobject<UStaticMeshComponent>(TEXT("StaticMesh"));
@@ -11,10 +12,7 @@ AObjective::AObjective()
 	static ConstructorHelpers::FObjectFinder<UStaticMesh> MeshAsset(TEXT("/Game/Meshes/Ship_Mesh"));
 	if (MeshAsset.Succeeded()) StaticMesh->SetStaticMesh(MeshAsset.Object);
 
-	// Loading config from .ini file
-	LoadConfig();
-
-	// Collision sphere for the objective to be seen by Drones
+	// Collision sphere for the objective to be seen by Drones, sized in ApplyConfig()
 	HitSphere = CreateDefaultSubobject<USphereComponent>(TEXT("HitSphere"));
 	HitSphere->InitSphereRadius(CollisionCheckRadius);
 	HitSphere->SetCollisionProfileName("OverlapAll");
@@ -23,28 +21,20 @@ AObjective::AObjective()
 
 
 /**
- * Loading configuration from .ini file
+ * Copies the values the objective needs from the shared configuration snapshot.
  *
- * Sets initial values to variables.
+ * Called by the manager between SpawnActorDeferred and FinishSpawning, before BeginPlay().
  */
-void AObjective::LoadConfig()
+void AObjective::ApplyConfig(const DroSimCore::FSimConfig& Config)
 {
-	FString ConfigFilePath = FPaths::ProjectContentDir() + TEXT("SimConfig.ini");
-	ConfigFilePath = FConfigCacheIni::NormalizeConfigIniPath(ConfigFilePath);
-
-	GConfig->LoadFile(ConfigFilePath);
-	
-    GConfig->GetInt(TEXT("sim/global"), TEXT("sim_speed"), SimulationSpeed, ConfigFilePath);
-    GConfig->GetFloat(TEXT("sim/global"), TEXT("step"), TickInterval, ConfigFilePath);
+	TickInterval = Config.Step;
 	
-	GConfig->GetBool(TEXT("sim/objective"), TEXT("is_moving"), IsMoving, ConfigFilePath);
-	if (IsMoving)
-	{
-		GConfig->GetFloat(TEXT("sim/global"), TEXT("environment_Y_length"), YLimit, ConfigFilePath);
-		GConfig->GetFloat(TEXT("sim/objective"), TEXT("speed"), MovementSpeed, ConfigFilePath);
-	}
-
-	GConfig->GetFloat(TEXT("sim/objective"), TEXT("collision_check_radius"), CollisionCheckRadius, ConfigFilePath);
+	IsMoving = Config.ObjectiveIsMoving;
+	YLimit = Config.EnvSize.Y;
+	MovementSpeed = Config.ObjectiveSpeed;
+
+	CollisionCheckRadius = Config.ObjectiveCollisionCheckRadius;
+	HitSphere->SetSphereRadius(CollisionCheckRadius);
 }
 
 
@@ -54,34 +44,53 @@ void AObjective::LoadConfig()
 void AObjective::BeginPlay()
 {
 	Super::BeginPlay();
-	
-	SetActorTickInterval(TickInterval);
 
-	SetActorRotation(MoveDirection.Rotation());
-	SetActorLocation(FVector(GetActorLocation().X,GetActorLocation().Y,100.0));
+	CalculatedPosition = FVector(GetActorLocation().X,GetActorLocation().Y,100.0);
+	SetActorLocationAndRotation(CalculatedPosition, MoveDirection.Rotation());
 }
 
 
 /**
- * Update function.
- *
- * This function is called every TickInterval seconds, as set in BeginPlay().
+ * Advances the objective by one substep of TickInterval simulated seconds.
  *
- * @param DeltaTime Time elapsed since last frame.
+ * The objective turns around instead of moving when it would leave the environment.
  */
-void AObjective::Tick(float DeltaTime)
+void AObjective::StepSimulation()
 {
-	Super::Tick(DeltaTime);
-
 	if (!IsMoving) return;
 	
-	FVector NextLocation = GetActorLocation() + MoveDirection * MovementSpeed * SimulationSpeed;
+	const FVector NextLocation = CalculatedPosition + MoveDirection * MovementSpeed * TickInterval;
 	
-	if (NextLocation.Y >= 0 && NextLocation.Y <= YLimit) SetActorLocation(NextLocation);
-	else
-	{
-		MoveDirection.Y = -MoveDirection.Y;
-		SetActorRotation(MoveDirection.Rotation());
-	}
+	if (NextLocation.Y >= 0 && NextLocation.Y <= YLimit) CalculatedPosition = NextLocation;
+	else MoveDirection.Y = -MoveDirection.Y;
+}
+
+
+/**
+ * Moves the actor to the simulated position, once per frame and only when rendering.
+ */
+void AObjective::SyncActor()
+{
+	SetActorLocationAndRotation(CalculatedPosition, MoveDirection.Rotation());
+}
+
+
+/**
+ * Puts a pooled objective back in its initial state at a new spawn point.
+ */
+void AObjective::ResetForSimulation(const FVector& SpawnPoint)
+{
+	MoveDirection = FVector(0,1.0f,0);
+	CalculatedPosition = FVector(SpawnPoint.X,SpawnPoint.Y,100.0);
+	SetActorLocationAndRotation(CalculatedPosition, MoveDirection.Rotation());
 }
 
+
+/**
+ * Shows or hides a pooled objective and enables or disables its collision accordingly.
+ */
+void AObjective::SetPooledActive(const bool bActive)
+{
+	SetActorHiddenInGame(!bActive);
+	SetActorEnableCollision(bActive);
+}
@@ -0,0 +1,151 @@
+#include "SimCore/SimBisectionSearch.h"
+
+#include <algorithm>
+#include <cmath>
+
+namespace DroSimCore
+{
+	FSimBisectionSearch::FSimBisectionSearch(const FSimConfig& InConfig)
+		: FSimSearch(InConfig)
+		, SpeedResolution(InConfig.SpeedResolution > 0 ? InConfig.SpeedResolution : InConfig.SpeedIncrement)
+		, GroupNumDrones(InConfig.MinNumDrones)
+	{
+		TopIndex = (int)std::floor((Config.MaxSpeed - Config.MinSpeed) / SpeedResolution + 1e-4f);
+		StartDroneCount();
+	}
+
+
+	/**
+	 * Parameters of the group of simulations to run next.
+	 */
+	FSimGroupParams FSimBisectionSearch::GetGroupParams() const
+	{
+		return MakeGroupParams(GetSpeed(ProbeIndex), GroupNumDrones);
+	}
+
+
+	/**
+	 * Saves or loads the state of the search between two groups.
+	 */
+	void FSimBisectionSearch::Serialize(FSimArchive& Ar)
+	{
+		FSimSearch::Serialize(Ar);
+		Ar << GroupNumDrones << ProbeIndex << FailIndex << SuccessIndex << IsWarmStarted << GallopStep << IsProbingFastConfig
+			<< SuccessBatteryCounts << PreviousThreshold;
+	}
+
+
+	/**
+	 * Picks the first speed to try for the current drone count.
+	 */
+	void FSimBisectionSearch::StartDroneCount()
+	{
+		FailIndex = -1;
+		SuccessIndex = -1;
+		GallopStep = 1;
+		SuccessBatteryCounts.clear();
+
+		// Warm start from the previous drone count, more drones should not need to go faster
+		IsWarmStarted = PreviousThreshold >= 0;
+		ProbeIndex = IsWarmStarted ? PreviousThreshold : 0;
+	}
+
+
+	/**
+	 * Records the threshold of the current drone count, if any, and moves on to the next count.
+	 */
+	void FSimBisectionSearch::EndDroneCount(const bool HasThreshold)
+	{
+		if (HasThreshold)
+		{
+			const int BatteryCount = SuccessBatteryCounts[SuccessIndex];
+			Results.SlowConfigs.push_back({
+				GetSpeed(SuccessIndex),
+				GroupNumDrones,
+				BatteryCount,
+				Config.DroneWeight(BatteryCount)});
+			PreviousThreshold = SuccessIndex;
+			Log(SimPrintf("Threshold for %d drone%s : %d m/s", GroupNumDrones, GroupNumDrones > 1 ? "s" : "", (int)GetSpeed(SuccessIndex)));
+
+			if (!Results.HasFastConfig && SuccessIndex < TopIndex)
+			{
+				// Like the linear search, the first drone count of the curve also tries max_speed
+				IsProbingFastConfig = true;
+				ProbeIndex = TopIndex;
+				return;
+			}
+			if (!Results.HasFastConfig) SetFastConfig(BatteryCount);
+		}
+
+		GroupNumDrones += Config.DroneIncrement;
+		if (!IsFinished()) StartDroneCount();
+	}
+
+
+	/**
+	 * Saves max_speed as the fastest configuration, found on the first drone count of the curve.
+	 */
+	void FSimBisectionSearch::SetFastConfig(const int BatteryCount)
+	{
+		Results.HasFastConfig = true;
+		Results.FastConfig = {GetSpeed(TopIndex), 0, BatteryCount, Config.DroneWeight(BatteryCount)};
+		Log("Max speed found");
+	}
+
+
+	/**
+	 * Narrows the bracket of the current drone count with the outcome of the group and picks the next speed.
+	 */
+	void FSimBisectionSearch::ReportGroup(const FSimGroupOutcome& GroupOutcome)
+	{
+		const bool IsSuccessful = GroupOutcome.IsSuccessful;
+		const int BatteryCount = LogGroupOutcome(IsSuccessful, GroupOutcome);
+
+		if (IsProbingFastConfig)
+		{
+			// A failure at max_speed keeps the battery count of the threshold, as the linear search does
+			IsProbingFastConfig = false;
+			SetFastConfig(IsSuccessful ? BatteryCount : SuccessBatteryCounts[SuccessIndex]);
+			EndDroneCount(false);
+			Log("----------------------------");
+			PrintSimConfigRecap();
+			return;
+		}
+
+		if (IsSuccessful)
+		{
+			SuccessIndex = SuccessIndex < 0 ? ProbeIndex : std::min(SuccessIndex, ProbeIndex);
+			SuccessBatteryCounts[ProbeIndex] = BatteryCount;
+		}
+		else FailIndex = std::max(FailIndex, ProbeIndex);
+
+		// Without a warm start, going below min_speed counts as a known failure
+		const bool HasLowerBound = FailIndex >= 0 || !IsWarmStarted;
+
+		if (SuccessIndex < 0)
+		{
+			// Nothing found yet: give up at the top of the grid, otherwise gallop upwards
+			if (FailIndex >= TopIndex) EndDroneCount(false);
+			else
+			{
+				ProbeIndex = std::min(TopIndex, FailIndex + GallopStep);
+				GallopStep *= 2;
+			}
+		}
+		else if (SuccessIndex - FailIndex <= 1 && HasLowerBound) EndDroneCount(true);
+		else if (!HasLowerBound)
+		{
+			// Gallop downwards until a group fails
+			if (SuccessIndex == 0) EndDroneCount(true);
+			else
+			{
+				ProbeIndex = std::max(0, SuccessIndex - GallopStep);
+				GallopStep *= 2;
+			}
+		}
+		else ProbeIndex = (FailIndex + SuccessIndex) / 2;
+
+		Log("----------------------------");
+		PrintSimConfigRecap();
+	}
+}
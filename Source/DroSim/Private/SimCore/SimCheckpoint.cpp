@@ -0,0 +1,180 @@
+#include "SimCore/SimCheckpoint.h"
+
+#include <chrono>
+#include <cstdio>
+#include <cstring>
+#include <fstream>
+#include <iterator>
+
+namespace DroSimCore
+{
+	namespace SimCheckpoint
+	{
+		/*
+		 * Checkpoint file layout: "DSCK" u32 version, u64 payload size, payload, u64 FNV-1a hash of the payload.
+		 * The payload is FSimCheckpoint::Serialize.
+		 */
+		constexpr char FileMagic[4] = {'D', 'S', 'C', 'K'};
+		constexpr uint32_t Version = 2;
+		constexpr size_t HeaderSize = 4 + 4 + 8;
+	}
+
+
+	/**
+	 * 64-bit FNV-1a hash.
+	 */
+	uint64_t HashBytes(const uint8_t* Data, const size_t Size)
+	{
+		uint64_t Hash = 14695981039346656037ull;
+		for (size_t i = 0; i < Size; i++)
+		{
+			Hash ^= Data[i];
+			Hash *= 1099511628211ull;
+		}
+		return Hash;
+	}
+
+
+	/**
+	 * Writes a file next to Path, then renames it over Path: readers, and a crash while writing, only ever
+	 * see the previous content or the new one in whole.
+	 */
+	bool WriteFileAtomically(const std::string& Path, const std::vector<uint8_t>& Bytes, std::string& OutError)
+	{
+		// Unique per writer, several processes may write the same path
+		const std::string TempPath = SimPrintf("%s.%llx.tmp", Path.c_str(),
+			(unsigned long long)std::chrono::steady_clock::now().time_since_epoch().count());
+		{
+			std::ofstream File(TempPath, std::ios::binary | std::ios::trunc);
+			File.write((const char*)Bytes.data(), (std::streamsize)Bytes.size());
+			File.flush();
+			if (!File)
+			{
+				OutError = "Cannot write " + TempPath;
+				std::remove(TempPath.c_str());
+				return false;
+			}
+		}
+
+		// Renaming over an existing file fails on Windows
+		if (std::rename(TempPath.c_str(), Path.c_str()) != 0
+			&& (std::remove(Path.c_str()) != 0 || std::rename(TempPath.c_str(), Path.c_str()) != 0))
+		{
+			OutError = "Cannot replace " + Path;
+			std::remove(TempPath.c_str());
+			return false;
+		}
+		return true;
+	}
+
+
+	void FSimArchive::Serialize(void* Data, const size_t Size)
+	{
+		if (!bIsLoading)
+		{
+			const uint8_t* Source = (const uint8_t*)Data;
+			Bytes.insert(Bytes.end(), Source, Source + Size);
+			return;
+		}
+		if (!bIsOk || Offset + Size > Bytes.size())
+		{
+			bIsOk = false;
+			return;
+		}
+		std::memcpy(Data, &Bytes[Offset], Size);
+		Offset += Size;
+	}
+
+
+	void FSimCheckpoint::Serialize(FSimArchive& Ar)
+	{
+		Ar << Producer << SearchMode << ConfigHash << Seed << NextSimulationID << GroupCount << SimulationCount << RecordsSize << SearchState;
+	}
+
+
+	/**
+	 * Whether the checkpoint can be resumed by the given frontend with the given configuration: search states
+	 * are only read back by the frontend and the search that wrote them.
+	 */
+	bool FSimCheckpoint::Matches(const ESimCheckpointProducer InProducer, const FSimConfig& Config, std::string& OutError) const
+	{
+		if (Producer != InProducer)
+		{
+			OutError = SimPrintf("The checkpoint was saved by %s", Producer == ESimCheckpointProducer::Engine ? "the engine" : "DroSimCli");
+			return false;
+		}
+		if (SearchMode != Config.SearchMode)
+		{
+			OutError = "The checkpoint was saved with another search_mode";
+			return false;
+		}
+		if (ConfigHash != Config.IniHash)
+		{
+			OutError = "The checkpoint was saved with another configuration";
+			return false;
+		}
+		return true;
+	}
+
+
+	/**
+	 * Saves the checkpoint atomically: a crash while saving leaves the previous checkpoint whole.
+	 */
+	bool FSimCheckpoint::Save(const std::string& Path, std::string& OutError) const
+	{
+		std::vector<uint8_t> Payload;
+		FSimArchive PayloadAr(Payload, false);
+		FSimCheckpoint(*this).Serialize(PayloadAr);
+
+		std::vector<uint8_t> Data(SimCheckpoint::FileMagic, SimCheckpoint::FileMagic + 4);
+		FSimArchive Ar(Data, false);
+		uint32_t Version = SimCheckpoint::Version;
+		uint64_t PayloadSize = Payload.size();
+		uint64_t PayloadHash = HashBytes(Payload.data(), Payload.size());
+		Ar << Version << PayloadSize;
+		Data.insert(Data.end(), Payload.begin(), Payload.end());
+		Ar << PayloadHash;
+		return WriteFileAtomically(Path, Data, OutError);
+	}
+
+
+	/**
+	 * Reads a checkpoint written by Save.
+	 *
+	 * @returns False if the file cannot be read, or is not a complete checkpoint of this version.
+	 */
+	bool FSimCheckpoint::Load(const std::string& Path, std::string& OutError)
+	{
+		std::ifstream File(Path, std::ios::binary);
+		if (!File)
+		{
+			OutError = "Cannot open " + Path;
+			return false;
+		}
+		const std::vector<uint8_t> Data((std::istreambuf_iterator<char>(File)), std::istreambuf_iterator<char>());
+
+		OutError = Path + " is not a complete checkpoint";
+		uint32_t Version;
+		uint64_t PayloadSize;
+		uint64_t PayloadHash;
+		if (Data.size() < SimCheckpoint::HeaderSize + 8 || std::memcmp(Data.data(), SimCheckpoint::FileMagic, 4) != 0) return false;
+		std::memcpy(&Version, &Data[4], 4);
+		std::memcpy(&PayloadSize, &Data[8], 8);
+		if (Version != SimCheckpoint::Version)
+		{
+			OutError = Path + " is a checkpoint of another version";
+			return false;
+		}
+		if (PayloadSize != Data.size() - SimCheckpoint::HeaderSize - 8) return false;
+		std::memcpy(&PayloadHash, &Data[SimCheckpoint::HeaderSize + PayloadSize], 8);
+		if (PayloadHash != HashBytes(&Data[SimCheckpoint::HeaderSize], PayloadSize)) return false;
+
+		std::vector<uint8_t> Payload(Data.begin() + SimCheckpoint::HeaderSize, Data.begin() + SimCheckpoint::HeaderSize + PayloadSize);
+		FSimArchive Ar(Payload, true);
+		Serialize(Ar);
+		if (!Ar.IsAtEnd()) return false;
+
+		OutError.clear();
+		return true;
+	}
+}
@@ -0,0 +1,421 @@
+#include "SimCore/SimConfig.h"
+
+#include <algorithm>
+#include <cctype>
+#include <cerrno>
+#include <cstdlib>
+#include <fstream>
+#include <limits>
+#include <sstream>
+
+namespace DroSimCore
+{
+	namespace SimIni
+	{
+		std::string Trim(const std::string& Text)
+		{
+			size_t Start = 0;
+			size_t End = Text.size();
+			while (Start < End && std::isspace((unsigned char)Text[Start])) Start++;
+			while (End > Start && std::isspace((unsigned char)Text[End - 1])) End--;
+			return Text.substr(Start, End - Start);
+		}
+
+		std::string ToLower(std::string Text)
+		{
+			std::transform(Text.begin(), Text.end(), Text.begin(), [](const unsigned char C) { return (char)std::tolower(C); });
+			return Text;
+		}
+	}
+
+
+	/**
+	 * Reads and parses an .ini file from disk.
+	 *
+	 * @returns False if the file could not be opened.
+	 */
+	bool FSimIniFile::LoadFile(const std::string& Path)
+	{
+		std::ifstream File(Path, std::ios::binary);
+		if (!File) return false;
+		std::stringstream Buffer;
+		Buffer << File.rdbuf();
+		return LoadString(Buffer.str());
+	}
+
+
+	/**
+	 * Parses .ini content ("[section]" headers and "key = value" lines, ';' and '#' comments).
+	 */
+	bool FSimIniFile::LoadString(const std::string& Content)
+	{
+		Sections.clear();
+		std::string Section;
+		std::istringstream Stream(Content);
+		std::string Line;
+		while (std::getline(Stream, Line))
+		{
+			// Skip a UTF-8 byte order mark
+			if (Line.size() >= 3 && (unsigned char)Line[0] == 0xEF && (unsigned char)Line[1] == 0xBB && (unsigned char)Line[2] == 0xBF)
+				Line = Line.substr(3);
+
+			Line = SimIni::Trim(Line);
+			if (Line.empty() || Line[0] == ';' || Line[0] == '#') continue;
+
+			if (Line.front() == '[' && Line.back() == ']')
+			{
+				Section = SimIni::Trim(Line.substr(1, Line.size() - 2));
+				continue;
+			}
+
+			const size_t Separator = Line.find('=');
+			if (Separator == std::string::npos) continue;
+			Sections[Section][SimIni::Trim(Line.substr(0, Separator))] = SimIni::Trim(Line.substr(Separator + 1));
+		}
+		return true;
+	}
+
+
+	bool FSimIniFile::GetString(const std::string& Section, const std::string& Key, std::string& OutValue) const
+	{
+		const auto SectionIt = Sections.find(Section);
+		if (SectionIt == Sections.end()) return false;
+		const auto KeyIt = SectionIt->second.find(Key);
+		if (KeyIt == SectionIt->second.end()) return false;
+		OutValue = KeyIt->second;
+		return true;
+	}
+
+
+	bool FSimIniFile::GetDouble(const std::string& Section, const std::string& Key, double& OutValue) const
+	{
+		std::string Value;
+		if (!GetString(Section, Key, Value)) return false;
+		char* End = nullptr;
+		const double Parsed = std::strtod(Value.c_str(), &End);
+		if (End == Value.c_str()) return false;
+		OutValue = Parsed;
+		return true;
+	}
+
+
+	bool FSimIniFile::GetFloat(const std::string& Section, const std::string& Key, float& OutValue) const
+	{
+		double Value;
+		if (!GetDouble(Section, Key, Value)) return false;
+		OutValue = (float)Value;
+		return true;
+	}
+
+
+	bool FSimIniFile::GetInt(const std::string& Section, const std::string& Key, int& OutValue) const
+	{
+		std::string Value;
+		if (!GetString(Section, Key, Value)) return false;
+		char* End = nullptr;
+		const long Parsed = std::strtol(Value.c_str(), &End, 10);
+		if (End == Value.c_str()) return false;
+		OutValue = (int)Parsed;
+		return true;
+	}
+
+
+	/**
+	 * Reads a non-negative integer, written in decimal digits only.
+	 *
+	 * @returns False if the key is missing, or its value is not such an integer or does not fit in 64 bits.
+	 */
+	bool FSimIniFile::GetUInt64(const std::string& Section, const std::string& Key, uint64_t& OutValue) const
+	{
+		std::string Value;
+		if (!GetString(Section, Key, Value)) return false;
+		if (Value.empty() || Value.find_first_not_of("0123456789") != std::string::npos) return false;
+		errno = 0;
+		const unsigned long long Parsed = std::strtoull(Value.c_str(), nullptr, 10);
+		if (errno == ERANGE) return false;
+		OutValue = Parsed;
+		return true;
+	}
+
+
+	bool FSimIniFile::GetBool(const std::string& Section, const std::string& Key, bool& OutValue) const
+	{
+		std::string Value;
+		if (!GetString(Section, Key, Value)) return false;
+		Value = SimIni::ToLower(Value);
+		OutValue = Value == "true" || Value == "yes" || Value == "on" || std::atoi(Value.c_str()) != 0;
+		return true;
+	}
+
+
+	/**
+	 * 64-bit FNV-1a hash of every section, key and value, blind to comments, spacing and the order of the lines.
+	 */
+	uint64_t FSimIniFile::Hash() const
+	{
+		uint64_t Hash = 14695981039346656037ull;
+		const auto Add = [&Hash](const std::string& Text)
+		{
+			// The terminating zero separates consecutive strings
+			for (size_t i = 0; i <= Text.size(); i++)
+			{
+				Hash ^= i < Text.size() ? (unsigned char)Text[i] : 0;
+				Hash *= 1099511628211ull;
+			}
+		};
+		for (const auto& Section : Sections)
+		{
+			Add(Section.first);
+			for (const auto& Key : Section.second)
+			{
+				Add(Key.first);
+				Add(Key.second);
+			}
+		}
+		return Hash;
+	}
+
+
+	/**
+	 * Loading configuration from parsed .ini content.
+	 *
+	 * Keys missing from the file keep their default value.
+	 */
+	bool FSimConfig::LoadFromIni(const FSimIniFile& Ini, std::string& OutError)
+	{
+		Ini.GetFloat("sim/global", "step", Step);
+		Ini.GetInt("sim/global", "sim_speed", SimulationSpeed);
+		Ini.GetDouble("sim/global", "environment_X_length", EnvSize.X);
+		Ini.GetDouble("sim/global", "environment_Y_length", EnvSize.Y);
+		Ini.GetInt("sim/global", "lines_thickness", LinesThickness);
+		Ini.GetBool("sim/global", "render", IsRenderEnabled);
+		Ini.GetBool("sim/global", "max_throughput", IsMaxThroughput);
+		Ini.GetFloat("sim/global", "frame_budget_ms", FrameBudgetMs);
+		Ini.GetInt("sim/global", "max_steps_per_frame", MaxStepsPerFrame);
+		std::string BackendName;
+		if (Ini.GetString("sim/global", "backend", BackendName))
+		{
+			BackendName = SimIni::ToLower(BackendName);
+			if (BackendName == "actors") Backend = ESimBackend::Actors;
+			else if (BackendName == "core") Backend = ESimBackend::Core;
+			else
+			{
+				OutError = "sim/global backend must be actors or core";
+				return false;
+			}
+		}
+
+		Ini.GetInt("sim/manager", "env_max_columns", EnvMaxColumns);
+		std::string PartitionName;
+		if (Ini.GetString("sim/manager", "partition", PartitionName))
+		{
+			PartitionName = SimIni::ToLower(PartitionName);
+			if (PartitionName == "grid") Partition = ESimPartition::Grid;
+			else if (PartitionName == "strips") Partition = ESimPartition::Strips;
+			else if (PartitionName == "balanced") Partition = ESimPartition::Balanced;
+			else
+			{
+				OutError = "sim/manager partition must be grid, strips or balanced";
+				return false;
+			}
+		}
+		Ini.GetInt("sim/manager", "min_drones", MinNumDrones);
+		Ini.GetInt("sim/manager", "max_drones", MaxNumDrones);
+		Ini.GetFloat("sim/manager", "speed_increment", SpeedIncrement);
+		Ini.GetInt("sim/manager", "drone_increment", DroneIncrement);
+		Ini.GetInt("sim/manager", "sim_group_size", SimGroupSize);
+		Ini.GetInt("sim/manager", "worker_threads", WorkerThreads);
+		std::string SeedName;
+		if (Ini.GetString("sim/manager", "seed", SeedName) && !SeedName.empty())
+		{
+			uint64_t SeedValue;
+			if (!Ini.GetUInt64("sim/manager", "seed", SeedValue) || SeedValue > std::numeric_limits<uint32_t>::max())
+			{
+				OutError = "sim/manager seed must be an integer between 0 and 4294967295";
+				return false;
+			}
+			Seed = (uint32_t)SeedValue;
+		}
+		Ini.GetBool("sim/manager", "common_random_numbers", CommonRandomNumbers);
+		Ini.GetString("sim/manager", "records_file", RecordsFile);
+		Ini.GetString("sim/manager", "trajectory_file", TrajectoryFile);
+		Ini.GetString("sim/manager", "checkpoint_file", CheckpointFile);
+		Ini.GetFloat("sim/manager", "checkpoint_interval", CheckpointInterval);
+		Ini.GetString("sim/manager", "cache_dir", CacheDir);
+		std::string SearchModeName;
+		if (Ini.GetString("sim/manager", "search_mode", SearchModeName))
+		{
+			SearchModeName = SimIni::ToLower(SearchModeName);
+			if (SearchModeName == "linear") SearchMode = ESimSearchMode::Linear;
+			else if (SearchModeName == "bisection") SearchMode = ESimSearchMode::Bisection;
+			else
+			{
+				OutError = "sim/manager search_mode must be linear or bisection";
+				return false;
+			}
+		}
+		Ini.GetFloat("sim/manager", "speed_resolution", SpeedResolution);
+		std::string EarlyStoppingName;
+		if (Ini.GetString("sim/manager", "early_stopping", EarlyStoppingName))
+		{
+			EarlyStoppingName = SimIni::ToLower(EarlyStoppingName);
+			if (EarlyStoppingName == "none") EarlyStopping = ESimEarlyStopping::None;
+			else if (EarlyStoppingName == "settled") EarlyStopping = ESimEarlyStopping::Settled;
+			else if (EarlyStoppingName == "sprt") EarlyStopping = ESimEarlyStopping::Sprt;
+			else
+			{
+				OutError = "sim/manager early_stopping must be none, settled or sprt";
+				return false;
+			}
+		}
+		Ini.GetDouble("sim/manager", "sprt_alpha", SprtAlpha);
+		Ini.GetDouble("sim/manager", "sprt_beta", SprtBeta);
+		Ini.GetDouble("sim/manager", "sprt_indifference", SprtIndifference);
+		Ini.GetBool("sim/manager", "coverage_early_stop", CoverageEarlyStop);
+		Ini.GetFloat("sim/manager", "coverage_stall_time", CoverageStallTime);
+
+		int StrategyID = (int)Strategy;
+		Ini.GetInt("sim/drones", "strategy", StrategyID);
+		Strategy = (ESimStrategy)StrategyID;
+		Ini.GetFloat("sim/drones", "ground_offset", GroundOffset);
+		Ini.GetFloat("sim/drones", "movement_tolerance", MovementTolerance);
+		Ini.GetFloat("sim/drones", "movement_distance", MovementDistance);
+		Ini.GetFloat("sim/drones", "vision_radius", VisionRadius);
+		Ini.GetFloat("sim/drones", "min_speed", MinSpeed);
+		Ini.GetFloat("sim/drones", "max_speed", MaxSpeed);
+		Ini.GetFloat("sim/drones", "battery_capacity", BatteryCapacity);
+		Ini.GetFloat("sim/drones", "battery_weight", BatteryWeight);
+		Ini.GetInt("sim/drones", "min_battery_count", MinBatteryCount);
+		Ini.GetInt("sim/drones", "max_battery_count", MaxBatteryCount);
+		Ini.GetFloat("sim/drones", "initial_weight", InitialWeight);
+		Ini.GetBool("sim/drones", "energy_model", EnergyModel);
+		Ini.GetFloat("sim/drones", "hover_power", HoverPower);
+		Ini.GetFloat("sim/drones", "turn_energy", TurnEnergy);
+
+		Ini.GetInt("sim/drones/spiral", "circle_points", NbCirclePoints);
+		Ini.GetFloat("sim/drones/spiral", "spiral_radius", SpiralRadius);
+		Ini.GetFloat("sim/drones/spiral", "wander_distance", WanderDistance);
+		Ini.GetInt("sim/drones/spiral", "wander_steps", WanderSteps);
+		Ini.GetFloat("sim/drones/spiral", "spiral_increment_factor", SpiralIncrementFactor);
+		Ini.GetBool("sim/drones/spiral", "concentric_circles", DrawsConcentricCircles);
+
+		Ini.GetFloat("sim/drones/sweep", "sweep_height", SweepHeight);
+		Ini.GetBool("sim/drones/sweep", "oracle", UsesSweepOracle);
+
+		Ini.GetBool("sim/objective", "is_moving", ObjectiveIsMoving);
+		Ini.GetFloat("sim/objective", "speed", ObjectiveSpeed);
+		Ini.GetFloat("sim/objective", "min_distance_ratio", ObjectiveMinDistanceRatio);
+		Ini.GetFloat("sim/objective", "collision_check_radius", ObjectiveCollisionCheckRadius);
+		Ini.GetInt("sim/objective", "count", ObjectiveCount);
+		std::string CompletionName;
+		if (Ini.GetString("sim/objective", "completion", CompletionName))
+		{
+			CompletionName = SimIni::ToLower(CompletionName);
+			if (CompletionName == "first") Completion = ESimCompletion::First;
+			else if (CompletionName == "count") Completion = ESimCompletion::Count;
+			else if (CompletionName == "all") Completion = ESimCompletion::All;
+			else
+			{
+				OutError = "sim/objective completion must be first, count or all";
+				return false;
+			}
+		}
+		Ini.GetInt("sim/objective", "completion_count", CompletionCount);
+
+		IniHash = Ini.Hash();
+		return Validate(OutError);
+	}
+
+
+	/**
+	 * Checks that the values make sense for a simulation.
+	 *
+	 * @param OutError Description of the first invalid value.
+	 */
+	bool FSimConfig::Validate(std::string& OutError) const
+	{
+		const auto Fail = [&OutError](const char* Text)
+		{
+			OutError = Text;
+			return false;
+		};
+
+		if (Step <= 0) return Fail("sim/global step must be positive");
+		if (SimulationSpeed < 1) return Fail("sim/global sim_speed must be at least 1");
+		if (FrameBudgetMs <= 0) return Fail("sim/global frame_budget_ms must be positive");
+		if (MaxStepsPerFrame < 1) return Fail("sim/global max_steps_per_frame must be at least 1");
+		if (EnvSize.X <= 0 || EnvSize.Y <= 0) return Fail("sim/global environment lengths must be positive");
+
+		if (EnvMaxColumns < 1) return Fail("sim/manager env_max_columns must be at least 1");
+		if (MinNumDrones < 1 || MaxNumDrones < MinNumDrones) return Fail("sim/manager drone range is invalid");
+		if (SpeedIncrement <= 0) return Fail("sim/manager speed_increment must be positive");
+		if (DroneIncrement < 1) return Fail("sim/manager drone_increment must be at least 1");
+		if (SimGroupSize < 1) return Fail("sim/manager sim_group_size must be at least 1");
+		if (SpeedResolution <= 0) return Fail("sim/manager speed_resolution must be positive");
+		if (EarlyStopping == ESimEarlyStopping::Sprt)
+		{
+			if (SprtAlpha <= 0 || SprtAlpha >= .5 || SprtBeta <= 0 || SprtBeta >= .5)
+				return Fail("sim/manager sprt_alpha and sprt_beta must be in ]0, 0.5[");
+			if (SprtIndifference <= 0 || SprtIndifference >= .5) return Fail("sim/manager sprt_indifference must be in ]0, 0.5[");
+		}
+		if (CoverageStallTime <= 0) return Fail("sim/manager coverage_stall_time must be positive");
+		if (CheckpointInterval < 0) return Fail("sim/manager checkpoint_interval must not be negative");
+
+		if (Strategy != ESimStrategy::Random && Strategy != ESimStrategy::Sweep && Strategy != ESimStrategy::Spiral)
+			return Fail("sim/drones strategy must be 1 (random), 2 (sweep) or 3 (spiral)");
+		if (MovementTolerance < 0) return Fail("sim/drones movement_tolerance must not be negative");
+		if (MovementDistance <= 0) return Fail("sim/drones movement_distance must be positive");
+		if (VisionRadius <= 0) return Fail("sim/drones vision_radius must be positive");
+		if (MinSpeed <= 0 || MaxSpeed < MinSpeed) return Fail("sim/drones speed range is invalid");
+		if (BatteryCapacity <= 0) return Fail("sim/drones battery_capacity must be positive");
+		if (MinBatteryCount < 0 || MaxBatteryCount < MinBatteryCount) return Fail("sim/drones battery count range is invalid");
+		if (HoverPower < 0) return Fail("sim/drones hover_power must not be negative");
+		if (TurnEnergy < 0) return Fail("sim/drones turn_energy must not be negative");
+
+		if (Strategy == ESimStrategy::Spiral)
+		{
+			if (NbCirclePoints < 1) return Fail("sim/drones/spiral circle_points must be at least 1");
+			if (WanderSteps < 1) return Fail("sim/drones/spiral wander_steps must be at least 1");
+			if (WanderDistance <= 0) return Fail("sim/drones/spiral wander_distance must be positive");
+		}
+		if (Strategy == ESimStrategy::Sweep && SweepHeight <= 0) return Fail("sim/drones/sweep sweep_height must be positive");
+
+		if (ObjectiveMinDistanceRatio < 0 || ObjectiveMinDistanceRatio > 1) return Fail("sim/objective min_distance_ratio must be in [0, 1]");
+		if (Partition == ESimPartition::Balanced && ObjectiveMinDistanceRatio >= 1)
+			return Fail("sim/objective min_distance_ratio must be below 1 with the balanced partition");
+		if (ObjectiveSpeed < 0) return Fail("sim/objective speed must not be negative");
+		if (ObjectiveCount < 1) return Fail("sim/objective count must be at least 1");
+		if (Completion == ESimCompletion::Count && (CompletionCount < 1 || CompletionCount > ObjectiveCount))
+			return Fail("sim/objective completion_count must be between 1 and count");
+
+		return true;
+	}
+
+
+	/**
+	 * Loading configuration from an .ini file on disk.
+	 */
+	bool FSimConfig::LoadFromFile(const std::string& Path, std::string& OutError)
+	{
+		FSimIniFile Ini;
+		if (!Ini.LoadFile(Path))
+		{
+			OutError = "Cannot open " + Path;
+			return false;
+		}
+		return LoadFromIni(Ini, OutError);
+	}
+
+
+	/**
+	 * Parses and validates an .ini file into a read-only snapshot.
+	 *
+	 * @returns The snapshot, or null if the file could not be read or is invalid.
+	 */
+	std::shared_ptr<const FSimConfig> FSimConfig::LoadShared(const std::string& Path, std::string& OutError)
+	{
+		std::shared_ptr<FSimConfig> Config = std::make_shared<FSimConfig>();
+		if (!Config->LoadFromFile(Path, OutError)) return nullptr;
+		return Config;
+	}
+}
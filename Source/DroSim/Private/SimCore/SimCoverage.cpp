@@ -0,0 +1,200 @@
+#include "SimCore/SimCoverage.h"
+
+#include <algorithm>
+#include <cmath>
+
+#if defined(_MSC_VER)
+#include <intrin.h>
+#endif
+
+namespace DroSimCore
+{
+	namespace SimCoverage
+	{
+		int CountBits(const uint64_t Word)
+		{
+#if defined(_MSC_VER)
+			return (int)__popcnt64(Word);
+#else
+			return __builtin_popcountll(Word);
+#endif
+		}
+
+
+		/** Bits FirstBit to LastBit of a word, both included. */
+		uint64_t SpanMask(const int FirstBit, const int LastBit)
+		{
+			const uint64_t High = LastBit == 63 ? ~0ull : (1ull << (LastBit + 1)) - 1;
+			return High & ~((1ull << FirstBit) - 1);
+		}
+
+
+		/** Index of the cell containing a coordinate, clamped to the grid. */
+		int CellIndex(const double Coordinate, const double Origin, const double CellSize, const int NumCells)
+		{
+			return std::clamp((int)std::floor((Coordinate - Origin) / CellSize), 0, NumCells - 1);
+		}
+	}
+
+
+	/**
+	 * Creates one empty map per zone, the drone of zone i being the drone at index i.
+	 */
+	void FSimCoverage::Reset(const FSimConfig& Config, const std::vector<FSimZone>& Zones)
+	{
+		VisionRadius = Config.VisionRadius;
+		CellSize = VisionRadius / 2;
+		IsObjectiveMoving = Config.ObjectiveIsMoving;
+		EnvSizeY = Config.EnvSize.Y;
+		StallTime = Config.CoverageStallTime;
+
+		Maps.resize(Zones.size());
+		TotalCells = 0;
+		TotalCoveredCells = 0;
+		for (size_t i = 0; i < Zones.size(); i++)
+		{
+			FZoneMap& Map = Maps[i];
+			Map.Min = FSimVec2(Zones[i].BottomRight.X, Zones[i].TopLeft.Y);
+			Map.Max = FSimVec2(Zones[i].TopLeft.X, Zones[i].BottomRight.Y);
+			Map.Rows = std::max(1, (int)std::ceil((Map.Max.X - Map.Min.X) / CellSize));
+			Map.Columns = std::max(1, (int)std::ceil((Map.Max.Y - Map.Min.Y) / CellSize));
+			Map.WordsPerRow = (Map.Columns + 63) / 64;
+			Map.Bits.assign((size_t)Map.Rows * Map.WordsPerRow, 0);
+			Map.CoveredCells = 0;
+			Map.LastGrowthTime = 0;
+			TotalCells += Map.Rows * Map.Columns;
+		}
+	}
+
+
+	/**
+	 * Marks as covered every cell of a zone whose centre is within the vision radius of a drone position.
+	 *
+	 * Callers need not stamp every position, see GetStampDistance. A drone still flying to its zone is making
+	 * progress even though it covers nothing of it.
+	 */
+	void FSimCoverage::Stamp(const int Zone, const FSimVec3& Position, const float Time)
+	{
+		FZoneMap& Map = Maps[Zone];
+		if (Position.X < Map.Min.X || Position.X > Map.Max.X || Position.Y < Map.Min.Y || Position.Y > Map.Max.Y)
+		{
+			Map.LastGrowthTime = Time;
+			return;
+		}
+
+		const double RadiusSquared = VisionRadius * VisionRadius;
+
+		// Rows whose centre is within the radius along X
+		const int FirstRow = std::max(0, (int)std::ceil((Position.X - VisionRadius - Map.Min.X) / CellSize - 0.5));
+		const int LastRow = std::min(Map.Rows - 1, (int)std::floor((Position.X + VisionRadius - Map.Min.X) / CellSize - 0.5));
+
+		int NewCells = 0;
+		for (int Row = FirstRow; Row <= LastRow; Row++)
+		{
+			const double DX = Map.Min.X + (Row + 0.5) * CellSize - Position.X;
+			const double HalfChord = std::sqrt(std::max(0.0, RadiusSquared - DX * DX));
+			const int FirstColumn = std::max(0, (int)std::ceil((Position.Y - HalfChord - Map.Min.Y) / CellSize - 0.5));
+			const int LastColumn = std::min(Map.Columns - 1, (int)std::floor((Position.Y + HalfChord - Map.Min.Y) / CellSize - 0.5));
+			if (FirstColumn <= LastColumn) NewCells += SetSpan(Map, Row, FirstColumn, LastColumn);
+		}
+
+		if (NewCells > 0)
+		{
+			Map.CoveredCells += NewCells;
+			TotalCoveredCells += NewCells;
+			Map.LastGrowthTime = Time;
+		}
+	}
+
+
+	/**
+	 * Sets the cells of a row span, a whole word at a time.
+	 *
+	 * @returns Number of cells that were not covered yet.
+	 */
+	int FSimCoverage::SetSpan(FZoneMap& Map, const int Row, const int FirstColumn, const int LastColumn)
+	{
+		uint64_t* Words = &Map.Bits[(size_t)Row * Map.WordsPerRow];
+		int NewCells = 0;
+		for (int Word = FirstColumn / 64; Word <= LastColumn / 64; Word++)
+		{
+			const uint64_t Mask = SimCoverage::SpanMask(
+				std::max(FirstColumn - Word * 64, 0),
+				std::min(LastColumn - Word * 64, 63));
+			NewCells += SimCoverage::CountBits(Mask & ~Words[Word]);
+			Words[Word] |= Mask;
+		}
+		return NewCells;
+	}
+
+
+	/**
+	 * Whether any cell of a map overlapping a rectangle is covered.
+	 */
+	bool FSimCoverage::HasCoveredCellIn(const FZoneMap& Map, const FSimVec2& Min, const FSimVec2& Max) const
+	{
+		if (Max.X < Map.Min.X || Min.X > Map.Max.X || Max.Y < Map.Min.Y || Min.Y > Map.Max.Y) return false;
+
+		const int FirstRow = SimCoverage::CellIndex(Min.X, Map.Min.X, CellSize, Map.Rows);
+		const int LastRow = SimCoverage::CellIndex(Max.X, Map.Min.X, CellSize, Map.Rows);
+		const int FirstColumn = SimCoverage::CellIndex(Min.Y, Map.Min.Y, CellSize, Map.Columns);
+		const int LastColumn = SimCoverage::CellIndex(Max.Y, Map.Min.Y, CellSize, Map.Columns);
+
+		for (int Row = FirstRow; Row <= LastRow; Row++)
+		{
+			const uint64_t* Words = &Map.Bits[(size_t)Row * Map.WordsPerRow];
+			for (int Word = FirstColumn / 64; Word <= LastColumn / 64; Word++)
+				if (Words[Word] & SimCoverage::SpanMask(std::max(FirstColumn - Word * 64, 0), std::min(LastColumn - Word * 64, 63)))
+					return true;
+		}
+		return false;
+	}
+
+
+	/**
+	 * Covered fraction of all the zones, between 0 and 1.
+	 */
+	double FSimCoverage::GetCoverage() const
+	{
+		return TotalCells > 0 ? (double)TotalCoveredCells / TotalCells : 0;
+	}
+
+
+	double FSimCoverage::GetZoneCoverage(const int Zone) const
+	{
+		const FZoneMap& Map = Maps[Zone];
+		return (double)Map.CoveredCells / (Map.Rows * Map.Columns);
+	}
+
+
+	/**
+	 * Whether the objective can no longer be found.
+	 *
+	 * The objective can be anywhere on its path: its position if it is static, its whole line along Y otherwise.
+	 * Once in their zone drones never leave it, so only those whose zone is within vision radius of that path can
+	 * find it. The cell a drone is in is always covered, so a drone without any covered cell within vision radius
+	 * (plus the stamp distance) of the path has never seen it from its zone.
+	 * The simulation is hopeless when every drone that could find the objective is in that case and has neither
+	 * covered a new cell nor been on its way to its zone for coverage_stall_time.
+	 * This is a heuristic: it assumes such drones keep missing the objective until the maximum time, which a
+	 * strategy that stalls before widening its search would break.
+	 */
+	bool FSimCoverage::IsHopeless(const FSimVec3& ObjectivePosition, const float Time) const
+	{
+		const FSimVec2 PathMin(ObjectivePosition.X, IsObjectiveMoving ? 0 : ObjectivePosition.Y);
+		const FSimVec2 PathMax(ObjectivePosition.X, IsObjectiveMoving ? EnvSizeY : ObjectivePosition.Y);
+
+		for (const FZoneMap& Map : Maps)
+		{
+			const bool CanReachPath = PathMax.X >= Map.Min.X - VisionRadius && PathMin.X <= Map.Max.X + VisionRadius
+				&& PathMax.Y >= Map.Min.Y - VisionRadius && PathMin.Y <= Map.Max.Y + VisionRadius;
+			if (!CanReachPath) continue;
+
+			if (Time - Map.LastGrowthTime < StallTime) return false;
+			const double Margin = VisionRadius + GetStampDistance();
+			if (HasCoveredCellIn(Map, FSimVec2(PathMin.X - Margin, PathMin.Y - Margin), FSimVec2(PathMax.X + Margin, PathMax.Y + Margin)))
+				return false;
+		}
+		return true;
+	}
+}
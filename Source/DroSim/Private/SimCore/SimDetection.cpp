@@ -0,0 +1,45 @@
+#include "SimCore/SimDetection.h"
+
+#include <cmath>
+
+namespace DroSimCore
+{
+	/**
+	 * Solves |R0 + Alpha * D|^2 = Radius^2 for the smallest Alpha in [0, 1], R0 being the drone position
+	 * relative to the objective at the start of the step and D the relative displacement over the step.
+	 */
+	bool FindFirstContact(const FSimVec3& DroneStart, const FSimVec3& DroneEnd,
+		const FSimVec3& ObjectiveStart, const FSimVec3& ObjectiveEnd,
+		const double Radius, double& OutAlpha)
+	{
+		const FSimVec3 R0 = DroneStart - ObjectiveStart;
+		const FSimVec3 D = (DroneEnd - DroneStart) - (ObjectiveEnd - ObjectiveStart);
+		const double RadiusSquared = Radius * Radius;
+
+		// Already in sight at the start of the step
+		const double C = R0.SizeSquared() - RadiusSquared;
+		if (C <= 0)
+		{
+			OutAlpha = 0;
+			return true;
+		}
+
+		// No relative movement
+		const double A = D.SizeSquared();
+		if (A <= 0) return false;
+
+		// Moving away from the objective
+		const double B = R0.X * D.X + R0.Y * D.Y + R0.Z * D.Z;
+		if (B >= 0) return false;
+
+		// Closest approach is out of range
+		const double Discriminant = B * B - A * C;
+		if (Discriminant < 0) return false;
+
+		const double Alpha = (-B - std::sqrt(Discriminant)) / A;
+		if (Alpha > 1) return false;
+
+		OutAlpha = Alpha < 0 ? 0 : Alpha;
+		return true;
+	}
+}
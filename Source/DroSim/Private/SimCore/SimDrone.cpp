@@ -0,0 +1,128 @@
+#include "SimCore/SimDrone.h"
+
+#include "SimCore/SimDroneRandom.h"
+#include "SimCore/SimDroneSpiral.h"
+#include "SimCore/SimDroneSweep.h"
+
+namespace DroSimCore
+{
+	FSimDrone::FSimDrone(const FSimConfig& InConfig, const int InID, const FSimZone& InZone, const float InSpeed, const FSimRandom& InRandom)
+		: Config(InConfig)
+		, Random(InRandom)
+		, AssignedZone(InZone)
+		, ID(InID)
+		, MovementSpeed(InSpeed)
+		// Same spawn point as in AManager::SpawnDrones
+		, CalculatedPosition(0, 200.0 * InID, InConfig.GroundOffset)
+	{
+	}
+
+
+	/**
+	 * Sets the first destination of the drone, the centre of its zone by default.
+	 */
+	void FSimDrone::Start()
+	{
+		SetDestinationManual(FSimVec3(
+			(AssignedZone.TopLeft.X + AssignedZone.BottomRight.X) / 2.0,
+			(AssignedZone.TopLeft.Y + AssignedZone.BottomRight.Y) / 2.0,
+			Config.GroundOffset));
+	}
+
+
+	/**
+	 * Advances the drone by one substep of Config.Step simulated seconds.
+	 */
+	void FSimDrone::Step()
+	{
+		// Calculate the Drone's next location
+		FSimVec3 NextLocation = CalculatedPosition + MoveDirection * MovementSpeed * Config.Step;
+		const double DistanceToDestination = FSimVec3::DistSquared(CalculatedPosition, CurrentDestination);
+		const double NextDistanceToDestination = FSimVec3::DistSquared(NextLocation, CurrentDestination);
+
+		// If the Drone is close enough or has passed its destination, it is considered arrived
+		if (DistanceToDestination <= (double)Config.MovementTolerance * Config.MovementTolerance) OnDestinationReached();
+		else if (NextDistanceToDestination >= DistanceToDestination) NextLocation = CurrentDestination;
+
+		CalculatedPosition = NextLocation;
+	}
+
+
+	/**
+	 * Hands the movement state of the drone over to a batch, which steps it from now on.
+	 */
+	void FSimDrone::AttachToBatch(FSimDroneBatch& InBatch)
+	{
+		Batch = &InBatch;
+		BatchIndex = Batch->Add(CalculatedPosition, MoveDirection, CurrentDestination, MovementSpeed);
+	}
+
+
+	/**
+	 * Called by the owner of the batch for a drone that was at its destination during the last FSimDroneBatch::StepAll.
+	 *
+	 * Same outcome as the arrival branch of Step: the strategy picks a new destination from the position the drone
+	 * had before the substep, while the drone itself keeps the position computed by the batch.
+	 */
+	void FSimDrone::HandleBatchArrival()
+	{
+		CalculatedPosition = Batch->GetPreviousPosition(BatchIndex);
+		MoveDirection = Batch->GetDirection(BatchIndex);
+		CurrentDestination = Batch->GetDestination(BatchIndex);
+
+		OnDestinationReached();
+
+		CalculatedPosition = Batch->GetPosition(BatchIndex);
+		Batch->SetDirection(BatchIndex, MoveDirection);
+		Batch->SetDestination(BatchIndex, CurrentDestination);
+	}
+
+
+	/**
+	 * Lets the strategy pick a new destination as if the drone had just reached the current one, for callers
+	 * that work out the movement themselves, see FSimSweepOracle.
+	 */
+	void FSimDrone::SkipToDestination()
+	{
+		OnDestinationReached();
+	}
+
+
+	/**
+	 * Called when the drone reaches its current destination.
+	 */
+	void FSimDrone::OnDestinationReached()
+	{
+		CalculatedPosition = CurrentDestination;
+		SetNewDestination();
+	}
+
+
+	/**
+	 * Manually sets the destination point.
+	 */
+	void FSimDrone::SetDestinationManual(const FSimVec3& NewDestination)
+	{
+		CurrentDestination = MoveDirection = NewDestination;
+		MoveDirection.Normalize();
+	}
+
+
+	/**
+	 * Creates a drone implementing the given strategy.
+	 */
+	std::unique_ptr<FSimDrone> MakeSimDrone(const ESimStrategy Strategy, const FSimConfig& Config, const int ID, const FSimZone& Zone, const float Speed, const FSimRandom& Random)
+	{
+		switch (Strategy)
+		{
+		case ESimStrategy::Random:
+			return std::make_unique<FSimDroneRandom>(Config, ID, Zone, Speed, Random);
+		case ESimStrategy::Sweep:
+			return std::make_unique<FSimDroneSweep>(Config, ID, Zone, Speed, Random);
+		case ESimStrategy::Spiral:
+			return std::make_unique<FSimDroneSpiral>(Config, ID, Zone, Speed, Random);
+		default:
+			return nullptr;
+		}
+	}
+}
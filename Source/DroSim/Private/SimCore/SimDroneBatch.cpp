@@ -0,0 +1,223 @@
+#include "SimCore/SimDroneBatch.h"
+
+#include "SimCore/SimDetection.h"
+#include "SimSimd.h"
+
+namespace DroSimCore
+{
+	void FSimDroneBatch::Reset()
+	{
+		for (std::vector<double>* Array : {&PosX, &PosY, &PosZ, &PrevX, &PrevY, &PrevZ, &DirX, &DirY, &DirZ, &DestX, &DestY, &DestZ, &Speed})
+			Array->clear();
+		Active.clear();
+		ActiveCount = 0;
+	}
+
+
+	void FSimDroneBatch::Reserve(const int Count)
+	{
+		for (std::vector<double>* Array : {&PosX, &PosY, &PosZ, &PrevX, &PrevY, &PrevZ, &DirX, &DirY, &DirZ, &DestX, &DestY, &DestZ, &Speed})
+			Array->reserve(Count);
+		Active.reserve(Count);
+	}
+
+
+	/**
+	 * Appends a drone to the batch.
+	 *
+	 * @returns Index of the drone in the batch.
+	 */
+	int FSimDroneBatch::Add(const FSimVec3& Position, const FSimVec3& Direction, const FSimVec3& Destination, const double InSpeed)
+	{
+		PosX.push_back(Position.X); PosY.push_back(Position.Y); PosZ.push_back(Position.Z);
+		PrevX.push_back(Position.X); PrevY.push_back(Position.Y); PrevZ.push_back(Position.Z);
+		DirX.push_back(Direction.X); DirY.push_back(Direction.Y); DirZ.push_back(Direction.Z);
+		DestX.push_back(Destination.X); DestY.push_back(Destination.Y); DestZ.push_back(Destination.Z);
+		Speed.push_back(InSpeed);
+		Active.push_back(1);
+		ActiveCount++;
+		return Num() - 1;
+	}
+
+
+	void FSimDroneBatch::SetPosition(const int i, const FSimVec3& V)
+	{
+		PosX[i] = V.X; PosY[i] = V.Y; PosZ[i] = V.Z;
+	}
+
+
+	void FSimDroneBatch::SetDirection(const int i, const FSimVec3& V)
+	{
+		DirX[i] = V.X; DirY[i] = V.Y; DirZ[i] = V.Z;
+	}
+
+
+	void FSimDroneBatch::SetDestination(const int i, const FSimVec3& V)
+	{
+		DestX[i] = V.X; DestY[i] = V.Y; DestZ[i] = V.Z;
+	}
+
+
+	/**
+	 * Stops a drone for good, it stays where it is from now on and no longer sees objectives.
+	 */
+	void FSimDroneBatch::Deactivate(const int i)
+	{
+		if (!Active[i]) return;
+		Active[i] = 0;
+		ActiveCount--;
+
+		// Standing on its destination, so that the movement rule does not snap it there
+		Speed[i] = 0;
+		DestX[i] = PosX[i]; DestY[i] = PosY[i]; DestZ[i] = PosZ[i];
+	}
+
+
+	/**
+	 * Name of the vector instruction set the kernels were compiled for.
+	 */
+	const char* FSimDroneBatch::GetInstructionSetName()
+	{
+		return FSimdOps::Name;
+	}
+
+
+	/**
+	 * Same movement rule as FSimDrone::Step for Ops::Lanes drones starting at index i.
+	 */
+	template <typename Ops>
+	void FSimDroneBatch::StepBlock(const int i, const double StepDuration, const double ToleranceSquared, std::vector<int>& OutArrived)
+	{
+		using FReg = typename Ops::FReg;
+		using FMask = typename Ops::FMask;
+
+		const FReg Px = Ops::Load(&PosX[i]), Py = Ops::Load(&PosY[i]), Pz = Ops::Load(&PosZ[i]);
+		const FReg Tx = Ops::Load(&DestX[i]), Ty = Ops::Load(&DestY[i]), Tz = Ops::Load(&DestZ[i]);
+		const FReg Sp = Ops::Load(&Speed[i]);
+		const FReg Dt = Ops::Set1(StepDuration);
+
+		// Next location
+		FReg Nx = Ops::Add(Px, Ops::Mul(Ops::Mul(Ops::Load(&DirX[i]), Sp), Dt));
+		FReg Ny = Ops::Add(Py, Ops::Mul(Ops::Mul(Ops::Load(&DirY[i]), Sp), Dt));
+		FReg Nz = Ops::Add(Pz, Ops::Mul(Ops::Mul(Ops::Load(&DirZ[i]), Sp), Dt));
+
+		// Squared distances to destination, now and after the move
+		const FReg Cx = Ops::Sub(Px, Tx), Cy = Ops::Sub(Py, Ty), Cz = Ops::Sub(Pz, Tz);
+		const FReg Distance = Ops::Add(Ops::Add(Ops::Mul(Cx, Cx), Ops::Mul(Cy, Cy)), Ops::Mul(Cz, Cz));
+		const FReg Ex = Ops::Sub(Nx, Tx), Ey = Ops::Sub(Ny, Ty), Ez = Ops::Sub(Nz, Tz);
+		const FReg NextDistance = Ops::Add(Ops::Add(Ops::Mul(Ex, Ex), Ops::Mul(Ey, Ey)), Ops::Mul(Ez, Ez));
+
+		// Arrived drones keep moving along their old direction, the others snap to their destination when passing it
+		const FMask Arrived = Ops::CmpLe(Distance, Ops::Set1(ToleranceSquared));
+		const FMask Overshoot = Ops::AndNot(Ops::CmpGe(NextDistance, Distance), Arrived);
+		Nx = Ops::Select(Overshoot, Tx, Nx);
+		Ny = Ops::Select(Overshoot, Ty, Ny);
+		Nz = Ops::Select(Overshoot, Tz, Nz);
+
+		Ops::Store(&PrevX[i], Px); Ops::Store(&PrevY[i], Py); Ops::Store(&PrevZ[i], Pz);
+		Ops::Store(&PosX[i], Nx); Ops::Store(&PosY[i], Ny); Ops::Store(&PosZ[i], Nz);
+
+		const int ArrivedBits = Ops::MoveMask(Arrived);
+		if (ArrivedBits)
+			for (int Lane = 0; Lane < Ops::Lanes; Lane++)
+				if ((ArrivedBits & (1 << Lane)) && Active[i + Lane]) OutArrived.push_back(i + Lane);
+	}
+
+
+	/**
+	 * Advances every drone by one substep.
+	 *
+	 * Previous positions are kept for detection. Active drones that were at their destination are appended to
+	 * OutArrived: the caller is expected to give them a new destination.
+	 */
+	void FSimDroneBatch::StepAll(const double StepDuration, const double Tolerance, std::vector<int>& OutArrived)
+	{
+		OutArrived.clear();
+		const double ToleranceSquared = Tolerance * Tolerance;
+		const int Count = Num();
+
+		int i = 0;
+		for (; i + FSimdOps::Lanes <= Count; i += FSimdOps::Lanes) StepBlock<FSimdOps>(i, StepDuration, ToleranceSquared, OutArrived);
+		for (; i < Count; i++) StepBlock<FScalarOps>(i, StepDuration, ToleranceSquared, OutArrived);
+	}
+
+
+	/**
+	 * Flags the drones whose last move came within the vision radius of the objective, see FindFirstContact.
+	 *
+	 * The test only uses squared distances: with Alpha = (-B - sqrt(Disc)) / A, Alpha <= 1 is -B - A <= sqrt(Disc).
+	 *
+	 * @returns Bit mask of the lanes that saw the objective.
+	 */
+	template <typename Ops>
+	int FSimDroneBatch::DetectBlock(const int i, const FSimVec3& ObjectiveStart, const FSimVec3& ObjectiveMove, const double RadiusSquared) const
+	{
+		using FReg = typename Ops::FReg;
+		using FMask = typename Ops::FMask;
+
+		const FReg Px = Ops::Load(&PrevX[i]), Py = Ops::Load(&PrevY[i]), Pz = Ops::Load(&PrevZ[i]);
+
+		// Relative position at the start of the step and relative displacement over it
+		const FReg Rx = Ops::Sub(Px, Ops::Set1(ObjectiveStart.X));
+		const FReg Ry = Ops::Sub(Py, Ops::Set1(ObjectiveStart.Y));
+		const FReg Rz = Ops::Sub(Pz, Ops::Set1(ObjectiveStart.Z));
+		const FReg Dx = Ops::Sub(Ops::Sub(Ops::Load(&PosX[i]), Px), Ops::Set1(ObjectiveMove.X));
+		const FReg Dy = Ops::Sub(Ops::Sub(Ops::Load(&PosY[i]), Py), Ops::Set1(ObjectiveMove.Y));
+		const FReg Dz = Ops::Sub(Ops::Sub(Ops::Load(&PosZ[i]), Pz), Ops::Set1(ObjectiveMove.Z));
+
+		const FReg Zero = Ops::Set1(0);
+		const FReg C = Ops::Sub(Ops::Add(Ops::Add(Ops::Mul(Rx, Rx), Ops::Mul(Ry, Ry)), Ops::Mul(Rz, Rz)), Ops::Set1(RadiusSquared));
+		const FReg A = Ops::Add(Ops::Add(Ops::Mul(Dx, Dx), Ops::Mul(Dy, Dy)), Ops::Mul(Dz, Dz));
+		const FReg B = Ops::Add(Ops::Add(Ops::Mul(Rx, Dx), Ops::Mul(Ry, Dy)), Ops::Mul(Rz, Dz));
+		const FReg Discriminant = Ops::Sub(Ops::Mul(B, B), Ops::Mul(A, C));
+		const FReg Margin = Ops::Sub(Ops::Sub(Zero, B), A);
+
+		const FMask InSight = Ops::CmpLe(C, Zero);
+		const FMask Approaching = Ops::And(Ops::CmpLt(B, Zero), Ops::CmpGe(Discriminant, Zero));
+		const FMask WithinStep = Ops::Or(Ops::CmpLe(Margin, Zero), Ops::CmpLe(Ops::Mul(Margin, Margin), Discriminant));
+
+		return Ops::MoveMask(Ops::Or(InSight, Ops::And(Approaching, WithinStep)));
+	}
+
+
+	/**
+	 * Tests every active drone's last move against the objective's move over the same substep.
+	 *
+	 * @param OutAlpha Fraction of the substep at which the earliest contact happens.
+	 * @param OutIndex Index of the drone that made the earliest contact.
+	 * @returns True if at least one drone saw the objective.
+	 */
+	bool FSimDroneBatch::FindFirstContact(const FSimVec3& ObjectiveStart, const FSimVec3& ObjectiveEnd, const double Radius,
+		double& OutAlpha, int& OutIndex) const
+	{
+		const FSimVec3 ObjectiveMove = ObjectiveEnd - ObjectiveStart;
+		const double RadiusSquared = Radius * Radius;
+		const int Count = Num();
+		bool HasContact = false;
+
+		// Exact contact time is only computed for the rare drones flagged by the vector test
+		const auto CheckLanes = [&](const int i, const int Bits, const int Lanes)
+		{
+			for (int Lane = 0; Lane < Lanes; Lane++)
+			{
+				double Alpha;
+				if ((Bits & (1 << Lane)) && Active[i + Lane]
+					&& DroSimCore::FindFirstContact(GetPreviousPosition(i + Lane), GetPosition(i + Lane), ObjectiveStart, ObjectiveEnd, Radius, Alpha)
+					&& (!HasContact || Alpha < OutAlpha))
+				{
+					HasContact = true;
+					OutAlpha = Alpha;
+					OutIndex = i + Lane;
+				}
+			}
+		};
+
+		int i = 0;
+		for (; i + FSimdOps::Lanes <= Count; i += FSimdOps::Lanes)
+			if (const int Bits = DetectBlock<FSimdOps>(i, ObjectiveStart, ObjectiveMove, RadiusSquared)) CheckLanes(i, Bits, FSimdOps::Lanes);
+		for (; i < Count; i++)
+			if (const int Bits = DetectBlock<FScalarOps>(i, ObjectiveStart, ObjectiveMove, RadiusSquared)) CheckLanes(i, Bits, 1);
+
+		return HasContact;
+	}
+}
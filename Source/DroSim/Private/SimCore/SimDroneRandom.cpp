@@ -0,0 +1,30 @@
+#include "SimCore/SimDroneRandom.h"
+
+namespace DroSimCore
+{
+	/**
+	 * Set a new destination point for the Drone to move towards.
+	 *
+	 * This one picks a random point in a cone in front of the Drone.
+	 */
+	void FSimDroneRandom::SetNewDestination()
+	{
+		do
+		{
+			// Random direction vector in a cone
+			FSimVec3 NewMoveDirection = FSimVec3(
+				MoveDirection.X + Random.RandRange(-1.0f, 1.0f),
+				MoveDirection.Y + Random.RandRange(-1.0f, 1.0f),
+				0);
+
+			// Normalize the direction vector
+			const double Magnitude = NewMoveDirection.Size();
+			if (Magnitude > SimSmallNumber) MoveDirection = NewMoveDirection / Magnitude;
+			else MoveDirection = NewMoveDirection;
+
+			CurrentDestination = CalculatedPosition + MoveDirection * Config.MovementDistance;
+		}
+		while (IsOutOfBounds(CurrentDestination));
+		// Redo if the next destination is outside environment limits
+	}
+}
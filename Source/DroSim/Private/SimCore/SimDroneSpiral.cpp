@@ -0,0 +1,112 @@
+#include "SimCore/SimDroneSpiral.h"
+
+#include <cmath>
+
+namespace DroSimCore
+{
+	FSimDroneSpiral::FSimDroneSpiral(const FSimConfig& InConfig, const int InID, const FSimZone& InZone, const float InSpeed, const FSimRandom& InRandom)
+		: FSimDrone(InConfig, InID, InZone, InSpeed, InRandom)
+		, Wander(InConfig.WanderSteps)
+	{
+	}
+
+
+	/**
+	 * Wanders for WanderSteps destinations, then draws a spiral around the current location.
+	 */
+	void FSimDroneSpiral::OnDestinationReached()
+	{
+		if (--Wander == 0) SetCircle();
+		SetNewDestination();
+	}
+
+
+	/**
+	 * Set a new destination point for the Drone to move towards.
+	 *
+	 * This one picks a random point to wander or calculate the next spiral point
+	 */
+	void FSimDroneSpiral::SetNewDestination()
+	{
+		if (Wander > 0) GetRandomDirection();
+		else // Making spiral
+		{
+			const int NbCirclePoints = Config.NbCirclePoints;
+			CurrentCirclePointId = CurrentCirclePointId % NbCirclePoints + 1;
+			const FSimVec3 CurrentCirclePoint = CirclePoints[CurrentCirclePointId - 1];
+
+			const float DistX = (float)(CurrentCirclePoint.X - CurrentCircleCenter.X);
+			const float DistY = (float)(CurrentCirclePoint.Y - CurrentCircleCenter.Y);
+
+			// Pick an intermediate point placed between the current circle center and the current circle point selected
+			const FSimVec3 IntermediatePoint = FSimVec3(
+				CurrentCircleCenter.X + ((DistX / NbCirclePoints) * CurrentSpiralIncrementFactor),
+				CurrentCircleCenter.Y + ((DistY / NbCirclePoints) * CurrentSpiralIncrementFactor),
+				CurrentCircleCenter.Z);
+
+			if (!Config.DrawsConcentricCircles) CurrentSpiralIncrementFactor += Config.SpiralIncrementFactor / NbCirclePoints;
+			else if (CurrentCirclePointId == NbCirclePoints) CurrentSpiralIncrementFactor += Config.SpiralIncrementFactor;
+
+			// Can be translated as "if the current intermediate point is equal or is greater than the selected circle point"
+			if (CurrentSpiralIncrementFactor >= NbCirclePoints
+				|| IsOutOfBounds(IntermediatePoint))
+			{
+				// Go back at the center of the circle
+				MoveDirection = CurrentCircleCenter - CalculatedPosition;
+				CurrentDestination = CurrentCircleCenter;
+				Wander = Config.WanderSteps + 1;
+			}
+			else
+			{
+				MoveDirection = IntermediatePoint - CalculatedPosition;
+				CurrentDestination = IntermediatePoint;
+			}
+
+			MoveDirection.Normalize();
+		}
+	}
+
+
+	/**
+	 * Set a circle with the Drone's location as the center for spiral movement.
+	 */
+	void FSimDroneSpiral::SetCircle()
+	{
+		CirclePoints.clear();
+
+		const float AngleStep = 2.0f * 3.14159265358979323846f / Config.NbCirclePoints;
+
+		for (int i = 0; i < Config.NbCirclePoints; ++i)
+		{
+			const float Angle = i * AngleStep;
+			const FSimVec3 Point(
+				Config.SpiralRadius * std::cos(Angle),
+				Config.SpiralRadius * std::sin(Angle),
+				0);
+			CirclePoints.push_back(Point + CalculatedPosition);
+		}
+
+		CurrentCircleCenter = CalculatedPosition;
+		CurrentSpiralIncrementFactor = 1;
+	}
+
+
+	/**
+	 * Calculate a random destination for the Drone, effectively making it wander.
+	 */
+	void FSimDroneSpiral::GetRandomDirection()
+	{
+		do
+		{
+			const FSimVec3 NewMoveDirection = FSimVec3(
+				MoveDirection.X + Random.RandRange(-1.0f, 1.0f),
+				MoveDirection.Y + Random.RandRange(-1.0f, 1.0f),
+				0);
+			const double Magnitude = NewMoveDirection.Size();
+			if (Magnitude > SimSmallNumber) MoveDirection = NewMoveDirection / Magnitude;
+			else MoveDirection = NewMoveDirection;
+			CurrentDestination = CalculatedPosition + MoveDirection * Config.WanderDistance;
+		}
+		while (IsOutOfBounds(CurrentDestination));
+	}
+}
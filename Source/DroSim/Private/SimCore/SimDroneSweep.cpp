@@ -0,0 +1,54 @@
+#include "SimCore/SimDroneSweep.h"
+
+namespace DroSimCore
+{
+	/**
+	 * Sends the drone to the bottom left corner of its zone, where the sweep starts.
+	 */
+	void FSimDroneSweep::Start()
+	{
+		if (AssignedZone.BottomRight.X + AssignedZone.TopLeft.Y != 0)
+			SetDestinationManual(FSimVec3(AssignedZone.BottomRight.X, AssignedZone.TopLeft.Y, Config.GroundOffset));
+		SweepLength = AssignedZone.BottomRight.Y - AssignedZone.TopLeft.Y;
+		LeftYBound = AssignedZone.TopLeft.Y;
+	}
+
+
+	/**
+	 * Set a new destination point for the Drone to move towards.
+	 *
+	 * This one alternates between going vertically or horizontally based on the current position of the Drone.
+	 */
+	void FSimDroneSweep::SetNewDestination()
+	{
+		const float MovementDistance = Config.MovementDistance;
+
+		if (GoesUp && CalculatedPosition.X >= Config.SweepHeight * HeightCount)
+		{
+			if (LeftToRight) MoveDirection = FSimVec3(0, 1.0, 0);
+			else MoveDirection = FSimVec3(0, -1.0, 0);
+			GoesUp = false;
+			LeftToRight = !LeftToRight;
+		}
+		else if (CalculatedPosition.Y - MovementDistance < LeftYBound
+			|| CalculatedPosition.Y + MovementDistance > SweepLength + LeftYBound)
+		{
+			if (TopToBottom) MoveDirection = FSimVec3(-1.0, 0, 0);
+			else MoveDirection = FSimVec3(1.0, 0, 0);
+			if (!GoesUp) HeightCount++;
+			GoesUp = true;
+		}
+
+		CurrentDestination = CalculatedPosition + MoveDirection * MovementDistance;
+		if (IsOutOfBounds(CurrentDestination))
+		{
+			if (GoesUp)
+			{
+				CurrentDestination = CalculatedPosition - MoveDirection * MovementDistance;
+				TopToBottom = !TopToBottom;
+			}
+			else if (LeftToRight) CurrentDestination = CalculatedPosition + MoveDirection * (AssignedZone.BottomRight.Y - CalculatedPosition.Y);
+			else CurrentDestination = CalculatedPosition + MoveDirection * (CalculatedPosition.Y - AssignedZone.TopLeft.Y);
+		}
+	}
+}
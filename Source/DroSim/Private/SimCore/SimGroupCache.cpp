@@ -0,0 +1,126 @@
+#include "SimCore/SimGroupCache.h"
+
+#include <filesystem>
+#include <fstream>
+#include <iterator>
+
+#include "SimCore/SimCheckpoint.h"
+
+namespace DroSimCore
+{
+	namespace SimGroupCache
+	{
+		constexpr uint32_t Version = 4;
+	}
+
+
+	/**
+	 * Uses a cache directory, created if needed.
+	 */
+	bool FSimGroupCache::Open(const std::string& InDirectory, std::string& OutError)
+	{
+		std::error_code Error;
+		std::filesystem::create_directories(InDirectory, Error);
+		if (Error)
+		{
+			OutError = "Cannot create " + InDirectory + " : " + Error.message();
+			return false;
+		}
+		Directory = InDirectory;
+		return true;
+	}
+
+
+	/**
+	 * Everything the outcome of a group depends on.
+	 *
+	 * The group's simulation IDs start at FirstSimulationID, or at 0 with common random numbers. The maximum
+	 * time of a simulation and the battery count stand for the battery settings, worker threads do not change outcomes.
+	 */
+	std::vector<uint8_t> FSimGroupCache::MakeKey(const FSimConfig& Config, const FSimGroupParams& Params, const uint32_t Seed,
+		const uint64_t FirstSimulationID)
+	{
+		FSimConfig c = Config;
+		FSimGroupParams p = Params;
+		uint32_t Version = SimGroupCache::Version;
+		uint32_t KeySeed = Seed;
+		uint64_t BaseSimulationID = Config.CommonRandomNumbers ? 0 : FirstSimulationID;
+
+		std::vector<uint8_t> Key;
+		FSimArchive Ar(Key, false);
+		Ar << Version << KeySeed << BaseSimulationID << p.Speed << p.NumDrones << p.MaxTimePerSim << p.BatteryCount;
+		Ar << c.Step << c.EnvSize << c.EnvMaxColumns << c.Partition << c.SimGroupSize << c.CommonRandomNumbers << c.EarlyStopping
+			<< c.SprtAlpha << c.SprtBeta << c.SprtIndifference << c.CoverageEarlyStop << c.CoverageStallTime;
+		Ar << c.EnergyModel << c.HoverPower << c.TurnEnergy;
+		Ar << c.Strategy << c.GroundOffset << c.MovementTolerance << c.MovementDistance << c.VisionRadius;
+		Ar << c.NbCirclePoints << c.SpiralRadius << c.WanderDistance << c.WanderSteps << c.SpiralIncrementFactor << c.DrawsConcentricCircles;
+		Ar << c.SweepHeight << c.UsesSweepOracle;
+		Ar << c.ObjectiveIsMoving << c.ObjectiveSpeed << c.ObjectiveMinDistanceRatio << c.ObjectiveCollisionCheckRadius << c.ObjectiveCount
+			<< c.Completion << c.CompletionCount;
+		return Key;
+	}
+
+
+	std::string FSimGroupCache::GetEntryPath(const std::vector<uint8_t>& Key) const
+	{
+		const std::string Name = SimPrintf("%016llx", (unsigned long long)HashBytes(Key.data(), Key.size()));
+		return Directory + "/" + Name.substr(0, 2) + "/" + Name + ".grp";
+	}
+
+
+	/**
+	 * Looks the outcome of a group up.
+	 *
+	 * @returns False if the group was never run with these settings, or its entry cannot be read.
+	 */
+	bool FSimGroupCache::Find(const FSimConfig& Config, const FSimGroupParams& Params, const uint32_t Seed,
+		const uint64_t FirstSimulationID, FSimGroupOutcome& OutOutcome)
+	{
+		const std::vector<uint8_t> Key = MakeKey(Config, Params, Seed, FirstSimulationID);
+		std::ifstream File(GetEntryPath(Key), std::ios::binary);
+		if (!File)
+		{
+			Misses++;
+			return false;
+		}
+		std::vector<uint8_t> Data((std::istreambuf_iterator<char>(File)), std::istreambuf_iterator<char>());
+
+		// Entry: key, then outcome
+		std::vector<uint8_t> EntryKey;
+		FSimGroupOutcome Outcome;
+		FSimArchive Ar(Data, true);
+		Ar << EntryKey << Outcome.RunSims << Outcome.SuccessfulSims << Outcome.SummedTimesToFind << Outcome.SummedConsumptions << Outcome.IsSuccessful
+			<< Outcome.FirstSimulationID << Outcome.Outcomes;
+		if (!Ar.IsAtEnd() || EntryKey != Key)
+		{
+			Misses++;
+			return false;
+		}
+
+		Hits++;
+		OutOutcome = std::move(Outcome);
+		return true;
+	}
+
+
+	/**
+	 * Stores the outcome of a group that was just run. A failure to write only loses the entry.
+	 */
+	void FSimGroupCache::Add(const FSimConfig& Config, const FSimGroupParams& Params, const uint32_t Seed,
+		const uint64_t FirstSimulationID, const FSimGroupOutcome& Outcome)
+	{
+		std::vector<uint8_t> Key = MakeKey(Config, Params, Seed, FirstSimulationID);
+		const std::string Path = GetEntryPath(Key);
+		std::error_code Error;
+		std::filesystem::create_directories(std::filesystem::path(Path).parent_path(), Error);
+
+		FSimGroupOutcome Entry = Outcome;
+		std::vector<uint8_t> Data;
+		FSimArchive Ar(Data, false);
+		Ar << Key << Entry.RunSims << Entry.SuccessfulSims << Entry.SummedTimesToFind << Entry.SummedConsumptions << Entry.IsSuccessful
+			<< Entry.FirstSimulationID << Entry.Outcomes;
+
+		std::string WriteError;
+		WriteFileAtomically(Path, Data, WriteError);
+	}
+}
@@ -0,0 +1,113 @@
+#include "SimCore/SimLinearSearch.h"
+
+namespace DroSimCore
+{
+	FSimLinearSearch::FSimLinearSearch(const FSimConfig& InConfig)
+		: FSimSearch(InConfig)
+		, GroupSpeed(InConfig.MinSpeed)
+		, GroupNumDrones(InConfig.MinNumDrones)
+		, GroupBatteryCount(InConfig.MinBatteryCount)
+	{
+	}
+
+
+	/**
+	 * Parameters of the group of simulations to run next.
+	 */
+	FSimGroupParams FSimLinearSearch::GetGroupParams() const
+	{
+		return MakeGroupParams(GroupSpeed, GroupNumDrones);
+	}
+
+
+	/**
+	 * Feeds the outcome of the current group to the search and moves on to the next group.
+	 */
+	void FSimLinearSearch::ReportGroup(const FSimGroupOutcome& GroupOutcome)
+	{
+		MutateSimulationParameters(GroupOutcome.IsSuccessful, GroupOutcome);
+	}
+
+
+	/**
+	 * Saves or loads the state of the search between two groups.
+	 */
+	void FSimLinearSearch::Serialize(FSimArchive& Ar)
+	{
+		FSimSearch::Serialize(Ar);
+		Ar << GroupSpeed << GroupNumDrones << GroupBatteryCount << IsCurveFound << IsMaxFound << PreviousSpeed << PreviousBatteryCount;
+	}
+
+
+	/**
+	 * Mutates configuration of the current group of simulations, based on the outcome it gave.
+	 *
+	 * @param IsGroupSuccessful True if the current group configuration is successful, false otherwise.
+	 * @param GroupOutcome Successes and times to find of the current group.
+	 */
+	void FSimLinearSearch::MutateSimulationParameters(const bool IsGroupSuccessful, const FSimGroupOutcome& GroupOutcome)
+	{
+		const int BatteryCount = LogGroupOutcome(IsGroupSuccessful, GroupOutcome);
+		if (IsGroupSuccessful) GroupBatteryCount = BatteryCount;
+
+		if (!IsCurveFound || IsGroupSuccessful)
+		{
+			// We overwrite the saved config as we don't need it right now
+			PreviousSpeed = GroupSpeed;
+			PreviousBatteryCount = GroupBatteryCount;
+		}
+
+		if (IsCurveFound && IsMaxFound)
+		{
+			if (IsGroupSuccessful && GroupSpeed - Config.SpeedIncrement >= Config.MinSpeed) GroupSpeed -= Config.SpeedIncrement;
+			else
+			{
+				Results.SlowConfigs.push_back({
+					PreviousSpeed,
+					GroupNumDrones,
+					PreviousBatteryCount,
+					Config.DroneWeight(PreviousBatteryCount)});
+
+				GroupNumDrones += Config.DroneIncrement;
+
+				// We save the current config for later comparison
+				PreviousSpeed = GroupSpeed;
+				PreviousBatteryCount = GroupBatteryCount;
+			}
+		}
+		else
+		{
+			if (!IsCurveFound && IsGroupSuccessful)
+			{
+				// Found the first valid configuration
+				Results.SlowConfigs.push_back({
+					GroupSpeed,
+					GroupNumDrones,
+					GroupBatteryCount,
+					Config.DroneWeight(GroupBatteryCount)});
+				IsCurveFound = true;
+				Log("Curve found");
+			}
+			if (GroupSpeed + Config.SpeedIncrement <= Config.MaxSpeed)
+				GroupSpeed += Config.SpeedIncrement;
+			else if (IsCurveFound)
+			{
+				// Found the maximum speed drones need to go at
+				Results.HasFastConfig = true;
+				Results.FastConfig = {GroupSpeed, 0, GroupBatteryCount, Config.DroneWeight(GroupBatteryCount)};
+				IsMaxFound = true;
+				Log("Max speed found");
+				GroupNumDrones += Config.DroneIncrement;
+				GroupSpeed -= Config.SpeedIncrement;
+			}
+			else
+			{
+				GroupNumDrones += Config.DroneIncrement;
+				GroupSpeed = Config.MinSpeed;
+			}
+		}
+
+		Log("----------------------------");
+		PrintSimConfigRecap();
+	}
+}
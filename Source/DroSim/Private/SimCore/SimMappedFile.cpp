@@ -0,0 +1,100 @@
+#include "SimCore/SimMappedFile.h"
+
+#if defined(_WIN32)
+#if defined(WITH_ENGINE)
+#include "Windows/WindowsHWrapper.h"
+#else
+#define WIN32_LEAN_AND_MEAN
+#define NOMINMAX
+#include <windows.h>
+#endif
+#else
+#include <fcntl.h>
+#include <sys/mman.h>
+#include <sys/stat.h>
+#include <unistd.h>
+#endif
+
+namespace DroSimCore
+{
+	FSimMappedFile::~FSimMappedFile()
+	{
+		Close();
+	}
+
+
+	/**
+	 * Maps a file in memory, read-only.
+	 */
+	bool FSimMappedFile::Open(const std::string& Path, std::string& OutError)
+	{
+		Close();
+		OutError = "Cannot map " + Path;
+
+#if defined(_WIN32)
+		const HANDLE File = CreateFileA(Path.c_str(), GENERIC_READ, FILE_SHARE_READ, nullptr, OPEN_EXISTING, FILE_ATTRIBUTE_NORMAL, nullptr);
+		if (File == INVALID_HANDLE_VALUE) return false;
+		FileHandle = File;
+
+		LARGE_INTEGER FileSize;
+		if (!GetFileSizeEx(File, &FileSize) || FileSize.QuadPart == 0)
+		{
+			Close();
+			return false;
+		}
+		Size = (size_t)FileSize.QuadPart;
+
+		const HANDLE Mapping = CreateFileMappingA(File, nullptr, PAGE_READONLY, 0, 0, nullptr);
+		if (!Mapping)
+		{
+			Close();
+			return false;
+		}
+		MappingHandle = Mapping;
+
+		Data = (const uint8_t*)MapViewOfFile(Mapping, FILE_MAP_READ, 0, 0, 0);
+#else
+		const int File = open(Path.c_str(), O_RDONLY);
+		if (File < 0) return false;
+
+		struct stat FileStat;
+		if (fstat(File, &FileStat) != 0 || FileStat.st_size == 0)
+		{
+			close(File);
+			return false;
+		}
+		Size = (size_t)FileStat.st_size;
+
+		void* Mapping = mmap(nullptr, Size, PROT_READ, MAP_PRIVATE, File, 0);
+		close(File);
+		Data = Mapping != MAP_FAILED ? (const uint8_t*)Mapping : nullptr;
+#endif
+
+		if (!Data)
+		{
+			Close();
+			return false;
+		}
+		OutError.clear();
+		return true;
+	}
+
+
+	/**
+	 * Unmaps the file.
+	 */
+	void FSimMappedFile::Close()
+	{
+#if defined(_WIN32)
+		if (Data) UnmapViewOfFile(Data);
+		if (MappingHandle) CloseHandle((HANDLE)MappingHandle);
+		if (FileHandle) CloseHandle((HANDLE)FileHandle);
+#else
+		if (Data) munmap((void*)Data, Size);
+#endif
+		Data = nullptr;
+		Size = 0;
+		FileHandle = nullptr;
+		MappingHandle = nullptr;
+	}
+}
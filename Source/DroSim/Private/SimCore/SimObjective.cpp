@@ -0,0 +1,26 @@
+#include "SimCore/SimObjective.h"
+
+namespace DroSimCore
+{
+	FSimObjective::FSimObjective(const FSimConfig& InConfig, const FSimVec3& SpawnPoint)
+		: Config(InConfig)
+		, Position(SpawnPoint.X, SpawnPoint.Y, SimObjectiveAltitude)
+	{
+	}
+
+
+	/**
+	 * Advances the objective by one substep of Config.Step simulated seconds.
+	 *
+	 * The objective turns around instead of moving when it would leave the environment.
+	 */
+	void FSimObjective::Step()
+	{
+		if (!Config.ObjectiveIsMoving) return;
+
+		const FSimVec3 NextLocation = Position + MoveDirection * Config.ObjectiveSpeed * Config.Step;
+
+		if (NextLocation.Y >= 0 && NextLocation.Y <= Config.EnvSize.Y) Position = NextLocation;
+		else MoveDirection.Y = -MoveDirection.Y;
+	}
+}
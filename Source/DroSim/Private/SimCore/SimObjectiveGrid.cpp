@@ -0,0 +1,75 @@
+#include "SimCore/SimObjectiveGrid.h"
+
+#include <cmath>
+
+namespace DroSimCore
+{
+	namespace SimObjectiveGrid
+	{
+		// Bounds the memory of the grid when the vision radius is small compared to the environment
+		constexpr int MaxCellsPerAxis = 256;
+	}
+
+
+	/**
+	 * Sizes the cells after the vision radius, a query then covers a few cells around the move of a drone.
+	 */
+	void FSimObjectiveGrid::Reset(const FSimConfig& Config)
+	{
+		const double CellSize = std::max((double)Config.VisionRadius,
+			std::max(Config.EnvSize.X, Config.EnvSize.Y) / SimObjectiveGrid::MaxCellsPerAxis);
+		InverseCellSize = 1 / CellSize;
+		Columns = std::max(1, (int)std::ceil(Config.EnvSize.X / CellSize));
+		Rows = std::max(1, (int)std::ceil(Config.EnvSize.Y / CellSize));
+		Slack = CellSize / 2;
+		Drift = 0;
+		bIsBuilt = false;
+	}
+
+
+	/**
+	 * Keeps the grid valid for the coming substep, to be called before objectives move.
+	 *
+	 * @param Positions Current positions of the objectives.
+	 * @param IsFound Objectives left out of the grid when it is rebuilt, the caller still has to skip them.
+	 * @param StepDistance Distance an objective can move over the substep.
+	 */
+	void FSimObjectiveGrid::Refit(const std::vector<FSimVec3>& Positions, const std::vector<uint8_t>& IsFound, const double StepDistance)
+	{
+		if (!bIsBuilt || Drift + StepDistance > Slack) Build(Positions, IsFound);
+		Drift += StepDistance;
+	}
+
+
+	/**
+	 * Indexes the objectives not found yet at their current positions, with a counting sort by cell.
+	 */
+	void FSimObjectiveGrid::Build(const std::vector<FSimVec3>& Positions, const std::vector<uint8_t>& IsFound)
+	{
+		CellStarts.assign((size_t)Columns * Rows + 1, 0);
+		ItemCells.resize(Positions.size());
+		int Count = 0;
+		for (size_t i = 0; i < Positions.size(); i++)
+		{
+			if (IsFound[i])
+			{
+				ItemCells[i] = -1;
+				continue;
+			}
+			ItemCells[i] = GetCellY(Positions[i].Y) * Columns + GetCellX(Positions[i].X);
+			CellStarts[ItemCells[i] + 1]++;
+			Count++;
+		}
+		for (size_t c = 1; c < CellStarts.size(); c++) CellStarts[c] += CellStarts[c - 1];
+
+		// Fills each cell from its start, CellStarts[c] ends up at the start of cell c + 1 and is shifted back after
+		Items.resize(Count);
+		for (size_t i = 0; i < Positions.size(); i++)
+			if (ItemCells[i] >= 0) Items[CellStarts[ItemCells[i]]++] = (int)i;
+		for (size_t c = CellStarts.size() - 1; c > 0; c--) CellStarts[c] = CellStarts[c - 1];
+		CellStarts[0] = 0;
+
+		Drift = 0;
+		bIsBuilt = true;
+	}
+}
@@ -0,0 +1,298 @@
+#include "SimCore/SimOracle.h"
+
+#include <algorithm>
+#include <cmath>
+
+#include "SimCore/SimDetection.h"
+#include "SimCore/SimZones.h"
+
+namespace DroSimCore
+{
+	namespace SimOracle
+	{
+		double Dot(const FSimVec3& A, const FSimVec3& B)
+		{
+			return A.X * B.X + A.Y * B.Y + A.Z * B.Z;
+		}
+
+
+		/** Squared distance to the destination after Steps substeps along a leg. */
+		double DistanceAfter(const FSimVec3& Start, const FSimVec3& Move, const FSimVec3& Destination, const int64_t Steps)
+		{
+			return FSimVec3::DistSquared(Start + Move * (double)Steps, Destination);
+		}
+
+
+		/** Whether a drone Steps substeps into a leg would not get any closer to its destination by moving on. */
+		bool StopsGettingCloser(const FSimVec3& Start, const FSimVec3& Move, const FSimVec3& Destination, const int64_t Steps)
+		{
+			return DistanceAfter(Start, Move, Destination, Steps + 1) >= DistanceAfter(Start, Move, Destination, Steps);
+		}
+
+
+		/**
+		 * First substep of a leg from which moving on does not bring the drone closer to its destination, at most MaxSteps.
+		 *
+		 * The squared distance is a quadratic of the number of substeps: its minimum gives the substep, checked
+		 * against the actual distances around it.
+		 */
+		int64_t FindClosestStep(const FSimVec3& Start, const FSimVec3& Move, const FSimVec3& Destination, const int64_t MaxSteps)
+		{
+			const double MoveSquared = Move.SizeSquared();
+			if (MoveSquared <= 0) return 0;
+
+			const double Estimate = std::ceil(Dot(Destination - Start, Move) / MoveSquared - 0.5);
+			int64_t Steps = (int64_t)std::clamp(Estimate, 0.0, (double)MaxSteps);
+			while (Steps > 0 && StopsGettingCloser(Start, Move, Destination, Steps - 1)) Steps--;
+			while (Steps < MaxSteps && !StopsGettingCloser(Start, Move, Destination, Steps)) Steps++;
+			return Steps;
+		}
+
+
+		/**
+		 * First substep of a leg at which the drone is within tolerance of its destination, knowing that it is at
+		 * ClosestStep, where the distance is the smallest.
+		 */
+		int64_t FindArrivalStep(const FSimVec3& Start, const FSimVec3& Move, const FSimVec3& Destination, const double ToleranceSquared,
+			const int64_t ClosestStep)
+		{
+			const double MoveSquared = Move.SizeSquared();
+			int64_t Steps = ClosestStep;
+			if (MoveSquared > 0)
+			{
+				// Smaller root of |Start + k * Move - Destination|^2 = Tolerance^2
+				const FSimVec3 ToDestination = Destination - Start;
+				const double B = Dot(ToDestination, Move);
+				const double Discriminant = std::max(0.0, B * B - MoveSquared * (ToDestination.SizeSquared() - ToleranceSquared));
+				Steps = (int64_t)std::clamp(std::ceil((B - std::sqrt(Discriminant)) / MoveSquared), 0.0, (double)ClosestStep);
+			}
+			while (Steps > 0 && DistanceAfter(Start, Move, Destination, Steps - 1) <= ToleranceSquared) Steps--;
+			while (Steps < ClosestStep && DistanceAfter(Start, Move, Destination, Steps) > ToleranceSquared) Steps++;
+			return Steps;
+		}
+
+
+		/**
+		 * Simulated time at the start of a substep, as FSimulation keeps it: a float incremented by Step.
+		 *
+		 * Exact when Step is a whole number, accumulated otherwise so that the rounding is the same.
+		 */
+		float SimulatedTimeAt(const int64_t Steps, const float Step)
+		{
+			if (Step == std::floor(Step) && Steps < (1 << 24)) return (float)Steps * Step;
+
+			float Time = 0;
+			for (int64_t i = 0; i < Steps; i++) Time += Step;
+			return Time;
+		}
+
+
+		/** Number of moves of DeltaY in a row the objective makes from Y before it has to turn around, at most MaxMoves. */
+		int64_t CountMovesWithin(const double Y, const double DeltaY, const double EnvSizeY, const int64_t MaxMoves)
+		{
+			const auto IsInside = [&](const int64_t Moves)
+			{
+				const double NextY = Y + DeltaY * (double)Moves;
+				return NextY >= 0 && NextY <= EnvSizeY;
+			};
+
+			const double Estimate = std::floor((DeltaY > 0 ? EnvSizeY - Y : Y) / std::abs(DeltaY));
+			int64_t Moves = (int64_t)std::clamp(Estimate, 0.0, (double)MaxMoves);
+			while (Moves > 0 && !IsInside(Moves)) Moves--;
+			while (Moves < MaxMoves && IsInside(Moves + 1)) Moves++;
+			return Moves;
+		}
+	}
+
+
+	FSimVec3 FSimSweepOracle::FSegment::GetPositionAt(const int64_t Step) const
+	{
+		if (Step >= GetEndStep()) return End;
+		return Start + (End - Start) * ((double)(Step - FirstStep) / (double)NumSteps);
+	}
+
+
+	/**
+	 * Places the objective and the drones exactly as FSimulation does for the same seed and simulation ID.
+	 */
+	FSimSweepOracle::FSimSweepOracle(const FSimConfig& InConfig, const FSimGroupParams& InParams, const uint64_t Seed, const uint64_t InSimulationID)
+		: Config(InConfig)
+		, Params(InParams)
+		, SimulationID(InSimulationID)
+	{
+		// FSimulation::Step runs every substep that starts before the maximum time
+		NumSteps = (int64_t)std::ceil(Params.MaxTimePerSim / Config.Step);
+		while (NumSteps > 0 && SimOracle::SimulatedTimeAt(NumSteps - 1, Config.Step) >= Params.MaxTimePerSim) NumSteps--;
+		while (SimOracle::SimulatedTimeAt(NumSteps, Config.Step) < Params.MaxTimePerSim) NumSteps++;
+
+		BuildObjectivePath(FSimulation::DrawObjectiveSpawnPoint(Config, Seed, SimulationID));
+
+		const std::vector<FSimZone>& Zones = FSimZoneCache::Shared().Get(Config, Params.NumDrones);
+		Drones.reserve(Params.NumDrones);
+		for (int i = 0; i < Params.NumDrones; i++)
+		{
+			Drones.push_back(MakeSimDrone(ESimStrategy::Sweep, Config, i + 1, Zones[i], Params.Speed, FSimRandom::ForStream(Seed, SimulationID, i + 1)));
+			Drones.back()->Start();
+		}
+	}
+
+
+	/**
+	 * Path of the objective over the whole simulation: runs along Y, then one substep in place every time it turns
+	 * around, see FSimObjective::Step.
+	 */
+	void FSimSweepOracle::BuildObjectivePath(const FSimVec3& SpawnPoint)
+	{
+		ObjectivePath.clear();
+		const double Distance = (double)Config.ObjectiveSpeed * Config.Step;
+		if (!Config.ObjectiveIsMoving || Distance == 0)
+		{
+			ObjectivePath.push_back({0, NumSteps, SpawnPoint, SpawnPoint});
+			return;
+		}
+
+		FSimVec3 Position = SpawnPoint;
+		FSimVec3 MoveDirection(0, 1.0, 0);
+		for (int64_t Step = 0; Step < NumSteps; MoveDirection.Y = -MoveDirection.Y)
+		{
+			const FSimVec3 Move = MoveDirection * Config.ObjectiveSpeed * Config.Step;
+			const int64_t Moves = SimOracle::CountMovesWithin(Position.Y, Move.Y, Config.EnvSize.Y, NumSteps - Step);
+			if (Moves > 0)
+			{
+				ObjectivePath.push_back({Step, Moves, Position, Position + Move * (double)Moves});
+				Position = ObjectivePath.back().End;
+				Step += Moves;
+			}
+			if (Step < NumSteps) ObjectivePath.push_back({Step++, 1, Position, Position});
+		}
+	}
+
+
+	/**
+	 * Flies the next leg of a drone, testing its pieces against the path of the objective.
+	 *
+	 * A leg is flown in a straight line until the substep at which the drone is within tolerance of its
+	 * destination, or would stop getting closer to it, in which case it snaps to it and takes one more substep to
+	 * notice the arrival. Either way the arrival substep is flown along the old direction.
+	 *
+	 * @param InOutContactStep Earliest contact found so far, in substeps, lowered if this drone sees the objective before.
+	 * @returns True if the drone saw the objective before InOutContactStep.
+	 */
+	bool FSimSweepOracle::FlyLeg(FDroneFlight& Flight, double& InOutContactStep) const
+	{
+		FSimDrone& Drone = *Drones[Flight.Drone];
+		const FSimVec3& Start = Flight.Position;
+		const int64_t Step = Flight.Step;
+		const FSimVec3 Destination = Drone.GetDestination();
+		const FSimVec3 Move = Drone.GetMoveDirection() * Params.Speed * Config.Step;
+		const double ToleranceSquared = (double)Config.MovementTolerance * Config.MovementTolerance;
+		const int64_t ClosestStep = SimOracle::FindClosestStep(Start, Move, Destination, NumSteps - Step);
+
+		FSegment Pieces[3];
+		int NumPieces = 0;
+		if (SimOracle::DistanceAfter(Start, Move, Destination, ClosestStep) <= ToleranceSquared)
+		{
+			// Within tolerance: the arrival substep moves on along the leg
+			const int64_t ArrivalStep = SimOracle::FindArrivalStep(Start, Move, Destination, ToleranceSquared, ClosestStep);
+			Pieces[NumPieces++] = {Step, ArrivalStep + 1, Start, Start + Move * (double)(ArrivalStep + 1)};
+		}
+		else
+		{
+			if (ClosestStep > 0) Pieces[NumPieces++] = {Step, ClosestStep, Start, Start + Move * (double)ClosestStep};
+
+			// Snaps to the destination, then notices the arrival on the next substep
+			const int64_t SnapStep = Step + ClosestStep;
+			if (SnapStep < NumSteps)
+			{
+				Pieces[NumPieces++] = {SnapStep, 1, Start + Move * (double)ClosestStep, Destination};
+				Pieces[NumPieces++] = {SnapStep + 1, 1, Destination, Destination + Move};
+			}
+		}
+
+		Flight.Position = Pieces[NumPieces - 1].End;
+		Flight.Step = Pieces[NumPieces - 1].GetEndStep();
+		Drone.SkipToDestination();
+
+		for (int i = 0; i < NumPieces; i++)
+		{
+			double ContactStep;
+			if (!FindSegmentContact(Pieces[i], Flight.ObjectiveSegment, ContactStep)) continue;
+			if (ContactStep >= InOutContactStep) return false;
+			InOutContactStep = ContactStep;
+			return true;
+		}
+		return false;
+	}
+
+
+	/**
+	 * Tests a linear piece of the path of a drone against the pieces of the path of the objective it overlaps.
+	 *
+	 * @param InOutObjectiveSegment First piece of the objective path that can overlap, moved forward as drone pieces come in order.
+	 * @param OutContactStep Moment of the first contact, in substeps since the start of the simulation.
+	 */
+	bool FSimSweepOracle::FindSegmentContact(const FSegment& DroneSegment, size_t& InOutObjectiveSegment, double& OutContactStep) const
+	{
+		for (; InOutObjectiveSegment < ObjectivePath.size(); InOutObjectiveSegment++)
+		{
+			const FSegment& ObjectiveSegment = ObjectivePath[InOutObjectiveSegment];
+			const int64_t First = std::max(DroneSegment.FirstStep, ObjectiveSegment.FirstStep);
+			const int64_t Last = std::min(DroneSegment.GetEndStep(), ObjectiveSegment.GetEndStep());
+
+			double Alpha;
+			if (First < Last && FindFirstContact(DroneSegment.GetPositionAt(First), DroneSegment.GetPositionAt(Last),
+				ObjectiveSegment.GetPositionAt(First), ObjectiveSegment.GetPositionAt(Last), Config.VisionRadius, Alpha))
+			{
+				OutContactStep = First + Alpha * (double)(Last - First);
+				return true;
+			}
+
+			// The objective piece goes on over the next drone piece
+			if (ObjectiveSegment.GetEndStep() > DroneSegment.GetEndStep()) return false;
+		}
+		return false;
+	}
+
+
+	/**
+	 * Earliest contact of any drone with the objective. To be called once.
+	 */
+	FSimOutcome FSimSweepOracle::Run()
+	{
+		std::vector<FDroneFlight> Flights(Drones.size());
+		for (size_t i = 0; i < Drones.size(); i++)
+		{
+			Flights[i].Drone = (int)i;
+			Flights[i].Position = Drones[i]->GetPosition();
+		}
+
+		// Legs are flown in time order across the drones, so that none flies past the earliest contact found so far
+		const auto IsLater = [](const FDroneFlight& A, const FDroneFlight& B) { return A.Step > B.Step; };
+		std::make_heap(Flights.begin(), Flights.end(), IsLater);
+
+		double ContactStep = (double)NumSteps + 1;
+		bool HasContact = false;
+		while (!Flights.empty() && Flights.front().Step < NumSteps && Flights.front().Step < ContactStep)
+		{
+			std::pop_heap(Flights.begin(), Flights.end(), IsLater);
+			if (FlyLeg(Flights.back(), ContactStep)) HasContact = true;
+			std::push_heap(Flights.begin(), Flights.end(), IsLater);
+		}
+
+		// Without the energy model, drones are charged for level flight over the whole of it
+		FSimOutcome Outcome;
+		Outcome.FlightTime = Params.MaxTimePerSim;
+		if (HasContact)
+		{
+			const double StepStart = std::floor(ContactStep);
+			const float ContactTime = (float)(SimOracle::SimulatedTimeAt((int64_t)StepStart, Config.Step) + (ContactStep - StepStart) * Config.Step);
+			if (ContactTime <= Params.MaxTimePerSim)
+			{
+				Outcome.Found = true;
+				Outcome.TimeToFind = Outcome.FlightTime = ContactTime;
+			}
+		}
+		Outcome.Consumption = (float)Config.FlightConsumption(Params.Speed, Params.BatteryCount, Outcome.FlightTime);
+		return Outcome;
+	}
+}
@@ -0,0 +1,219 @@
+#include "SimCore/SimRecords.h"
+
+#include <chrono>
+#include <filesystem>
+
+#include "SimCore/SimResults.h"
+#include "SimCore/SimSearch.h"
+
+namespace DroSimCore
+{
+	namespace SimRecords
+	{
+		const char* StrategyName(const ESimStrategy Strategy)
+		{
+			switch (Strategy)
+			{
+			case ESimStrategy::Random: return "random";
+			case ESimStrategy::Sweep: return "sweep";
+			case ESimStrategy::Spiral: return "spiral";
+			default: return "unknown";
+			}
+		}
+
+
+		bool EndsWith(const std::string& Text, const std::string& Suffix)
+		{
+			return Text.size() >= Suffix.size() && Text.compare(Text.size() - Suffix.size(), Suffix.size(), Suffix) == 0;
+		}
+	}
+
+
+	/**
+	 * Builds the record of a finished simulation.
+	 *
+	 * The battery count is the least one that would have powered the flight, -1 if none is enough,
+	 * and the consumption is the energy of the flight, in Wh, with that battery count (or the highest one).
+	 *
+	 * @param FlightTime Time to find if found, maximum time of the simulation otherwise.
+	 * @param Consumption Energy of the flight as simulated, see FSimOutcome.
+	 */
+	FSimRecord MakeSimRecord(const FSimConfig& Config, const uint64_t SimulationID, const int GroupID, const float Speed,
+		const int NumDrones, const uint32_t Seed, const bool Found, const float FlightTime, const float Consumption)
+	{
+		FSimRecord Record;
+		Record.SimulationID = SimulationID;
+		Record.GroupID = GroupID;
+		Record.Strategy = Config.Strategy;
+		Record.Speed = Speed;
+		Record.NumDrones = NumDrones;
+		Record.Seed = Seed;
+		Record.Found = Found;
+		Record.TimeToFind = Found ? FlightTime : 0;
+		Record.BatteryCount = FindMinBatteryCount(Config, Consumption, Record.Consumption);
+		return Record;
+	}
+
+
+	FSimRecordWriter::~FSimRecordWriter()
+	{
+		Close();
+	}
+
+
+	/**
+	 * Opens a records file for appending and starts the background writer.
+	 *
+	 * @param KeepBytes If not negative, the file is first cut to that size, the records written since a
+	 *                  checkpoint are then dropped before the sweep resumes.
+	 */
+	bool FSimRecordWriter::Open(const std::string& Path, std::string& OutError, const int64_t KeepBytes)
+	{
+		Close();
+
+		if (KeepBytes >= 0)
+		{
+			std::error_code Error;
+			const bool Exists = std::filesystem::exists(Path, Error);
+			if (Exists ? std::filesystem::file_size(Path, Error) < (uint64_t)KeepBytes : KeepBytes > 0)
+			{
+				OutError = Path + " is shorter than when the checkpoint was saved";
+				return false;
+			}
+			if (Exists) std::filesystem::resize_file(Path, (uint64_t)KeepBytes, Error);
+			if (Error)
+			{
+				OutError = "Cannot truncate " + Path + " : " + Error.message();
+				return false;
+			}
+		}
+
+		Format = SimRecords::EndsWith(Path, ".jsonl") ? ESimRecordFormat::Jsonl : ESimRecordFormat::Csv;
+		std::ifstream Existing(Path, std::ios::binary | std::ios::ate);
+		const bool IsNewFile = !Existing || Existing.tellg() <= 0;
+		FileSize = IsNewFile ? 0 : (uint64_t)Existing.tellg();
+		Existing.close();
+
+		File.open(Path, std::ios::binary | std::ios::app);
+		if (!File)
+		{
+			OutError = "Cannot open " + Path + " for writing";
+			return false;
+		}
+
+		if (IsNewFile && Format == ESimRecordFormat::Csv)
+			Pending = "sim_id,group,strategy,speed,drones,batteries,seed,found,time_to_find,consumption\n";
+
+		bStopping = false;
+		Flusher = std::thread([this] { FlushLoop(); });
+		return true;
+	}
+
+
+	/**
+	 * Writes the records still in memory and closes the file.
+	 */
+	void FSimRecordWriter::Close()
+	{
+		if (!Flusher.joinable()) return;
+		{
+			std::lock_guard<std::mutex> Lock(Mutex);
+			bStopping = true;
+		}
+		WakeUp.notify_one();
+		Flusher.join();
+		File.close();
+	}
+
+
+	/**
+	 * Queues the record of a finished simulation.
+	 */
+	void FSimRecordWriter::Add(const FSimRecord& Record)
+	{
+		if (!IsOpen()) return;
+		bool IsBatchFull;
+		{
+			std::lock_guard<std::mutex> Lock(Mutex);
+			Pending += FormatRecord(Record, Format);
+			IsBatchFull = Pending.size() >= FlushThreshold;
+		}
+		if (IsBatchFull) WakeUp.notify_one();
+	}
+
+
+	/**
+	 * Writes the records queued so far right away, before a checkpoint.
+	 *
+	 * @returns The size of the file once they are written.
+	 */
+	uint64_t FSimRecordWriter::Sync()
+	{
+		if (!IsOpen()) return 0;
+		std::lock_guard<std::mutex> FileLock(FileMutex);
+		std::string Batch;
+		{
+			std::lock_guard<std::mutex> Lock(Mutex);
+			Batch.swap(Pending);
+		}
+		WriteBatch(Batch);
+		return FileSize;
+	}
+
+
+	/**
+	 * Background writer: swaps the pending batch out under the lock, then writes it without holding it.
+	 */
+	void FSimRecordWriter::FlushLoop()
+	{
+		std::string Batch;
+		bool IsLastBatch = false;
+		while (!IsLastBatch)
+		{
+			{
+				std::unique_lock<std::mutex> Lock(Mutex);
+				WakeUp.wait_for(Lock, std::chrono::milliseconds(FlushIntervalMs),
+					[this] { return bStopping || Pending.size() >= FlushThreshold; });
+				IsLastBatch = bStopping;
+			}
+			std::lock_guard<std::mutex> FileLock(FileMutex);
+			{
+				std::lock_guard<std::mutex> Lock(Mutex);
+				Batch.swap(Pending);
+			}
+			WriteBatch(Batch);
+		}
+	}
+
+
+	void FSimRecordWriter::WriteBatch(std::string& Batch)
+	{
+		if (Batch.empty()) return;
+		File.write(Batch.data(), (std::streamsize)Batch.size());
+		File.flush();
+		FileSize += Batch.size();
+		Batch.clear();
+	}
+
+
+	/**
+	 * Formats a record as one CSV or JSON line.
+	 */
+	std::string FSimRecordWriter::FormatRecord(const FSimRecord& Record, const ESimRecordFormat Format)
+	{
+		const std::string BatteryCount = Record.BatteryCount >= 0 ? std::to_string(Record.BatteryCount) : "";
+
+		if (Format == ESimRecordFormat::Jsonl)
+			return SimPrintf("{\"sim_id\":%llu,\"group\":%d,\"strategy\":\"%s\",\"speed\":%g,\"drones\":%d,\"batteries\":%s,"
+				"\"seed\":%u,\"found\":%s,\"time_to_find\":%s,\"consumption\":%g}\n",
+				(unsigned long long)Record.SimulationID, Record.GroupID, SimRecords::StrategyName(Record.Strategy),
+				Record.Speed, Record.NumDrones, BatteryCount.empty() ? "null" : BatteryCount.c_str(), Record.Seed,
+				Record.Found ? "true" : "false", Record.Found ? SimPrintf("%g", Record.TimeToFind).c_str() : "null",
+				Record.Consumption);
+
+		return SimPrintf("%llu,%d,%s,%g,%d,%s,%u,%d,%s,%g\n",
+			(unsigned long long)Record.SimulationID, Record.GroupID, SimRecords::StrategyName(Record.Strategy),
+			Record.Speed, Record.NumDrones, BatteryCount.c_str(), Record.Seed, Record.Found ? 1 : 0,
+			Record.Found ? SimPrintf("%g", Record.TimeToFind).c_str() : "", Record.Consumption);
+	}
+}
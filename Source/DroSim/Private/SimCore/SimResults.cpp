@@ -0,0 +1,73 @@
+#include "SimCore/SimResults.h"
+
+#include <cstdarg>
+#include <cstdio>
+#include <fstream>
+
+namespace DroSimCore
+{
+	/**
+	 * printf-style formatting into a std::string.
+	 */
+	std::string SimPrintf(const char* Format, ...)
+	{
+		va_list Args;
+		va_start(Args, Format);
+		va_list ArgsCopy;
+		va_copy(ArgsCopy, Args);
+		const int Length = std::vsnprintf(nullptr, 0, Format, ArgsCopy);
+		va_end(ArgsCopy);
+
+		std::string Text;
+		if (Length > 0)
+		{
+			Text.resize((size_t)Length + 1);
+			std::vsnprintf(&Text[0], Text.size(), Format, Args);
+			Text.resize((size_t)Length);
+		}
+		va_end(Args);
+		return Text;
+	}
+
+
+	/**
+	 * Formats the results as results.txt lists them.
+	 */
+	std::vector<std::string> FormatResults(const FSimResults& Results)
+	{
+		std::vector<std::string> Lines;
+
+		if (Results.HasFastConfig)
+			Lines.push_back(SimPrintf("speed:%f,batteries:%d,(weight:%f)",
+				Results.FastConfig.Speed, Results.FastConfig.BatteryCount, Results.FastConfig.Weight));
+
+		Lines.push_back("---");
+
+		for (const FSimConfigResult& sc : Results.SlowConfigs)
+			Lines.push_back(SimPrintf("speed:%f,drones:%d,batteries:%d,(weight:%f)",
+				sc.Speed, sc.NumDrones, sc.BatteryCount, sc.Weight));
+
+		return Lines;
+	}
+
+
+	/**
+	 * Writes the results to a file, creating it if needed.
+	 */
+	bool WriteResultsToFile(const std::string& Path, const FSimResults& Results, std::string& OutError)
+	{
+		std::ofstream File(Path, std::ios::binary | std::ios::trunc);
+		if (!File)
+		{
+			OutError = "Cannot open " + Path + " for writing";
+			return false;
+		}
+		for (const std::string& Line : FormatResults(Results)) File << Line << '\n';
+		if (!File)
+		{
+			OutError = "Failed to write to " + Path;
+			return false;
+		}
+		return true;
+	}
+}
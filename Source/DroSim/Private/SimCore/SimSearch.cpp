@@ -0,0 +1,190 @@
+#include "SimCore/SimSearch.h"
+
+#include <algorithm>
+#include <cmath>
+
+#include "SimCore/SimBisectionSearch.h"
+#include "SimCore/SimLinearSearch.h"
+
+namespace DroSimCore
+{
+	/**
+	 * If >50% of simulations result in a success, the configuration is successful.
+	 */
+	bool IsGroupSuccessful(const int SuccessfulSims, const int SimGroupSize)
+	{
+		if (SimGroupSize == 1) return SuccessfulSims == 1;
+		return SuccessfulSims >= SimGroupSize / 2;
+	}
+
+
+	/**
+	 * Decides whether a group can stop after its first RunSims replicas, following Config.EarlyStopping.
+	 *
+	 * "settled" stops once the majority vote of IsGroupSuccessful cannot change anymore. "sprt" runs a
+	 * Wald sequential probability ratio test of a success rate of threshold - sprt_indifference against
+	 * threshold + sprt_indifference, with sprt_alpha and sprt_beta error rates, and falls back to the
+	 * majority vote when the group is complete.
+	 *
+	 * @returns Undecided while more replicas are needed, the verdict of the group otherwise.
+	 */
+	ESimGroupVerdict EvaluateGroup(const FSimConfig& Config, const int RunSims, const int SuccessfulSims)
+	{
+		const int GroupSize = Config.SimGroupSize;
+		if (RunSims >= GroupSize)
+			return IsGroupSuccessful(SuccessfulSims, GroupSize) ? ESimGroupVerdict::Success : ESimGroupVerdict::Fail;
+		if (Config.EarlyStopping == ESimEarlyStopping::None || RunSims <= 0) return ESimGroupVerdict::Undecided;
+
+		// Least number of successes making the group successful
+		const int RequiredSims = GroupSize == 1 ? 1 : GroupSize / 2;
+		if (SuccessfulSims >= RequiredSims) return ESimGroupVerdict::Success;
+		if (SuccessfulSims + GroupSize - RunSims < RequiredSims) return ESimGroupVerdict::Fail;
+		if (Config.EarlyStopping != ESimEarlyStopping::Sprt) return ESimGroupVerdict::Undecided;
+
+		const double Threshold = (double)RequiredSims / GroupSize;
+		const double P0 = std::max(Threshold - Config.SprtIndifference, 1e-3);
+		const double P1 = std::min(Threshold + Config.SprtIndifference, 1 - 1e-3);
+		const double LogLikelihoodRatio = SuccessfulSims * std::log(P1 / P0)
+			+ (RunSims - SuccessfulSims) * std::log((1 - P1) / (1 - P0));
+
+		if (LogLikelihoodRatio >= std::log((1 - Config.SprtBeta) / Config.SprtAlpha)) return ESimGroupVerdict::Success;
+		if (LogLikelihoodRatio <= std::log(Config.SprtBeta / (1 - Config.SprtAlpha))) return ESimGroupVerdict::Fail;
+		return ESimGroupVerdict::Undecided;
+	}
+
+
+	/**
+	 * Finds the least battery count able to power a flight that consumed the given energy.
+	 *
+	 * Groups fly with max_battery_count batteries (see FSimSearch::MakeGroupParams), the lighter configurations
+	 * are not simulated. They do not need to be: every power of the model is proportional to the weight of the
+	 * drone, and the paths do not depend on it, so the same flight with fewer batteries consumes the same energy
+	 * scaled by the ratio of the weights. Once it fits in those batteries, no drone runs out before the end, and
+	 * the simulation would have gone the same way.
+	 *
+	 * @param Consumption Energy of the flight with max_battery_count batteries, in Wh, see FSimOutcome.
+	 * @param OutConsumption Energy the flight needs, in Wh, with that battery count (or the highest one).
+	 * @returns The battery count, -1 if even max_battery_count is not enough.
+	 */
+	int FindMinBatteryCount(const FSimConfig& Config, const double Consumption, float& OutConsumption)
+	{
+		for (int i = 0; i <= Config.MaxBatteryCount; i++)
+		{
+			OutConsumption = (float)(Consumption * Config.DroneWeight(i) / Config.DroneWeight(Config.MaxBatteryCount));
+			if (OutConsumption <= Config.BatteryCapacity * i) return i;
+		}
+		return -1;
+	}
+
+
+	/**
+	 * Creates the search selected by Config.SearchMode.
+	 */
+	std::unique_ptr<FSimSearch> FSimSearch::Make(const FSimConfig& Config)
+	{
+		switch (Config.SearchMode)
+		{
+		case ESimSearchMode::Bisection:
+			return std::make_unique<FSimBisectionSearch>(Config);
+		case ESimSearchMode::Linear:
+		default:
+			return std::make_unique<FSimLinearSearch>(Config);
+		}
+	}
+
+
+	/**
+	 * Saves or loads the state of the search between two groups, see FSimCheckpoint. Derived classes add theirs.
+	 */
+	void FSimSearch::Serialize(FSimArchive& Ar)
+	{
+		Ar << Results;
+	}
+
+
+	/**
+	 * Prints a recap of the current group settings.
+	 */
+	void FSimSearch::PrintSimConfigRecap() const
+	{
+		if (IsFinished()) return;
+		const FSimGroupParams Params = GetGroupParams();
+
+		Log(SimPrintf("Trying with %d drone%s at %d m/s",
+			Params.NumDrones, Params.NumDrones > 1 ? "s" : "", (int)Params.Speed));
+
+		Log(SimPrintf("Maximum autonomy : %d min (%d simulated seconds)",
+			(int)std::floor(Params.MaxTimePerSim / 60),
+			(int)(Params.MaxTimePerSim / (Config.Step * Config.SimulationSpeed))));
+	}
+
+
+	/**
+	 * Calculates the autonomy a drone flying at the given speed can have with the highest battery capacity.
+	 *
+	 * It only pays for moving: with the energy model, hovering and turns empty the batteries before, and this is
+	 * just the longest a simulation can last.
+	 *
+	 * @returns Maximum autonomy of the drone.
+	 */
+	float FSimSearch::CalculateMaximumAutonomy(const float Speed) const
+	{
+		return (float)(Config.BatteryEnergy(Config.MaxBatteryCount) / Config.MovePower(Speed, Config.MaxBatteryCount));
+	}
+
+
+	/**
+	 * Parameters of a group of simulations at the given speed and drone count.
+	 *
+	 * Drones carry max_battery_count batteries: no search knows the battery count a group needs before running it.
+	 */
+	FSimGroupParams FSimSearch::MakeGroupParams(const float Speed, const int NumDrones) const
+	{
+		FSimGroupParams Params;
+		Params.Speed = Speed;
+		Params.NumDrones = NumDrones;
+		Params.MaxTimePerSim = CalculateMaximumAutonomy(Speed);
+		Params.BatteryCount = Config.MaxBatteryCount;
+		return Params;
+	}
+
+
+	/**
+	 * Calculates the minimum battery count a drone has to have to be successful, from the mean consumption of
+	 * the successful simulations of the group.
+	 *
+	 * @param OutConsumption Energy the drone needs, in Wh, with that battery count.
+	 */
+	int FSimSearch::CalculateMinBatteryCount(const FSimGroupOutcome& GroupOutcome, float& OutConsumption) const
+	{
+		const int BatteryCount = FindMinBatteryCount(Config, GroupOutcome.SummedConsumptions / GroupOutcome.SuccessfulSims, OutConsumption);
+		if (BatteryCount >= 0) return BatteryCount;
+		Log("UNEXPECTED : Selected config requires more batteries than allowed !");
+		return Config.MaxBatteryCount;
+	}
+
+
+	/**
+	 * Prints the outcome of a group.
+	 *
+	 * @returns The minimum battery count for a successful group, -1 otherwise.
+	 */
+	int FSimSearch::LogGroupOutcome(const bool IsGroupSuccessful, const FSimGroupOutcome& GroupOutcome) const
+	{
+		if (!IsGroupSuccessful)
+		{
+			Log("Fail");
+			return -1;
+		}
+
+		Log("Success");
+		Log(SimPrintf("Average of %d min to find", (int)(GroupOutcome.SummedTimesToFind / GroupOutcome.SuccessfulSims / 60)));
+
+		// Calculate the least amount of batteries required
+		float Consumption;
+		const int BatteryCount = CalculateMinBatteryCount(GroupOutcome, Consumption);
+		Log(SimPrintf("Consumes %d Wh over %d batter%s (total capacity of %d Wh)",
+			(int)Consumption, BatteryCount, BatteryCount > 1 ? "ies" : "y", (int)(BatteryCount * Config.BatteryCapacity)));
+		return BatteryCount;
+	}
+}
@@ -0,0 +1,78 @@
+#include "SimCore/SimShards.h"
+
+#include <algorithm>
+
+namespace DroSimCore
+{
+	namespace SimShards
+	{
+		// Shard i starts its simulation IDs at i * ShardIDStride, far more than a shard ever runs
+		constexpr uint64_t ShardIDStride = 1ull << 40;
+	}
+
+
+	/**
+	 * Configuration a worker runs for this shard, the drone range of Config narrowed to the shard.
+	 */
+	FSimConfig FSimShard::Apply(const FSimConfig& Config) const
+	{
+		FSimConfig ShardConfig = Config;
+		ShardConfig.MinNumDrones = MinNumDrones;
+		ShardConfig.MaxNumDrones = MaxNumDrones;
+		return ShardConfig;
+	}
+
+
+	/**
+	 * Splits the drone counts of a sweep in up to NumShards contiguous ranges of nearly the same size.
+	 *
+	 * Shard 0 starts at simulation ID 0, so a sweep of a single shard runs the same simulations as FSimSweep.
+	 * With more shards, each one starts a fresh search at its first drone count, see FSimShard.
+	 * Fewer shards are made when there are fewer drone counts than NumShards.
+	 */
+	std::vector<FSimShard> MakeShards(const FSimConfig& Config, const int NumShards)
+	{
+		// Drone counts the search goes through, see FSimSearch::IsFinished
+		std::vector<int> DroneCounts;
+		for (int NumDrones = Config.MinNumDrones; NumDrones < Config.MaxNumDrones; NumDrones += Config.DroneIncrement)
+			DroneCounts.push_back(NumDrones);
+
+		std::vector<FSimShard> Shards;
+		const int Count = std::max(1, std::min(NumShards, (int)DroneCounts.size()));
+		for (int i = 0; i < Count && !DroneCounts.empty(); i++)
+		{
+			const size_t First = DroneCounts.size() * i / Count;
+			const size_t End = DroneCounts.size() * (i + 1) / Count;
+
+			FSimShard Shard;
+			Shard.Index = i;
+			Shard.MinNumDrones = DroneCounts[First];
+			Shard.MaxNumDrones = End < DroneCounts.size() ? DroneCounts[End] : Config.MaxNumDrones;
+			Shard.FirstSimulationID = i * SimShards::ShardIDStride;
+			Shards.push_back(Shard);
+		}
+		return Shards;
+	}
+
+
+	/**
+	 * Merges the results of every shard of a sweep, given in shard order.
+	 *
+	 * The fast configuration is found at the first drone count with a successful speed, so it is the one of the
+	 * first shard that has one. Slow configurations are one per drone count and are concatenated.
+	 */
+	FSimResults MergeShardResults(const std::vector<FSimResults>& ShardResults)
+	{
+		FSimResults Results;
+		for (const FSimResults& Shard : ShardResults)
+		{
+			if (Shard.HasFastConfig && !Results.HasFastConfig)
+			{
+				Results.HasFastConfig = true;
+				Results.FastConfig = Shard.FastConfig;
+			}
+			Results.SlowConfigs.insert(Results.SlowConfigs.end(), Shard.SlowConfigs.begin(), Shard.SlowConfigs.end());
+		}
+		return Results;
+	}
+}
@@ -0,0 +1,122 @@
+#pragma once
+
+/**
+ * Thin wrapper over the double precision vector instructions available at compile time
+ * (AVX, SSE2 or NEON). Kernels are templated on FSimdOps / FScalarOps so the same code
+ * handles full vectors and the remaining tail elements.
+ */
+
+#if defined(__AVX__)
+	#include <immintrin.h>
+	#define DROSIM_SIMD_AVX 1
+#elif defined(__SSE2__) || defined(_M_X64) || (defined(_M_IX86_FP) && _M_IX86_FP >= 2)
+	#include <emmintrin.h>
+	#define DROSIM_SIMD_SSE2 1
+#elif defined(__aarch64__) || defined(_M_ARM64)
+	#include <arm_neon.h>
+	#define DROSIM_SIMD_NEON 1
+#endif
+
+namespace DroSimCore
+{
+#if defined(DROSIM_SIMD_AVX)
+	struct FSimdOps
+	{
+		using FReg = __m256d;
+		using FMask = __m256d;
+		static constexpr int Lanes = 4;
+		static constexpr const char* Name = "AVX";
+
+		static FReg Load(const double* P) { return _mm256_loadu_pd(P); }
+		static void Store(double* P, const FReg V) { _mm256_storeu_pd(P, V); }
+		static FReg Set1(const double V) { return _mm256_set1_pd(V); }
+		static FReg Add(const FReg A, const FReg B) { return _mm256_add_pd(A, B); }
+		static FReg Sub(const FReg A, const FReg B) { return _mm256_sub_pd(A, B); }
+		static FReg Mul(const FReg A, const FReg B) { return _mm256_mul_pd(A, B); }
+		static FMask CmpLe(const FReg A, const FReg B) { return _mm256_cmp_pd(A, B, _CMP_LE_OQ); }
+		static FMask CmpLt(const FReg A, const FReg B) { return _mm256_cmp_pd(A, B, _CMP_LT_OQ); }
+		static FMask CmpGe(const FReg A, const FReg B) { return _mm256_cmp_pd(A, B, _CMP_GE_OQ); }
+		static FMask And(const FMask A, const FMask B) { return _mm256_and_pd(A, B); }
+		static FMask Or(const FMask A, const FMask B) { return _mm256_or_pd(A, B); }
+		static FMask AndNot(const FMask A, const FMask B) { return _mm256_andnot_pd(B, A); }
+		static FReg Select(const FMask Mask, const FReg A, const FReg B) { return _mm256_blendv_pd(B, A, Mask); }
+		static int MoveMask(const FMask Mask) { return _mm256_movemask_pd(Mask); }
+	};
+#elif defined(DROSIM_SIMD_SSE2)
+	struct FSimdOps
+	{
+		using FReg = __m128d;
+		using FMask = __m128d;
+		static constexpr int Lanes = 2;
+		static constexpr const char* Name = "SSE2";
+
+		static FReg Load(const double* P) { return _mm_loadu_pd(P); }
+		static void Store(double* P, const FReg V) { _mm_storeu_pd(P, V); }
+		static FReg Set1(const double V) { return _mm_set1_pd(V); }
+		static FReg Add(const FReg A, const FReg B) { return _mm_add_pd(A, B); }
+		static FReg Sub(const FReg A, const FReg B) { return _mm_sub_pd(A, B); }
+		static FReg Mul(const FReg A, const FReg B) { return _mm_mul_pd(A, B); }
+		static FMask CmpLe(const FReg A, const FReg B) { return _mm_cmple_pd(A, B); }
+		static FMask CmpLt(const FReg A, const FReg B) { return _mm_cmplt_pd(A, B); }
+		static FMask CmpGe(const FReg A, const FReg B) { return _mm_cmpge_pd(A, B); }
+		static FMask And(const FMask A, const FMask B) { return _mm_and_pd(A, B); }
+		static FMask Or(const FMask A, const FMask B) { return _mm_or_pd(A, B); }
+		static FMask AndNot(const FMask A, const FMask B) { return _mm_andnot_pd(B, A); }
+		static FReg Select(const FMask Mask, const FReg A, const FReg B) { return _mm_or_pd(_mm_and_pd(Mask, A), _mm_andnot_pd(Mask, B)); }
+		static int MoveMask(const FMask Mask) { return _mm_movemask_pd(Mask); }
+	};
+#elif defined(DROSIM_SIMD_NEON)
+	struct FSimdOps
+	{
+		using FReg = float64x2_t;
+		using FMask = uint64x2_t;
+		static constexpr int Lanes = 2;
+		static constexpr const char* Name = "NEON";
+
+		static FReg Load(const double* P) { return vld1q_f64(P); }
+		static void Store(double* P, const FReg V) { vst1q_f64(P, V); }
+		static FReg Set1(const double V) { return vdupq_n_f64(V); }
+		static FReg Add(const FReg A, const FReg B) { return vaddq_f64(A, B); }
+		static FReg Sub(const FReg A, const FReg B) { return vsubq_f64(A, B); }
+		static FReg Mul(const FReg A, const FReg B) { return vmulq_f64(A, B); }
+		static FMask CmpLe(const FReg A, const FReg B) { return vcleq_f64(A, B); }
+		static FMask CmpLt(const FReg A, const FReg B) { return vcltq_f64(A, B); }
+		static FMask CmpGe(const FReg A, const FReg B) { return vcgeq_f64(A, B); }
+		static FMask And(const FMask A, const FMask B) { return vandq_u64(A, B); }
+		static FMask Or(const FMask A, const FMask B) { return vorrq_u64(A, B); }
+		static FMask AndNot(const FMask A, const FMask B) { return vbicq_u64(A, B); }
+		static FReg Select(const FMask Mask, const FReg A, const FReg B) { return vbslq_f64(Mask, A, B); }
+		static int MoveMask(const FMask Mask)
+		{
+			return (int)(vgetq_lane_u64(Mask, 0) & 1) | (int)((vgetq_lane_u64(Mask, 1) & 1) << 1);
+		}
+	};
+#endif
+
+	struct FScalarOps
+	{
+		using FReg = double;
+		using FMask = bool;
+		static constexpr int Lanes = 1;
+		static constexpr const char* Name = "Scalar";
+
+		static FReg Load(const double* P) { return *P; }
+		static void Store(double* P, const FReg V) { *P = V; }
+		static FReg Set1(const double V) { return V; }
+		static FReg Add(const FReg A, const FReg B) { return A + B; }
+		static FReg Sub(const FReg A, const FReg B) { return A - B; }
+		static FReg Mul(const FReg A, const FReg B) { return A * B; }
+		static FMask CmpLe(const FReg A, const FReg B) { return A <= B; }
+		static FMask CmpLt(const FReg A, const FReg B) { return A < B; }
+		static FMask CmpGe(const FReg A, const FReg B) { return A >= B; }
+		static FMask And(const FMask A, const FMask B) { return A && B; }
+		static FMask Or(const FMask A, const FMask B) { return A || B; }
+		static FMask AndNot(const FMask A, const FMask B) { return A && !B; }
+		static FReg Select(const FMask Mask, const FReg A, const FReg B) { return Mask ? A : B; }
+		static int MoveMask(const FMask Mask) { return Mask ? 1 : 0; }
+	};
+
+#if !defined(DROSIM_SIMD_AVX) && !defined(DROSIM_SIMD_SSE2) && !defined(DROSIM_SIMD_NEON)
+	using FSimdOps = FScalarOps;
+#endif
+}
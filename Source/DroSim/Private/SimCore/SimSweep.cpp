@@ -0,0 +1,196 @@
+#include "SimCore/SimSweep.h"
+
+#include <algorithm>
+#include <chrono>
+#include <vector>
+
+#include "SimCore/SimOracle.h"
+#include "SimCore/Simulation.h"
+
+namespace DroSimCore
+{
+	/**
+	 * Runs up to Config.SimGroupSize simulations with the same parameters across the pool.
+	 *
+	 * Replica i is simulation FirstSimulationID + i, or simulation i of every group with common_random_numbers, so
+	 * that all configurations are compared on the same objective placements. Each replica owns its objective,
+	 * drones and random streams, and the outcomes are reduced in replica order: the result does not depend on
+	 * the number of threads.
+	 * Replicas run in batches of one per thread, and the group stops at the first replica that settles its
+	 * verdict (see EvaluateGroup); later replicas of that batch are discarded.
+	 * With a TrajectoryWriter, every replica run is recorded, discarded ones included.
+	 * Sweep replicas are solved by FSimSweepOracle instead of being stepped when the oracle is enabled, unless
+	 * they have to be recorded.
+	 */
+	FSimGroupOutcome RunSimulationGroup(const FSimConfig& Config, const FSimGroupParams& Params, const uint32_t Seed, const uint64_t FirstSimulationID,
+		FSimThreadPool& Pool, FSimTrajectoryWriter* TrajectoryWriter)
+	{
+		const uint64_t BaseSimulationID = Config.CommonRandomNumbers ? 0 : FirstSimulationID;
+
+		const bool UsesOracle = Config.UsesSweepOracle && FSimSweepOracle::Supports(Config) && !TrajectoryWriter;
+		const int BatchSize = Config.EarlyStopping == ESimEarlyStopping::None ? Config.SimGroupSize : Pool.GetNumThreads();
+		std::vector<FSimOutcome> Outcomes(Config.SimGroupSize);
+
+		FSimGroupOutcome GroupOutcome;
+		GroupOutcome.FirstSimulationID = BaseSimulationID;
+		ESimGroupVerdict Verdict = ESimGroupVerdict::Undecided;
+		for (int BatchStart = 0; Verdict == ESimGroupVerdict::Undecided; BatchStart += BatchSize)
+		{
+			const int BatchCount = std::min(BatchSize, Config.SimGroupSize - BatchStart);
+			Pool.ParallelFor(BatchCount, [&](const int i)
+			{
+				if (UsesOracle)
+				{
+					Outcomes[BatchStart + i] = FSimSweepOracle(Config, Params, Seed, BaseSimulationID + BatchStart + i).Run();
+					return;
+				}
+				FSimulation Simulation(Config, Params, Seed, BaseSimulationID + BatchStart + i);
+				if (!TrajectoryWriter)
+				{
+					Outcomes[BatchStart + i] = Simulation.Run();
+					return;
+				}
+				FSimTrajectoryBuilder Trajectory(Simulation.GetSimulationID(), Config.ObjectiveCount, Params.NumDrones, Config.Step);
+				Simulation.RecordTrajectory(&Trajectory);
+				Outcomes[BatchStart + i] = Simulation.Run();
+				TrajectoryWriter->AddSimulation(Trajectory);
+			});
+
+			for (int i = BatchStart; i < BatchStart + BatchCount && Verdict == ESimGroupVerdict::Undecided; i++)
+			{
+				GroupOutcome.RunSims++;
+				if (Outcomes[i].Found)
+				{
+					GroupOutcome.SuccessfulSims++;
+					GroupOutcome.SummedTimesToFind += Outcomes[i].TimeToFind;
+					GroupOutcome.SummedConsumptions += Outcomes[i].Consumption;
+				}
+				Verdict = EvaluateGroup(Config, GroupOutcome.RunSims, GroupOutcome.SuccessfulSims);
+			}
+		}
+
+		GroupOutcome.IsSuccessful = Verdict == ESimGroupVerdict::Success;
+		Outcomes.resize(GroupOutcome.RunSims);
+		GroupOutcome.Outcomes = std::move(Outcomes);
+		return GroupOutcome;
+	}
+
+
+	FSimSweep::FSimSweep(const FSimConfig& InConfig, const uint32_t InSeed)
+		: Config(InConfig)
+		, Seed(InSeed)
+		, Pool(InConfig.WorkerThreads)
+		, Search(FSimSearch::Make(InConfig))
+	{
+	}
+
+
+	/**
+	 * Continues the sweep a checkpoint was saved from instead of starting a new one, to be called before Run.
+	 *
+	 * Groups then run from the one following the checkpoint, with the same simulation IDs, so the results are
+	 * the same as if the sweep had never stopped.
+	 *
+	 * @returns False if the checkpoint was saved by the engine, with another seed, search or configuration, or its search
+	 *          state is invalid.
+	 */
+	bool FSimSweep::Resume(const FSimCheckpoint& Checkpoint, std::string& OutError)
+	{
+		if (Checkpoint.Seed != Seed)
+		{
+			OutError = SimPrintf("The checkpoint was saved with seed %u", Checkpoint.Seed);
+			return false;
+		}
+		if (!Checkpoint.Matches(ESimCheckpointProducer::Cli, Config, OutError)) return false;
+
+		std::unique_ptr<FSimSearch> ResumedSearch = FSimSearch::Make(Config);
+		std::vector<uint8_t> SearchState = Checkpoint.SearchState;
+		FSimArchive Ar(SearchState, true);
+		ResumedSearch->Serialize(Ar);
+		if (!Ar.IsAtEnd())
+		{
+			OutError = "The search state of the checkpoint is invalid";
+			return false;
+		}
+
+		Search = std::move(ResumedSearch);
+		NextSimulationID = Checkpoint.NextSimulationID;
+		GroupCount = Checkpoint.GroupCount;
+		SimulationCount = Checkpoint.SimulationCount;
+		return true;
+	}
+
+
+	/**
+	 * Saves the state of the sweep between two groups. A checkpoint that cannot be saved is logged, and the
+	 * sweep goes on.
+	 */
+	void FSimSweep::SaveCheckpoint()
+	{
+		FSimCheckpoint Checkpoint;
+		Checkpoint.Producer = ESimCheckpointProducer::Cli;
+		Checkpoint.SearchMode = Config.SearchMode;
+		Checkpoint.ConfigHash = Config.IniHash;
+		Checkpoint.Seed = Seed;
+		Checkpoint.NextSimulationID = NextSimulationID;
+		Checkpoint.GroupCount = GroupCount;
+		Checkpoint.SimulationCount = SimulationCount;
+		Checkpoint.RecordsSize = RecordWriter ? (int64_t)RecordWriter->Sync() : -1;
+		FSimArchive Ar(Checkpoint.SearchState, false);
+		Search->Serialize(Ar);
+
+		std::string Error;
+		if (!Checkpoint.Save(CheckpointPath, Error) && Logger) Logger("Checkpoint not saved : " + Error);
+	}
+
+
+	/**
+	 * Runs the whole parameter search.
+	 *
+	 * @returns The fast and slow configurations found.
+	 */
+	FSimResults FSimSweep::Run()
+	{
+		Search->SetLogger(Logger);
+		if (Logger && GroupCount > 0)
+			Logger(SimPrintf("Resuming at group %d, %d simulations already run", GroupCount, SimulationCount));
+		Search->PrintSimConfigRecap();
+
+		using FClock = std::chrono::steady_clock;
+		const auto CheckpointInterval = std::chrono::duration_cast<FClock::duration>(std::chrono::duration<double>(Config.CheckpointInterval));
+		FClock::time_point NextCheckpoint = FClock::now() + CheckpointInterval;
+
+		while (!Search->IsFinished())
+		{
+			const FSimGroupParams Params = Search->GetGroupParams();
+			FSimGroupOutcome GroupOutcome;
+			const bool UsesCache = GroupCache && !TrajectoryWriter;
+			if (!UsesCache || !GroupCache->Find(Config, Params, Seed, NextSimulationID, GroupOutcome))
+			{
+				GroupOutcome = RunSimulationGroup(Config, Params, Seed, NextSimulationID, Pool, TrajectoryWriter);
+				if (UsesCache) GroupCache->Add(Config, Params, Seed, NextSimulationID, GroupOutcome);
+			}
+			if (RecordWriter)
+				for (int i = 0; i < GroupOutcome.RunSims; i++)
+				{
+					const FSimOutcome& Outcome = GroupOutcome.Outcomes[i];
+					RecordWriter->Add(MakeSimRecord(Config, GroupOutcome.FirstSimulationID + i, GroupCount, Params.Speed,
+						Params.NumDrones, Seed, Outcome.Found, Outcome.FlightTime, Outcome.Consumption));
+				}
+			GroupCount++;
+			if (Logger && !Config.CommonRandomNumbers)
+				Logger(SimPrintf("Simulations %llu to %llu", (unsigned long long)NextSimulationID, (unsigned long long)(NextSimulationID + GroupOutcome.RunSims - 1)));
+			NextSimulationID += Config.SimGroupSize;
+			SimulationCount += GroupOutcome.RunSims;
+			Search->ReportGroup(GroupOutcome);
+
+			if (!CheckpointPath.empty() && (Search->IsFinished() || FClock::now() >= NextCheckpoint))
+			{
+				SaveCheckpoint();
+				NextCheckpoint = FClock::now() + CheckpointInterval;
+			}
+		}
+
+		return Search->GetResults();
+	}
+}
@@ -0,0 +1,86 @@
+#include "SimCore/SimThreadPool.h"
+
+namespace DroSimCore
+{
+	/**
+	 * @param NumThreads Total number of threads including the caller, 0 to use every hardware thread.
+	 */
+	FSimThreadPool::FSimThreadPool(int NumThreads)
+	{
+		if (NumThreads <= 0) NumThreads = (int)std::thread::hardware_concurrency();
+		if (NumThreads <= 0) NumThreads = 1;
+
+		for (int i = 1; i < NumThreads; i++) Workers.emplace_back([this] { WorkerLoop(); });
+	}
+
+
+	FSimThreadPool::~FSimThreadPool()
+	{
+		{
+			std::lock_guard<std::mutex> Lock(Mutex);
+			bStopping = true;
+		}
+		WakeUp.notify_all();
+		for (std::thread& Worker : Workers) Worker.join();
+	}
+
+
+	/**
+	 * Calls Body(i) for every i in [0, Count) across the pool and waits for all of them.
+	 *
+	 * Indices are handed out dynamically, Body must only write to per-index state.
+	 */
+	void FSimThreadPool::ParallelFor(const int Count, const std::function<void(int)>& Body)
+	{
+		if (Count <= 0) return;
+		if (Workers.empty() || Count == 1)
+		{
+			for (int i = 0; i < Count; i++) Body(i);
+			return;
+		}
+
+		{
+			std::lock_guard<std::mutex> Lock(Mutex);
+			CurrentBody = &Body;
+			CurrentCount = Count;
+			NextIndex = 0;
+			BusyWorkers = (int)Workers.size();
+			Generation++;
+		}
+		WakeUp.notify_all();
+
+		RunIndices();
+
+		std::unique_lock<std::mutex> Lock(Mutex);
+		Done.wait(Lock, [this] { return BusyWorkers == 0; });
+		CurrentBody = nullptr;
+	}
+
+
+	void FSimThreadPool::WorkerLoop()
+	{
+		unsigned SeenGeneration = 0;
+		for (;;)
+		{
+			{
+				std::unique_lock<std::mutex> Lock(Mutex);
+				WakeUp.wait(Lock, [this, SeenGeneration] { return bStopping || Generation != SeenGeneration; });
+				if (bStopping) return;
+				SeenGeneration = Generation;
+			}
+
+			RunIndices();
+
+			{
+				std::lock_guard<std::mutex> Lock(Mutex);
+				if (--BusyWorkers == 0) Done.notify_one();
+			}
+		}
+	}
+
+
+	void FSimThreadPool::RunIndices()
+	{
+		for (int i = NextIndex++; i < CurrentCount; i = NextIndex++) (*CurrentBody)(i);
+	}
+}
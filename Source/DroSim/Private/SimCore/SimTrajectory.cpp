@@ -0,0 +1,307 @@
+#include "SimCore/SimTrajectory.h"
+
+#include <cmath>
+#include <cstring>
+
+namespace DroSimCore
+{
+	namespace SimTrajectory
+	{
+		constexpr char FileMagic[4] = {'D', 'S', 'T', 'J'};
+		constexpr char IndexMagic[4] = {'D', 'S', 'T', 'X'};
+		constexpr uint32_t Version = 2;
+
+		// u64 ID, u32 entities, u32 objectives, u32 frames, f32 step, u32 keyframe interval, u32 keyframes
+		constexpr size_t BlockHeaderSize = 8 + 4 * 6;
+
+
+		template <typename T>
+		void Append(std::vector<uint8_t>& Bytes, const T Value)
+		{
+			const size_t Position = Bytes.size();
+			Bytes.resize(Position + sizeof(T));
+			std::memcpy(&Bytes[Position], &Value, sizeof(T));
+		}
+
+
+		/** Reads a value at Offset if it fits in Size bytes, and moves past it. */
+		template <typename T>
+		bool Read(const uint8_t* Data, const size_t Size, size_t& Offset, T& OutValue)
+		{
+			if (Offset + sizeof(T) > Size) return false;
+			std::memcpy(&OutValue, Data + Offset, sizeof(T));
+			Offset += sizeof(T);
+			return true;
+		}
+
+
+		void AppendVarint(std::vector<uint8_t>& Bytes, const int32_t Value)
+		{
+			// Zigzag: small negative and positive deltas both get few bytes
+			uint32_t Encoded = ((uint32_t)Value << 1) ^ (uint32_t)(Value >> 31);
+			while (Encoded >= 0x80)
+			{
+				Bytes.push_back((uint8_t)(Encoded | 0x80));
+				Encoded >>= 7;
+			}
+			Bytes.push_back((uint8_t)Encoded);
+		}
+
+
+		bool ReadVarint(const uint8_t*& Cursor, const uint8_t* End, int32_t& OutValue)
+		{
+			uint32_t Encoded = 0;
+			for (int Shift = 0; Shift < 35; Shift += 7)
+			{
+				if (Cursor == End) return false;
+				const uint8_t Byte = *Cursor++;
+				Encoded |= (uint32_t)(Byte & 0x7F) << Shift;
+				if (!(Byte & 0x80))
+				{
+					OutValue = (int32_t)(Encoded >> 1) ^ -(int32_t)(Encoded & 1);
+					return true;
+				}
+			}
+			return false;
+		}
+	}
+
+
+	FSimTrajectoryBuilder::FSimTrajectoryBuilder(const uint64_t InSimulationID, const int InNumObjectives, const int InNumDrones, const float InStep)
+		: Previous((size_t)(InNumObjectives + InNumDrones) * 3, 0)
+	{
+		Info.SimulationID = InSimulationID;
+		Info.NumEntities = InNumObjectives + InNumDrones;
+		Info.NumObjectives = InNumObjectives;
+		Info.Step = InStep;
+	}
+
+
+	/**
+	 * Encodes the positions of every entity at the end of a substep.
+	 */
+	void FSimTrajectoryBuilder::AddFrame(const std::vector<FSimVec3>& Positions)
+	{
+		const bool IsKeyframe = Info.NumFrames % KeyframeInterval == 0;
+		if (IsKeyframe)
+		{
+			KeyframeOffsets.push_back((uint32_t)Data.size());
+			std::fill(Previous.begin(), Previous.end(), 0);
+		}
+
+		for (int i = 0; i < Info.NumEntities; i++)
+		{
+			const double Coordinates[3] = {Positions[i].X, Positions[i].Y, Positions[i].Z};
+			for (int Axis = 0; Axis < 3; Axis++)
+			{
+				const int32_t Quantized = (int32_t)std::lround(Coordinates[Axis]);
+				SimTrajectory::AppendVarint(Data, Quantized - Previous[i * 3 + Axis]);
+				Previous[i * 3 + Axis] = Quantized;
+			}
+		}
+		Info.NumFrames++;
+	}
+
+
+	/**
+	 * Appends the block of this simulation, as laid out in the file.
+	 */
+	void FSimTrajectoryBuilder::Serialize(std::vector<uint8_t>& OutBlock) const
+	{
+		OutBlock.reserve(OutBlock.size() + SimTrajectory::BlockHeaderSize + KeyframeOffsets.size() * 4 + 4 + Data.size());
+		SimTrajectory::Append(OutBlock, Info.SimulationID);
+		SimTrajectory::Append(OutBlock, (uint32_t)Info.NumEntities);
+		SimTrajectory::Append(OutBlock, (uint32_t)Info.NumObjectives);
+		SimTrajectory::Append(OutBlock, (uint32_t)Info.NumFrames);
+		SimTrajectory::Append(OutBlock, Info.Step);
+		SimTrajectory::Append(OutBlock, (uint32_t)KeyframeInterval);
+		SimTrajectory::Append(OutBlock, (uint32_t)KeyframeOffsets.size());
+		for (const uint32_t KeyframeOffset : KeyframeOffsets) SimTrajectory::Append(OutBlock, KeyframeOffset);
+		SimTrajectory::Append(OutBlock, (uint32_t)Data.size());
+		OutBlock.insert(OutBlock.end(), Data.begin(), Data.end());
+	}
+
+
+	FSimTrajectoryWriter::~FSimTrajectoryWriter()
+	{
+		Close();
+	}
+
+
+	/**
+	 * Creates a trajectory file, replacing any previous one.
+	 */
+	bool FSimTrajectoryWriter::Open(const std::string& Path, std::string& OutError)
+	{
+		Close();
+
+		File.open(Path, std::ios::binary | std::ios::trunc);
+		if (!File)
+		{
+			OutError = "Cannot open " + Path + " for writing";
+			return false;
+		}
+
+		File.write(SimTrajectory::FileMagic, 4);
+		File.write((const char*)&SimTrajectory::Version, 4);
+		Offset = 8;
+		Index.clear();
+		return true;
+	}
+
+
+	/**
+	 * Appends the block of a finished simulation. Thread-safe.
+	 */
+	void FSimTrajectoryWriter::AddSimulation(const FSimTrajectoryBuilder& Trajectory)
+	{
+		std::lock_guard<std::mutex> Lock(Mutex);
+		if (!File.is_open()) return;
+
+		Block.clear();
+		Trajectory.Serialize(Block);
+		uint64_t SimulationID;
+		std::memcpy(&SimulationID, Block.data(), sizeof(SimulationID));
+
+		File.write((const char*)Block.data(), (std::streamsize)Block.size());
+		Index.emplace_back(SimulationID, Offset);
+		Offset += Block.size();
+	}
+
+
+	/**
+	 * Writes the index and closes the file.
+	 */
+	void FSimTrajectoryWriter::Close()
+	{
+		std::lock_guard<std::mutex> Lock(Mutex);
+		if (!File.is_open()) return;
+
+		std::vector<uint8_t> Footer;
+		SimTrajectory::Append(Footer, (uint64_t)Index.size());
+		for (const auto& Entry : Index)
+		{
+			SimTrajectory::Append(Footer, Entry.first);
+			SimTrajectory::Append(Footer, Entry.second);
+		}
+		SimTrajectory::Append(Footer, Offset);
+		Footer.insert(Footer.end(), SimTrajectory::IndexMagic, SimTrajectory::IndexMagic + 4);
+
+		File.write((const char*)Footer.data(), (std::streamsize)Footer.size());
+		File.close();
+	}
+
+
+	/**
+	 * Maps a trajectory file and loads its index.
+	 */
+	bool FSimTrajectoryReader::Open(const std::string& Path, std::string& OutError)
+	{
+		BlockOffsets.clear();
+		SimulationIDs.clear();
+		if (!File.Open(Path, OutError)) return false;
+
+		const uint8_t* Data = File.GetData();
+		const size_t Size = File.GetSize();
+		OutError = Path + " is not a complete trajectory file";
+
+		uint32_t Version;
+		size_t Cursor = 4;
+		if (Size < 8 + 12 || std::memcmp(Data, SimTrajectory::FileMagic, 4) != 0
+			|| std::memcmp(Data + Size - 4, SimTrajectory::IndexMagic, 4) != 0
+			|| !SimTrajectory::Read(Data, Size, Cursor, Version) || Version != SimTrajectory::Version)
+			return false;
+
+		uint64_t IndexOffset;
+		Cursor = Size - 12;
+		SimTrajectory::Read(Data, Size, Cursor, IndexOffset);
+
+		uint64_t NumSimulations;
+		Cursor = (size_t)IndexOffset;
+		if (!SimTrajectory::Read(Data, Size, Cursor, NumSimulations)) return false;
+		for (uint64_t i = 0; i < NumSimulations; i++)
+		{
+			uint64_t SimulationID, BlockOffset;
+			if (!SimTrajectory::Read(Data, Size, Cursor, SimulationID) || !SimTrajectory::Read(Data, Size, Cursor, BlockOffset))
+				return false;
+			BlockOffsets[SimulationID] = BlockOffset;
+			SimulationIDs.push_back(SimulationID);
+		}
+
+		OutError.clear();
+		return true;
+	}
+
+
+	/**
+	 * IDs of the recorded simulations, in the order they were written.
+	 */
+	std::vector<uint64_t> FSimTrajectoryReader::GetSimulationIDs() const
+	{
+		return SimulationIDs;
+	}
+
+
+	bool FSimTrajectoryReader::GetInfo(const uint64_t SimulationID, FSimTrajectoryInfo& OutInfo) const
+	{
+		const auto It = BlockOffsets.find(SimulationID);
+		if (It == BlockOffsets.end()) return false;
+
+		size_t Cursor = (size_t)It->second;
+		uint32_t NumEntities, NumObjectives, NumFrames;
+		if (!SimTrajectory::Read(File.GetData(), File.GetSize(), Cursor, OutInfo.SimulationID)
+			|| !SimTrajectory::Read(File.GetData(), File.GetSize(), Cursor, NumEntities)
+			|| !SimTrajectory::Read(File.GetData(), File.GetSize(), Cursor, NumObjectives)
+			|| !SimTrajectory::Read(File.GetData(), File.GetSize(), Cursor, NumFrames)
+			|| !SimTrajectory::Read(File.GetData(), File.GetSize(), Cursor, OutInfo.Step))
+			return false;
+		OutInfo.NumEntities = (int)NumEntities;
+		OutInfo.NumObjectives = (int)NumObjectives;
+		OutInfo.NumFrames = (int)NumFrames;
+		return true;
+	}
+
+
+	/**
+	 * Decodes the positions of every entity at a frame, starting from the keyframe before it.
+	 *
+	 * @param OutPositions Objectives then drones, by ID.
+	 */
+	bool FSimTrajectoryReader::ReadFrame(const uint64_t SimulationID, const int Frame, std::vector<FSimVec3>& OutPositions) const
+	{
+		FSimTrajectoryInfo Info;
+		if (!GetInfo(SimulationID, Info) || Frame < 0 || Frame >= Info.NumFrames) return false;
+
+		const uint8_t* Data = File.GetData();
+		const size_t Size = File.GetSize();
+		size_t Cursor = (size_t)BlockOffsets.at(SimulationID) + 8 + 4 * 4;
+
+		uint32_t KeyframeInterval, NumKeyframes, KeyframeOffset, DataSize;
+		if (!SimTrajectory::Read(Data, Size, Cursor, KeyframeInterval) || !SimTrajectory::Read(Data, Size, Cursor, NumKeyframes)
+			|| KeyframeInterval == 0)
+			return false;
+
+		const uint32_t Keyframe = (uint32_t)Frame / KeyframeInterval;
+		size_t KeyframeCursor = Cursor + (size_t)Keyframe * 4;
+		Cursor += (size_t)NumKeyframes * 4;
+		if (Keyframe >= NumKeyframes || !SimTrajectory::Read(Data, Size, KeyframeCursor, KeyframeOffset)
+			|| !SimTrajectory::Read(Data, Size, Cursor, DataSize) || Cursor + DataSize > Size)
+			return false;
+
+		const uint8_t* Encoded = Data + Cursor + KeyframeOffset;
+		const uint8_t* End = Data + Cursor + DataSize;
+		std::vector<int32_t> Quantized((size_t)Info.NumEntities * 3, 0);
+		for (int Current = Keyframe * KeyframeInterval; Current <= Frame; Current++)
+			for (int32_t& Value : Quantized)
+			{
+				int32_t Delta;
+				if (!SimTrajectory::ReadVarint(Encoded, End, Delta)) return false;
+				Value += Delta;
+			}
+
+		OutPositions.resize(Info.NumEntities);
+		for (int i = 0; i < Info.NumEntities; i++)
+			OutPositions[i] = FSimVec3(Quantized[i * 3], Quantized[i * 3 + 1], Quantized[i * 3 + 2]);
+		return true;
+	}
+}
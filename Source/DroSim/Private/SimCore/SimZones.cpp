@@ -0,0 +1,140 @@
+#include "SimCore/SimZones.h"
+
+#include <cmath>
+#include <mutex>
+
+namespace DroSimCore
+{
+	/**
+	 * Creates the partitioner selected by Config.Partition.
+	 */
+	std::unique_ptr<FSimZonePartitioner> FSimZonePartitioner::Make(const FSimConfig& Config)
+	{
+		switch (Config.Partition)
+		{
+		case ESimPartition::Strips:
+			return std::make_unique<FSimStripPartitioner>();
+		case ESimPartition::Balanced:
+			return std::make_unique<FSimBalancedPartitioner>(Config.EnvMaxColumns, Config.ObjectiveMinDistanceRatio);
+		case ESimPartition::Grid:
+		default:
+			return std::make_unique<FSimGridPartitioner>(Config.EnvMaxColumns);
+		}
+	}
+
+
+	std::vector<FSimZone> FSimGridPartitioner::Partition(const FSimVec2& EnvSize, const int NumDrones) const
+	{
+		const int FilledLines = (int)std::floor((float)NumDrones / (float)MaxColumns);
+		const int TotalLines = (int)std::ceil((float)NumDrones / (float)MaxColumns);
+		const int ZonesLastLine = NumDrones - FilledLines * MaxColumns;
+
+		std::vector<FSimZone> Zones;
+		Zones.reserve(NumDrones);
+
+		// Filled lines
+		for (int Line = 0; Line < FilledLines; Line++)
+			for (int Column = 0; Column < MaxColumns; Column++)
+			{
+				FSimZone Zone;
+				Zone.TopLeft = FSimVec2(
+					EnvSize.X - (EnvSize.X / TotalLines) * Line,
+					(EnvSize.Y / MaxColumns) * Column);
+				Zone.BottomRight = FSimVec2(
+					EnvSize.X - (EnvSize.X / TotalLines) * (Line + 1),
+					(EnvSize.Y / MaxColumns) * (Column + 1));
+				Zones.push_back(Zone);
+			}
+
+		// Last line if excess zones
+		for (int Column = 0; Column < ZonesLastLine; Column++)
+		{
+			FSimZone Zone;
+			Zone.TopLeft = FSimVec2(
+				EnvSize.X - (EnvSize.X / TotalLines) * FilledLines,
+				(EnvSize.Y / ZonesLastLine) * Column);
+			Zone.BottomRight = FSimVec2(
+				0,
+				(EnvSize.Y / ZonesLastLine) * (Column + 1));
+			Zones.push_back(Zone);
+		}
+
+		return Zones;
+	}
+
+
+	std::vector<FSimZone> FSimStripPartitioner::Partition(const FSimVec2& EnvSize, const int NumDrones) const
+	{
+		std::vector<FSimZone> Zones(NumDrones);
+		for (int i = 0; i < NumDrones; i++)
+		{
+			Zones[i].TopLeft = FSimVec2(EnvSize.X, (EnvSize.Y / NumDrones) * i);
+			Zones[i].BottomRight = FSimVec2(0, (EnvSize.Y / NumDrones) * (i + 1));
+		}
+		return Zones;
+	}
+
+
+	/**
+	 * The objective spawns uniformly between MinDistanceRatio * EnvSize.X and EnvSize.X, and only moves along Y:
+	 * the zones split that band in equal areas, lines going from the far end of the environment towards the drones.
+	 */
+	std::vector<FSimZone> FSimBalancedPartitioner::Partition(const FSimVec2& EnvSize, const int NumDrones) const
+	{
+		const double BandStart = EnvSize.X * MinDistanceRatio;
+		const double BandLength = EnvSize.X - BandStart;
+		const int TotalLines = (NumDrones + MaxColumns - 1) / MaxColumns;
+
+		std::vector<FSimZone> Zones;
+		Zones.reserve(NumDrones);
+
+		double LineTop = EnvSize.X;
+		for (int Line = 0; Line < TotalLines; Line++)
+		{
+			const int ZonesInLine = Line < TotalLines - 1 ? MaxColumns : NumDrones - Line * MaxColumns;
+			const double LineBottom = Line < TotalLines - 1 ? LineTop - BandLength * ZonesInLine / NumDrones : BandStart;
+			for (int Column = 0; Column < ZonesInLine; Column++)
+			{
+				FSimZone Zone;
+				Zone.TopLeft = FSimVec2(LineTop, (EnvSize.Y / ZonesInLine) * Column);
+				Zone.BottomRight = FSimVec2(LineBottom, (EnvSize.Y / ZonesInLine) * (Column + 1));
+				Zones.push_back(Zone);
+			}
+			LineTop = LineBottom;
+		}
+
+		return Zones;
+	}
+
+
+	/**
+	 * Zones of a drone count, partitioned on first use.
+	 *
+	 * The strategy is not part of the key: no partitioner depends on it, so every strategy shares the same zones.
+	 * References stay valid for the lifetime of the cache.
+	 */
+	const std::vector<FSimZone>& FSimZoneCache::Get(const FSimConfig& Config, const int NumDrones)
+	{
+		const FKey Key(Config.Partition, NumDrones, Config.EnvSize.X, Config.EnvSize.Y, Config.EnvMaxColumns,
+			Config.Partition == ESimPartition::Balanced ? Config.ObjectiveMinDistanceRatio : 0.f);
+		{
+			std::shared_lock<std::shared_mutex> Lock(Mutex);
+			const auto It = Entries.find(Key);
+			if (It != Entries.end()) return It->second;
+		}
+
+		std::vector<FSimZone> Zones = FSimZonePartitioner::Make(Config)->Partition(Config.EnvSize, NumDrones);
+		std::unique_lock<std::shared_mutex> Lock(Mutex);
+		return Entries.emplace(Key, std::move(Zones)).first->second;
+	}
+
+
+	/**
+	 * Cache shared by every simulation of the process.
+	 */
+	FSimZoneCache& FSimZoneCache::Shared()
+	{
+		static FSimZoneCache Cache;
+		return Cache;
+	}
+}
@@ -0,0 +1,303 @@
+#include "SimCore/Simulation.h"
+
+#include <algorithm>
+
+#include "SimCore/SimDetection.h"
+#include "SimCore/SimZones.h"
+
+namespace DroSimCore
+{
+	/**
+	 * Places the objectives and the drones, with the same random streams as AManager.
+	 */
+	FSimulation::FSimulation(const FSimConfig& InConfig, const FSimGroupParams& InParams, const uint64_t Seed, const uint64_t InSimulationID)
+		: Config(InConfig)
+		, Params(InParams)
+		, SimulationID(InSimulationID)
+	{
+		// Objectives
+		const std::vector<FSimVec3> SpawnPoints = DrawObjectiveSpawnPoints(Config, Seed, SimulationID);
+		Objectives.reserve(SpawnPoints.size());
+		for (const FSimVec3& SpawnPoint : SpawnPoints)
+		{
+			Objectives.emplace_back(Config, SpawnPoint);
+			ObjectiveEnds.push_back(Objectives.back().GetPosition());
+		}
+		ObjectiveFoundTimes.assign(Objectives.size(), -1);
+		IsObjectiveFound.assign(Objectives.size(), 0);
+		ObjectiveStarts.resize(Objectives.size());
+		ContactAlphas.assign(Objectives.size(), -1);
+		if (Objectives.size() > 1) ObjectiveGrid.Reset(Config);
+
+		// Drones
+		const std::vector<FSimZone>& Zones = FSimZoneCache::Shared().Get(Config, Params.NumDrones);
+		Drones.reserve(Params.NumDrones);
+		DroneBatch.Reserve(Params.NumDrones);
+		for (int i = 0; i < Params.NumDrones; i++)
+		{
+			Drones.push_back(MakeSimDrone(Config.Strategy, Config, i + 1, Zones[i], Params.Speed, FSimRandom::ForStream(Seed, SimulationID, i + 1)));
+			Drones.back()->Start();
+			Drones.back()->AttachToBatch(DroneBatch);
+		}
+
+		// Drones carry the batteries of the group, and their weight
+		if (Config.EnergyModel)
+		{
+			DroneEnergies.assign(Params.NumDrones, Config.BatteryEnergy(Params.BatteryCount));
+			HoverStepEnergy = Config.HoverPower * Config.DroneWeight(Params.BatteryCount) * Config.Step;
+			TurnEnergyPerRadian = Config.TurnEnergy * Config.DroneWeight(Params.BatteryCount);
+		}
+
+		if (Config.CoverageEarlyStop) TrackCoverage();
+	}
+
+
+	/**
+	 * Spawn point of the first objective of a simulation.
+	 */
+	FSimVec3 FSimulation::DrawObjectiveSpawnPoint(const FSimConfig& Config, const uint64_t Seed, const uint64_t SimulationID)
+	{
+		return DrawObjectiveSpawnPoints(Config, Seed, SimulationID).front();
+	}
+
+
+	/**
+	 * Spawn points of the objectives of a simulation, drawn one after the other from the simulation stream.
+	 */
+	std::vector<FSimVec3> FSimulation::DrawObjectiveSpawnPoints(const FSimConfig& Config, const uint64_t Seed, const uint64_t SimulationID)
+	{
+		FSimRandom Random = FSimRandom::ForStream(Seed, SimulationID);
+		std::vector<FSimVec3> SpawnPoints(Config.ObjectiveCount);
+		for (FSimVec3& SpawnPoint : SpawnPoints)
+			SpawnPoint = FSimVec3(
+				Random.RandRange(Config.EnvSize.X * Config.ObjectiveMinDistanceRatio, Config.EnvSize.X),
+				Random.RandRange(0., Config.EnvSize.Y),
+				SimObjectiveAltitude);
+		return SpawnPoints;
+	}
+
+
+	/**
+	 * Advances every entity by one substep of Config.Step simulated seconds.
+	 *
+	 * Detection is continuous: each drone's movement over the substep is tested against the objectives' movements,
+	 * and an objective is found at the exact moment of its first contact. The time to find is the moment the
+	 * objective completing the simulation is found.
+	 *
+	 * @returns False once the simulation has ended.
+	 */
+	bool FSimulation::Step()
+	{
+		if (bHasEnded) return false;
+
+		// The grid has to be refit before the objectives move
+		for (size_t i = 0; i < Objectives.size(); i++) ObjectiveStarts[i] = ObjectiveEnds[i];
+		if (Objectives.size() > 1)
+			ObjectiveGrid.Refit(ObjectiveStarts, IsObjectiveFound, Config.ObjectiveIsMoving ? Config.ObjectiveSpeed * Config.Step : 0);
+		for (size_t i = 0; i < Objectives.size(); i++)
+		{
+			Objectives[i].Step();
+			ObjectiveEnds[i] = Objectives[i].GetPosition();
+		}
+
+		// Move every drone, then let the strategies of those that arrived pick a new destination
+		DroneBatch.StepAll(Config.Step, Config.MovementTolerance, ArrivedDrones);
+		for (const int i : ArrivedDrones)
+		{
+			const FSimVec3 Direction = DroneBatch.GetDirection(i);
+			Drones[i]->HandleBatchArrival();
+			if (Config.EnergyModel) DroneEnergies[i] -= TurnEnergyPerRadian * FSimVec3::Angle(Direction, DroneBatch.GetDirection(i));
+		}
+		if (Trajectory) RecordFrame();
+
+		FindContacts();
+		for (const std::pair<double, int>& Contact : Contacts)
+		{
+			const float ContactTime = (float)(CurrentSimulatedTime + Contact.first * Config.Step);
+			if (ContactTime > Params.MaxTimePerSim) break;
+			ObjectiveFoundTimes[Contact.second] = ContactTime;
+			IsObjectiveFound[Contact.second] = 1;
+			if (++NumFoundObjectives < Config.RequiredObjectives()) continue;
+
+			Outcome.Found = true;
+			Outcome.TimeToFind = Outcome.FlightTime = CurrentSimulatedTime = ContactTime;
+			Outcome.Consumption = MeasureConsumption();
+			bHasEnded = true;
+			return false;
+		}
+
+		CurrentSimulatedTime += Config.Step;
+		if (bTracksCoverage && ++StepsSinceStamp >= CoverageStampInterval) StampCoverage();
+		if (Config.EnergyModel) DrainBatteries();
+
+		if (CurrentSimulatedTime >= Params.MaxTimePerSim) bHasEnded = true;
+		else if (Config.EnergyModel && DroneBatch.NumActive() == 0)
+		{
+			// Nothing can be found anymore
+			Outcome.EndedDepleted = true;
+			bHasEnded = true;
+		}
+		else if (Config.CoverageEarlyStop && CurrentSimulatedTime >= NextHopelessCheck)
+		{
+			// A stall is only noticed to the tenth of coverage_stall_time, no need to check more often
+			NextHopelessCheck = CurrentSimulatedTime + Config.CoverageStallTime / 10;
+			if (!IsHopeless()) return true;
+
+			// Heuristic, see FSimCoverage::IsHopeless: drones stalled outside the objective's reach are assumed to
+			// stay there, so the simulation is counted as failed without running it until the maximum time
+			Outcome.EndedHopeless = true;
+			bHasEnded = true;
+		}
+		if (bHasEnded)
+		{
+			Outcome.FlightTime = std::min(CurrentSimulatedTime, Params.MaxTimePerSim);
+			Outcome.Consumption = MeasureConsumption();
+		}
+		return !bHasEnded;
+	}
+
+
+	/**
+	 * Lists the objectives not found yet that were seen during the last substep, each with the fraction of the
+	 * substep at which it was first seen, earliest first.
+	 *
+	 * A single objective is tested against every drone at once by the drone batch. With more, each drone is only
+	 * tested against the objectives the grid holds around its move.
+	 */
+	void FSimulation::FindContacts()
+	{
+		Contacts.clear();
+		if (Objectives.size() == 1)
+		{
+			double Alpha;
+			int Drone;
+			if (DroneBatch.FindFirstContact(ObjectiveStarts[0], ObjectiveEnds[0], Config.VisionRadius, Alpha, Drone)) Contacts.emplace_back(Alpha, 0);
+			return;
+		}
+
+		// ContactAlphas holds the earliest contact of each objective seen so far, -1 for the others
+		for (int d = 0; d < DroneBatch.Num(); d++)
+		{
+			if (!DroneBatch.IsActive(d)) continue;
+			const FSimVec3 From = DroneBatch.GetPreviousPosition(d);
+			const FSimVec3 To = DroneBatch.GetPosition(d);
+			ObjectiveGrid.ForEachNear(From, To, Config.VisionRadius, [&](const int i)
+			{
+				double Alpha;
+				if (IsObjectiveFound[i] || !FindFirstContact(From, To, ObjectiveStarts[i], ObjectiveEnds[i], Config.VisionRadius, Alpha)) return;
+				if (ContactAlphas[i] < 0) Contacts.emplace_back(0, i);
+				else if (ContactAlphas[i] <= Alpha) return;
+				ContactAlphas[i] = Alpha;
+			});
+		}
+		for (std::pair<double, int>& Contact : Contacts)
+		{
+			Contact.first = ContactAlphas[Contact.second];
+			ContactAlphas[Contact.second] = -1;
+		}
+		std::sort(Contacts.begin(), Contacts.end());
+	}
+
+
+	/**
+	 * Takes the energy of the last substep of flight from every active drone, and stops the drones left with
+	 * none: moving at the speed it actually covered its path at, plus hovering. A drone whose battery runs out
+	 * during a substep still completes it.
+	 *
+	 * Drones slow down when reaching a destination but never fly faster than the group speed, the longer jumps
+	 * of the movement rule snapping them onto a destination are not paid for.
+	 */
+	void FSimulation::DrainBatteries()
+	{
+		for (int i = 0; i < DroneBatch.Num(); i++)
+		{
+			if (!DroneBatch.IsActive(i)) continue;
+			const double Distance = FSimVec3::Dist(DroneBatch.GetPreviousPosition(i), DroneBatch.GetPosition(i));
+			const double Speed = std::min(Distance / Config.Step, (double)Params.Speed);
+			DroneEnergies[i] -= Config.MovePower(Speed, Params.BatteryCount) * Config.Step + HoverStepEnergy;
+			if (DroneEnergies[i] <= 0) DroneBatch.Deactivate(i);
+		}
+	}
+
+
+	/**
+	 * Energy the hungriest drone drew so far, in Wh, see FSimOutcome.
+	 *
+	 * With the energy model, the substep an objective is found in is not paid for, as it is cut short.
+	 */
+	float FSimulation::MeasureConsumption() const
+	{
+		if (!Config.EnergyModel) return (float)Config.FlightConsumption(Params.Speed, Params.BatteryCount, Outcome.FlightTime);
+
+		double MaxEnergy = 0;
+		for (const double Energy : DroneEnergies) MaxEnergy = std::max(MaxEnergy, Config.BatteryEnergy(Params.BatteryCount) - Energy);
+		return (float)(MaxEnergy / 60.0 / 60.0);
+	}
+
+
+	/**
+	 * Whether too few of the objectives not found yet can still be found to complete the simulation,
+	 * see FSimCoverage::IsHopeless.
+	 */
+	bool FSimulation::IsHopeless() const
+	{
+		const int RequiredObjectives = Config.RequiredObjectives();
+		int ReachableObjectives = NumFoundObjectives;
+		for (size_t i = 0; i < Objectives.size() && ReachableObjectives < RequiredObjectives; i++)
+			if (!IsObjectiveFound[i] && !Coverage.IsHopeless(ObjectiveEnds[i], CurrentSimulatedTime)) ReachableObjectives++;
+		return ReachableObjectives < RequiredObjectives;
+	}
+
+
+	/**
+	 * Records the positions of the objectives and the drones after every substep, starting with their spawn points.
+	 */
+	void FSimulation::RecordTrajectory(FSimTrajectoryBuilder* InTrajectory)
+	{
+		Trajectory = InTrajectory;
+		FramePositions.resize(Objectives.size() + DroneBatch.Num());
+		if (Trajectory) RecordFrame();
+	}
+
+
+	/**
+	 * Maintains the coverage map of the zones from now on, starting with the current drone positions.
+	 *
+	 * Always on with coverage_early_stop, which needs it.
+	 */
+	void FSimulation::TrackCoverage()
+	{
+		std::vector<FSimZone> Zones;
+		Zones.reserve(Drones.size());
+		for (const auto& Drone : Drones) Zones.push_back(Drone->GetAssignedZone());
+		Coverage.Reset(Config, Zones);
+		bTracksCoverage = true;
+		CoverageStampInterval = std::max(1, (int)(Coverage.GetStampDistance() / (Params.Speed * Config.Step)));
+		StampCoverage();
+	}
+
+
+	void FSimulation::StampCoverage()
+	{
+		StepsSinceStamp = 0;
+		for (int i = 0; i < DroneBatch.Num(); i++) Coverage.Stamp(i, DroneBatch.GetPosition(i), CurrentSimulatedTime);
+	}
+
+
+	void FSimulation::RecordFrame()
+	{
+		std::copy(ObjectiveEnds.begin(), ObjectiveEnds.end(), FramePositions.begin());
+		for (int i = 0; i < DroneBatch.Num(); i++) FramePositions[Objectives.size() + i] = DroneBatch.GetPosition(i);
+		Trajectory->AddFrame(FramePositions);
+	}
+
+
+	/**
+	 * Steps the simulation until its end.
+	 */
+	FSimOutcome FSimulation::Run()
+	{
+		while (Step()) {}
+		return Outcome;
+	}
+}
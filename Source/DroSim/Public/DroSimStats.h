@@ -0,0 +1,46 @@
+#pragma once
+
+#include "CoreMinimal.h"
+#include "Stats/Stats.h"
+#include "ProfilingDebugging/CpuProfilerTrace.h"
+#include "ProfilingDebugging/CsvProfiler.h"
+
+/*
+ * Instrumentation of the simulation loop.
+ *
+ * "stat DroSim" shows the timings and counters in game, Insights captures show the same scopes on the CPU track,
+ * and "csvprofile start" records the DroSim CSV category alongside the engine stats.
+ */
+
+DECLARE_STATS_GROUP(TEXT("DroSim"), STATGROUP_DroSim, STATCAT_Advanced);
+
+// Timings
+DECLARE_CYCLE_STAT_EXTERN(TEXT("Manager Tick"), STAT_DroSim_ManagerTick, STATGROUP_DroSim, DROSIM_API);
+DECLARE_CYCLE_STAT_EXTERN(TEXT("Init Simulation"), STAT_DroSim_InitSimulation, STATGROUP_DroSim, DROSIM_API);
+DECLARE_CYCLE_STAT_EXTERN(TEXT("Handle Simulation End"), STAT_DroSim_HandleSimulationEnd, STATGROUP_DroSim, DROSIM_API);
+DECLARE_CYCLE_STAT_EXTERN(TEXT("Spawn Drones"), STAT_DroSim_SpawnDrones, STATGROUP_DroSim, DROSIM_API);
+DECLARE_CYCLE_STAT_EXTERN(TEXT("Assign Zones"), STAT_DroSim_AssignZones, STATGROUP_DroSim, DROSIM_API);
+DECLARE_CYCLE_STAT_EXTERN(TEXT("Random Step"), STAT_DroSim_RandomStep, STATGROUP_DroSim, DROSIM_API);
+DECLARE_CYCLE_STAT_EXTERN(TEXT("Random New Destination"), STAT_DroSim_RandomNewDestination, STATGROUP_DroSim, DROSIM_API);
+DECLARE_CYCLE_STAT_EXTERN(TEXT("Sweep Step"), STAT_DroSim_SweepStep, STATGROUP_DroSim, DROSIM_API);
+DECLARE_CYCLE_STAT_EXTERN(TEXT("Sweep New Destination"), STAT_DroSim_SweepNewDestination, STATGROUP_DroSim, DROSIM_API);
+DECLARE_CYCLE_STAT_EXTERN(TEXT("Spiral Step"), STAT_DroSim_SpiralStep, STATGROUP_DroSim, DROSIM_API);
+DECLARE_CYCLE_STAT_EXTERN(TEXT("Spiral New Destination"), STAT_DroSim_SpiralNewDestination, STATGROUP_DroSim, DROSIM_API);
+DECLARE_CYCLE_STAT_EXTERN(TEXT("Detect Objectives"), STAT_DroSim_DetectObjectives, STATGROUP_DroSim, DROSIM_API);
+
+// Counters, reset every frame
+DECLARE_DWORD_COUNTER_STAT_EXTERN(TEXT("Substeps"), STAT_DroSim_Substeps, STATGROUP_DroSim, DROSIM_API);
+DECLARE_DWORD_COUNTER_STAT_EXTERN(TEXT("Detection Checks"), STAT_DroSim_DetectionChecks, STATGROUP_DroSim, DROSIM_API);
+DECLARE_DWORD_COUNTER_STAT_EXTERN(TEXT("Destination Retries"), STAT_DroSim_DestinationRetries, STATGROUP_DroSim, DROSIM_API);
+
+// Totals of the sweep, and coverage of the current simulation
+DECLARE_DWORD_ACCUMULATOR_STAT_EXTERN(TEXT("Sims Completed"), STAT_DroSim_SimsCompleted, STATGROUP_DroSim, DROSIM_API);
+DECLARE_FLOAT_ACCUMULATOR_STAT_EXTERN(TEXT("Sims Per Second"), STAT_DroSim_SimsPerSecond, STATGROUP_DroSim, DROSIM_API);
+DECLARE_FLOAT_ACCUMULATOR_STAT_EXTERN(TEXT("Coverage %"), STAT_DroSim_Coverage, STATGROUP_DroSim, DROSIM_API);
+
+CSV_DECLARE_CATEGORY_MODULE_EXTERN(DROSIM_API, DroSim);
+
+/** Times a scope both as a DroSim stat and as an Insights CPU event of the same name. */
+#define DROSIM_SCOPE(Name) \
+	SCOPE_CYCLE_COUNTER(STAT_DroSim_##Name); \
+	TRACE_CPUPROFILER_EVENT_SCOPE(DroSim_##Name)
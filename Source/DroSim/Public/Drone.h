@@ -3,6 +3,8 @@
 #include "CoreMinimal.h"
 #include "IManagerInterface.h"
 #include "GameFramework/Actor.h"
+#include "SimCore/SimConfig.h"
+#include "SimCore/SimRandom.h"
 #include "Drone.generated.h"
 
 UCLASS()
@@ -16,12 +18,12 @@ public:
 protected:
 	virtual void BeginPlay() override;
 	virtual void SetNewDestination();
+	virtual void ResetStrategyState() {}
 	
 	void SetDestinationManual(const FVector& NewDestination);
 	bool IsOutOfBounds(const FVector& Point) const;
-	void LoadConfig();
+	bool IsRejected(const FVector& Point) const;
 
-	int SimulationSpeed;
 	float TickInterval;
 	float GroundOffset;
 	
@@ -46,16 +48,25 @@ protected:
 	float LeftYBound;
 
 	FVector CalculatedPosition;
+
+	// Own random stream, keyed by (sweep seed, simulation ID, drone ID)
+	DroSimCore::FSimRandom Random;
 	
 public:
-	virtual void Tick(float DeltaTime) override;
+	virtual void StepSimulation();
+	void ApplyConfig(const DroSimCore::FSimConfig& Config);
+	void ResetForSimulation(const int NewID, IManagerInterface* NewManager, const FBox2D& NewZone, const DroSimCore::FSimRandom& NewRandom);
+	void SetPooledActive(const bool bActive);
+	const FVector& GetCalculatedPosition() const { return CalculatedPosition; }
+	const FVector& GetMoveDirection() const { return MoveDirection; }
 	int ID = -1;
 	IManagerInterface* Manager;
-	std::vector<FVector2D> AssignedZone;
+	FBox2D AssignedZone;
 
 private:
 	bool Init = true;
 	
+	// Drones have no mesh of their own, the manager draws them all as instances of a single mesh
 	UPROPERTY(VisibleAnywhere)
-	UStaticMeshComponent* StaticMesh;
+	USceneComponent* SceneRoot;
 };
\ No newline at end of file
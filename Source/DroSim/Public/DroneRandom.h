@@ -8,6 +8,6 @@ UCLASS()
 class DROSIM_API ADroneRandom : public ADrone
 {
 	GENERATED_BODY()
-	virtual void Tick(float DeltaTime) override;
+	virtual void StepSimulation() override;
 	virtual void SetNewDestination() override;
 };
@@ -8,11 +8,13 @@ UCLASS()
 class DROSIM_API ADroneSpiral : public ADrone
 {
 	GENERATED_BODY()
-	virtual void Tick(float DeltaTime) override;
+	virtual void StepSimulation() override;
 	virtual void SetNewDestination() override;
+	virtual void ResetStrategyState() override;
 	void SetCircle();
 	void GetRandomDirection();
-	int Wander = WanderSteps;
+	// Set by ResetStrategyState, once the config is applied
+	int Wander = 0;
 	int Precision = 0;
 
 	FVector HotSpot;
@@ -8,8 +8,9 @@ UCLASS()
 class DROSIM_API ADroneSweep : public ADrone
 {
 	GENERATED_BODY()
-	virtual void Tick(float DeltaTime) override;
+	virtual void StepSimulation() override;
 	virtual void SetNewDestination() override;
+	virtual void ResetStrategyState() override;
 	bool GoesUp = true;
 	bool TopToBottom = false;
 	bool LeftToRight = true;
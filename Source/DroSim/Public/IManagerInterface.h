@@ -3,8 +3,8 @@
 class IManagerInterface
 {
 public:
-	virtual void ObjectiveFound() = 0;
 	virtual float GetGroupDroneSpeed() = 0;
-	virtual bool IsObjectiveNear(const FVector& DronePos) = 0;
+	virtual void DetectObjectives(const FVector& From, const FVector& To) = 0;
 	virtual float GetVisionRadius() = 0;
+	virtual bool IsRenderEnabled() = 0;
 };
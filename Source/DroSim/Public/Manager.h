@@ -2,9 +2,21 @@
 
 #include "CoreMinimal.h"
 #include "GameFramework/Actor.h"
+#include "Components/InstancedStaticMeshComponent.h"
+#include "Components/LineBatchComponent.h"
 #include "Drone.h"
 #include "IManagerInterface.h"
 #include "Objective.h"
+#include "SimCore/SimCheckpoint.h"
+#include "SimCore/SimConfig.h"
+#include "SimCore/SimCoverage.h"
+#include "SimCore/SimGroupCache.h"
+#include "SimCore/SimObjectiveGrid.h"
+#include "SimCore/SimRandom.h"
+#include "SimCore/SimRecords.h"
+#include "SimCore/SimSearch.h"
+#include "SimCore/SimZones.h"
+#include "SimCore/Simulation.h"
 #include "Manager.generated.h"
 
 UCLASS()
@@ -12,90 +24,153 @@ class DROSIM_API AManager : public AActor, public IManagerInterface
 {
 	GENERATED_BODY()
 	
-#define DRONEWEIGHT(BatCount) (InitialWeight+BatteryWeight*BatCount)
-	
 public:
 	AManager();
 
 protected:
 	virtual void BeginPlay() override;
+	virtual void EndPlay(const EEndPlayReason::Type EndPlayReason) override;
 	void LoadConfig();
 	void InitSimulation();
+	void StepSimulation();
+	void DrainBattery(const int DroneIndex, const FVector& PreviousPosition, const FVector& PreviousDirection);
+	void UpdateThroughputStats();
+	void ResetCoverage();
+	void StampCoverage();
+	bool IsHopeless() const;
+	float GetCompletionTime() const;
+	void ObjectiveFound();
 	bool DroneDestroyedEvent();
 	void HandleSimulationEnd();
-	void MutateSimulationParameters(const bool IsGroupSuccessful);
-	float CalculateMaximumAutonomy() const;
-	void CalculateMinBatteryCountForGroup();
-	static void ThrowUnexpectedWarning(const wchar_t* Text);
+	void RecordSimulation(const DroSimCore::FSimOutcome& Outcome);
+	void RefreshGroupParams();
+	void EndGroup(const DroSimCore::FSimGroupOutcome& Outcome);
+	bool ApplyCachedGroup();
+	void EndSweep();
+	void SaveCheckpoint();
+	bool LoadCheckpoint(int64& OutRecordsSize);
 	void ManageNewSimulation();
 	void SpawnDrones(const TSubclassOf<ADrone> DroneStrategy);
-	void WriteResultsToFile();
-	void DrawDebugBoxFromDiagonalPoints(const FVector2D& TopLeft, const FVector2D& BottomRight, const FColor& Color, const int& Thickness);
-	TArray<std::vector<FVector2D>> AssignZones();
-	void PrintSimConfigRecap() const;
+	ADrone* AcquireDrone(const TSubclassOf<ADrone> DroneStrategy, const FVector& Location);
+	void ReleaseDrone(ADrone* Drone);
+	AObjective* AcquireObjective(const FVector& Location);
+	void ReleaseObjective(AObjective* Objective);
+	void DrawEnvironment();
+	void DrawDrones();
+	void DrawVisionCircles();
+	void DrawCoreSimulation();
+	static void AddBoxLines(TArray<FBatchedLine>& Lines, const FVector& Min, const FVector& Max, const FColor& Color, const float Thickness);
 	
 public:
 	virtual void Tick(float DeltaTime) override;
-	virtual void ObjectiveFound() override;
 	virtual float GetGroupDroneSpeed() override;
-	virtual bool IsObjectiveNear(const FVector& DronePos) override;
+	virtual void DetectObjectives(const FVector& From, const FVector& To) override;
 	virtual float GetVisionRadius() override;
+	virtual bool IsRenderEnabled() override { return bIsRenderEnabled; }
+	float GetCoverage() const;
 
 private:
+	std::shared_ptr<const DroSimCore::FSimConfig> Config;
+	
 	FVector2D EnvSize;
-	FVector ObjectiveSpawnPoint;
 	float ObjectiveMinDistanceRatio;
-	int ColMax;
 
 	int StrategyID;
+
+	// Zones of the current drone count, from the shared cache, and the ones the environment lines were drawn for
+	const std::vector<DroSimCore::FSimZone>* CurrentZones = nullptr;
+	const std::vector<DroSimCore::FSimZone>* DrawnZones = nullptr;
 	float DronesGroundOffset;
 
-	float MinSpeed;
-	float MaxSpeed;
-	int MinNumDrones;
-	int MaxNumDrones;
+	// Group-to-group search shared with DroSimCli, see search_mode. The parameters of its current group are
+	// copied below by RefreshGroupParams
+	std::unique_ptr<DroSimCore::FSimSearch> Search;
 	float GroupSpeed;
 	int GroupNumDrones;
-	float BatteryCapacity;
-	float BatteryWeight;
-	int MinBatteryCount;
-	int MaxBatteryCount;
 	int GroupBatteryCount;
-	float InitialWeight;
-	float CurrentConsumption;
 	float VisionRadius;
-
-	float SpeedIncrement;
-	int DroneIncrement;
 	
 	float TickInterval;
-	float CurrentSimulatedTime;
+	float CurrentSimulatedTime = 0;
+	double StepAccumulator = 0;
+	bool bIsMaxThroughput = false;
+	float FrameBudgetMs;
+	int MaxStepsPerFrame;
+	double ThroughputWindowStart = 0;
+	int ThroughputWindowSims = 0;
+
+	// Ground seen by the drones of the current simulation, stamped every CoverageStampInterval substeps
+	DroSimCore::FSimCoverage Coverage;
+	int CoverageStampInterval = 1;
+	int StepsSinceCoverageStamp = 0;
+	float NextHopelessCheck = 0;
 	float MaxTimePerSim;
 	int SimulationSpeed;
 	int LinesThickness;
 	
+	// ID of the next simulation, and the number of simulations run, or read from the cache, in earlier groups
 	int SimID = 0;
+	int SimulationCount = 0;
+	// Equal to SimID once the current simulation is counted as successful
 	int ReportedSimID = 0;
+	uint32 SweepSeed = 0;
+	uint64 StreamSimulationID = 0;
+	DroSimCore::FSimRandom SimulationRandom;
+	DroSimCore::FSimRecordWriter RecordWriter;
+	int GroupID = 0;
+	std::string CheckpointPath;
+	double NextCheckpointTime = 0;
+	// Outcomes of the current group so far, stored in the group cache once it ends
+	DroSimCore::FSimGroupCache GroupCache;
+	std::vector<DroSimCore::FSimOutcome> GroupOutcomes;
+	int GroupFirstSimID = 0;
 	int SimGroupSize;
 	int CurrentGroupSim = 0;
 	int SuccessfulSim = 0;
 	float SummedTimesToFind = 0;
-	bool IsCurveFound = false;
-	bool IsMaxFound = false;
-
-	float PreviousSpeed = -1;
-	int PreviousNumDrones = -1;
-	int PreviousBatteryCount = -1;
-	bool WasPreviousConfigSuccessful = false;
 
 	bool SimulationHasEnded = false;
 
-	std::vector<float> FastConfig;
-	TArray<std::vector<float>> SlowConfigs;
+	// Core backend: the current simulation only exists as data, no drone or objective actors are spawned
+	bool bUsesCoreBackend = false;
+	std::unique_ptr<DroSimCore::FSimulation> CoreSimulation;
 
-	AObjective* CurrentSimulatedObjective;
+	// Objectives of the current simulation and their paths over the current substep, which starts at
+	// SubstepStartTime. Found times are negative until found
+	TArray<AObjective*> CurrentSimulatedObjectives;
+	std::vector<float> ObjectiveFoundTimes;
+	std::vector<uint8_t> IsObjectiveFound;
+	int NumFoundObjectives = 0;
+	DroSimCore::FSimObjectiveGrid ObjectiveGrid;
+	std::vector<DroSimCore::FSimVec3> ObjectiveStarts;
+	std::vector<DroSimCore::FSimVec3> ObjectiveEnds;
+	float SubstepStartTime = 0;
 	TArray<ADrone*> CurrentSimulatedDrones;
+
+	// Energy model only: energy left in the batteries of each current drone, in J, see DrainBattery
+	TArray<double> DroneEnergies;
+	int NumActiveDrones = 0;
+	double DroneHoverStepEnergy = 0;
+	double DroneTurnEnergyPerRadian = 0;
+
+	// Actors kept alive between simulations instead of being destroyed and spawned again
+	TMap<UClass*, TArray<ADrone*>> DronePool;
+	TArray<AObjective*> ObjectivePool;
 	
+	// Visual mode only: environment and zones, redrawn per simulation, and drones and vision circles, redrawn per tick
+	bool bIsRenderEnabled = true;
+	TArray<FBatchedLine> FrameLines;
+	TArray<FTransform> DroneTransforms;
+
 	UPROPERTY(VisibleAnywhere)
 	UStaticMeshComponent* StaticMesh;
+
+	UPROPERTY(VisibleAnywhere)
+	UInstancedStaticMeshComponent* DroneMeshes;
+
+	UPROPERTY(VisibleAnywhere)
+	ULineBatchComponent* EnvironmentLines;
+
+	UPROPERTY(VisibleAnywhere)
+	ULineBatchComponent* VisionLines;
 };
@@ -3,6 +3,7 @@
 #include "CoreMinimal.h"
 #include "Components/SphereComponent.h"
 #include "GameFramework/Actor.h"
+#include "SimCore/SimConfig.h"
 #include "Objective.generated.h"
 
 UCLASS()
@@ -15,20 +16,24 @@ public:
 
 protected:
 	virtual void BeginPlay() override;
-	void LoadConfig();
 
 public:	
-	virtual void Tick(float DeltaTime) override;
+	void StepSimulation();
+	void SyncActor();
+	const FVector& GetCalculatedPosition() const { return CalculatedPosition; }
+	void ApplyConfig(const DroSimCore::FSimConfig& Config);
+	void ResetForSimulation(const FVector& SpawnPoint);
+	void SetPooledActive(const bool bActive);
 
 private:
-	float MovementSpeed;
-	float YLimit;
-	float CollisionCheckRadius;
-	float TickInterval;
-	bool IsMoving;
-	int SimulationSpeed;
+	float MovementSpeed = 0;
+	float YLimit = 0;
+	float CollisionCheckRadius = 0;
+	float TickInterval = 1;
+	bool IsMoving = false;
 	
 	FVector MoveDirection = FVector(0,1.0f,0);
+	FVector CalculatedPosition;
 
 	UPROPERTY(VisibleAnywhere)
 	UStaticMeshComponent* StaticMesh;
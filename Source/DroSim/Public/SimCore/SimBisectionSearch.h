@@ -0,0 +1,59 @@
+#pragma once
+
+#include <map>
+
+#include "SimSearch.h"
+
+namespace DroSimCore
+{
+	/**
+	 * Finds, for every drone count, the lowest successful speed on a grid of speed_resolution steps by bisection.
+	 *
+	 * Success is assumed to be monotonic in speed. Until a threshold is known, a drone count gallops
+	 * upwards from min_speed in doubling steps until a group succeeds, then bisects back down. Following
+	 * counts warm-start from the previous count's threshold: they gallop downwards from it until a group
+	 * fails, then bisect the bracket. With monotonic success, the recorded speed is the lowest successful one,
+	 * found in O(log n) groups per drone count.
+	 *
+	 * The curve is not the one of FSimLinearSearch, which walks the speeds one by one and stops at the first
+	 * failure. Known differences, which DroSimCli --compare-search reports on a given config:
+	 * - When the first group of a drone count fails, the linear walk records the speed and battery count of
+	 *   its last success, at the previous drone count, which were never run at the new one. This search
+	 *   gallops upwards to a speed that succeeds at that count, or records nothing when none does.
+	 * - Where success is not monotonic in speed, as when faster drones run out of autonomy first, bisection
+	 *   may settle on a different successful speed than the linear walk, or miss the only successful ones.
+	 * - Speeds are taken on a grid of speed_resolution, the linear walk steps by speed_increment.
+	 */
+	class FSimBisectionSearch : public FSimSearch
+	{
+	public:
+		explicit FSimBisectionSearch(const FSimConfig& InConfig);
+
+		virtual bool IsFinished() const override { return GroupNumDrones >= Config.MaxNumDrones; }
+		virtual FSimGroupParams GetGroupParams() const override;
+		virtual void ReportGroup(const FSimGroupOutcome& GroupOutcome) override;
+		virtual void Serialize(FSimArchive& Ar) override;
+
+	private:
+		float GetSpeed(const int Index) const { return Config.MinSpeed + Index * SpeedResolution; }
+		void StartDroneCount();
+		void EndDroneCount(bool HasThreshold);
+		void SetFastConfig(int BatteryCount);
+
+		float SpeedResolution;
+		int TopIndex;
+
+		int GroupNumDrones;
+		int ProbeIndex = 0;
+
+		// Highest failed and lowest successful speed indices for the current drone count (-1 when unknown)
+		int FailIndex = -1;
+		int SuccessIndex = -1;
+		bool IsWarmStarted = false;
+		int GallopStep = 1;
+		bool IsProbingFastConfig = false;
+		std::map<int, int> SuccessBatteryCounts;
+
+		int PreviousThreshold = -1;
+	};
+}
@@ -0,0 +1,134 @@
+#pragma once
+
+#include <cstdint>
+#include <map>
+#include <string>
+#include <type_traits>
+#include <vector>
+
+#include "SimConfig.h"
+#include "SimResults.h"
+
+namespace DroSimCore
+{
+	/**
+	 * Saves or loads state as raw bytes, in the manner of FArchive: a single Serialize function describes the
+	 * fields once, in the same order for both directions.
+	 *
+	 * Plain values are copied as they are in memory, checkpoints are only meant to be read on the machine and
+	 * build that wrote them.
+	 */
+	class FSimArchive
+	{
+	public:
+		FSimArchive(std::vector<uint8_t>& InBytes, const bool bInIsLoading)
+			: Bytes(InBytes)
+			, bIsLoading(bInIsLoading)
+		{
+		}
+
+		bool IsLoading() const { return bIsLoading; }
+
+		/** False once a load has run out of bytes, the values read since are not valid. */
+		bool IsOk() const { return bIsOk; }
+
+		/** True when a load read every byte, and no more. */
+		bool IsAtEnd() const { return bIsOk && Offset == Bytes.size(); }
+
+		template <typename T>
+		FSimArchive& operator<<(T& Value)
+		{
+			static_assert(std::is_trivially_copyable<T>::value, "Only plain values are archived as raw bytes");
+			Serialize(&Value, sizeof(T));
+			return *this;
+		}
+
+		template <typename T>
+		FSimArchive& operator<<(std::vector<T>& Values)
+		{
+			uint64_t Count = Values.size();
+			*this << Count;
+			if (bIsLoading)
+			{
+				// Every element takes at least a byte, a larger count is corrupted data
+				if (!bIsOk || Count > Bytes.size() - Offset)
+				{
+					bIsOk = false;
+					return *this;
+				}
+				Values.resize((size_t)Count);
+			}
+			for (T& Value : Values) *this << Value;
+			return *this;
+		}
+
+		template <typename K, typename V>
+		FSimArchive& operator<<(std::map<K, V>& Map)
+		{
+			std::vector<std::pair<K, V>> Entries(Map.begin(), Map.end());
+			uint64_t Count = Entries.size();
+			*this << Count;
+			if (bIsLoading)
+			{
+				if (!bIsOk || Count > Bytes.size() - Offset)
+				{
+					bIsOk = false;
+					return *this;
+				}
+				Entries.resize((size_t)Count);
+			}
+			for (std::pair<K, V>& Entry : Entries) *this << Entry.first << Entry.second;
+			if (bIsLoading) Map = std::map<K, V>(Entries.begin(), Entries.end());
+			return *this;
+		}
+
+		FSimArchive& operator<<(FSimResults& Results)
+		{
+			return *this << Results.HasFastConfig << Results.FastConfig << Results.SlowConfigs;
+		}
+
+	private:
+		void Serialize(void* Data, size_t Size);
+
+		std::vector<uint8_t>& Bytes;
+		size_t Offset = 0;
+		bool bIsLoading;
+		bool bIsOk = true;
+	};
+
+	uint64_t HashBytes(const uint8_t* Data, size_t Size);
+	bool WriteFileAtomically(const std::string& Path, const std::vector<uint8_t>& Bytes, std::string& OutError);
+
+	/** Frontend a checkpoint was saved by. */
+	enum class ESimCheckpointProducer : uint8_t
+	{
+		Cli,
+		Engine
+	};
+
+	/**
+	 * State of a parameter search between two groups, enough to continue it with the same results.
+	 *
+	 * Simulations draw their random streams from the seed and their simulation ID, so NextSimulationID is the
+	 * position of every random stream of the sweep. SearchState is written by the search of SearchMode, see
+	 * FSimSearch::Serialize, and RecordsSize is the length of the records file at that point, -1 without one.
+	 */
+	struct FSimCheckpoint
+	{
+		ESimCheckpointProducer Producer = ESimCheckpointProducer::Cli;
+		ESimSearchMode SearchMode = ESimSearchMode::Linear;
+		uint64_t ConfigHash = 0;
+		uint32_t Seed = 0;
+		uint64_t NextSimulationID = 0;
+		int GroupCount = 0;
+		int SimulationCount = 0;
+		int64_t RecordsSize = -1;
+		std::vector<uint8_t> SearchState;
+
+		void Serialize(FSimArchive& Ar);
+		bool Matches(ESimCheckpointProducer InProducer, const FSimConfig& Config, std::string& OutError) const;
+
+		bool Save(const std::string& Path, std::string& OutError) const;
+		bool Load(const std::string& Path, std::string& OutError);
+	};
+}
@@ -0,0 +1,201 @@
+#pragma once
+
+#include <cstdint>
+#include <map>
+#include <memory>
+#include <string>
+
+#include "SimMath.h"
+
+namespace DroSimCore
+{
+	/** Drone strategies, same IDs as the "strategy" key of SimConfig.ini. */
+	enum class ESimStrategy : int
+	{
+		Random = 1,
+		Sweep = 2,
+		Spiral = 3
+	};
+
+	/** How the manager walks the speed axis for each drone count, "search_mode" key of SimConfig.ini. */
+	enum class ESimSearchMode : int
+	{
+		Linear,
+		Bisection
+	};
+
+	/** What the engine simulates drones and objectives with, "backend" key of SimConfig.ini. */
+	enum class ESimBackend : int
+	{
+		Actors,
+		Core
+	};
+
+	/** How the environment is divided in search zones, "partition" key of SimConfig.ini. */
+	enum class ESimPartition : int
+	{
+		Grid,
+		Strips,
+		Balanced
+	};
+
+	/** When a group of simulations may stop before sim_group_size replicas, "early_stopping" key of SimConfig.ini. */
+	enum class ESimEarlyStopping : int
+	{
+		None,
+		Settled,
+		Sprt
+	};
+
+	/** How many objectives a simulation has to find to be successful, "completion" key of SimConfig.ini. */
+	enum class ESimCompletion : int
+	{
+		First,
+		Count,
+		All
+	};
+
+	/**
+	 * Raw key/value content of an .ini file, indexed by section then key.
+	 */
+	class FSimIniFile
+	{
+	public:
+		bool LoadFile(const std::string& Path);
+		bool LoadString(const std::string& Content);
+
+		bool GetString(const std::string& Section, const std::string& Key, std::string& OutValue) const;
+		bool GetFloat(const std::string& Section, const std::string& Key, float& OutValue) const;
+		bool GetDouble(const std::string& Section, const std::string& Key, double& OutValue) const;
+		bool GetInt(const std::string& Section, const std::string& Key, int& OutValue) const;
+		bool GetUInt64(const std::string& Section, const std::string& Key, uint64_t& OutValue) const;
+		bool GetBool(const std::string& Section, const std::string& Key, bool& OutValue) const;
+
+		uint64_t Hash() const;
+
+	private:
+		std::map<std::string, std::map<std::string, std::string>> Sections;
+	};
+
+	/**
+	 * Typed content of SimConfig.ini.
+	 *
+	 * Default values are the ones shipped in Content/SimConfig.ini. The file is parsed and validated once,
+	 * then the snapshot is shared read-only by the manager, the drones and the objective.
+	 */
+	struct FSimConfig
+	{
+		// sim/global
+		float Step = 1;
+		int SimulationSpeed = 100;
+		FSimVec2 EnvSize = FSimVec2(15000, 15000);
+		int LinesThickness = 20;
+		bool IsRenderEnabled = true;
+		bool IsMaxThroughput = false;
+		float FrameBudgetMs = 12;
+		int MaxStepsPerFrame = 10000;
+		ESimBackend Backend = ESimBackend::Actors;
+
+		// sim/manager
+		int EnvMaxColumns = 3;
+		ESimPartition Partition = ESimPartition::Grid;
+		int MinNumDrones = 1;
+		int MaxNumDrones = 8;
+		float SpeedIncrement = 2;
+		int DroneIncrement = 1;
+		int SimGroupSize = 6;
+		int WorkerThreads = 0;
+		uint32_t Seed = 0;
+		bool CommonRandomNumbers = false;
+		std::string RecordsFile;
+		std::string TrajectoryFile;
+		std::string CheckpointFile;
+		float CheckpointInterval = 60;
+		std::string CacheDir;
+		ESimSearchMode SearchMode = ESimSearchMode::Linear;
+		float SpeedResolution = 2;
+		ESimEarlyStopping EarlyStopping = ESimEarlyStopping::None;
+		double SprtAlpha = .05;
+		double SprtBeta = .05;
+		double SprtIndifference = .2;
+		bool CoverageEarlyStop = false;
+		float CoverageStallTime = 1800;
+
+		// sim/drones
+		ESimStrategy Strategy = ESimStrategy::Sweep;
+		float GroundOffset = 250;
+		float MovementTolerance = 10;
+		float MovementDistance = 500;
+		float VisionRadius = 1000;
+		float MinSpeed = 14;
+		float MaxSpeed = 28;
+		float BatteryCapacity = 300;
+		float BatteryWeight = .5f;
+		int MinBatteryCount = 1;
+		int MaxBatteryCount = 3;
+		float InitialWeight = 3.5f;
+		bool EnergyModel = false;
+		float HoverPower = 0;
+		float TurnEnergy = 0;
+
+		// sim/drones/spiral
+		int NbCirclePoints = 8;
+		float SpiralRadius = 750;
+		float WanderDistance = 1000;
+		int WanderSteps = 5;
+		float SpiralIncrementFactor = 3;
+		bool DrawsConcentricCircles = false;
+
+		// sim/drones/sweep
+		float SweepHeight = 1500;
+		bool UsesSweepOracle = false;
+
+		// sim/objective
+		bool ObjectiveIsMoving = true;
+		float ObjectiveSpeed = 1;
+		float ObjectiveMinDistanceRatio = .3f;
+		float ObjectiveCollisionCheckRadius = 0;
+		int ObjectiveCount = 1;
+		ESimCompletion Completion = ESimCompletion::First;
+		int CompletionCount = 1;
+
+		// Hash of every key and value the configuration was loaded from, 0 for the defaults
+		uint64_t IniHash = 0;
+
+		/** Weight of a drone carrying the given number of batteries. */
+		float DroneWeight(const int BatteryCount) const { return InitialWeight + BatteryWeight * BatteryCount; }
+
+		/** Energy stored in the given number of batteries, in J. */
+		double BatteryEnergy(const int BatteryCount) const { return 60 * 60 * BatteryCapacity * BatteryCount; }
+
+		/** Power drawn by a drone carrying the given number of batteries to move at the given speed, in W: speed² times half the weight. */
+		double MovePower(const double Speed, const int BatteryCount) const { return std::pow(Speed, 2) * DroneWeight(BatteryCount) / 2.0; }
+
+		/**
+		 * Power drawn by a drone carrying the given number of batteries in level flight, in W: MovePower, plus
+		 * hover_power per kg with the energy model.
+		 */
+		double FlightPower(const float Speed, const int BatteryCount) const
+		{
+			return MovePower(Speed, BatteryCount) + (EnergyModel ? HoverPower * DroneWeight(BatteryCount) : 0.0);
+		}
+
+		/** Energy drawn by a drone carrying the given number of batteries over a level flight of FlightTime seconds, in Wh. */
+		double FlightConsumption(const float Speed, const int BatteryCount, const double FlightTime) const
+		{
+			return FlightTime / 60.0 / 60.0 * FlightPower(Speed, BatteryCount);
+		}
+
+		/** Number of objectives found that makes a simulation successful. */
+		int RequiredObjectives() const
+		{
+			return Completion == ESimCompletion::First ? 1 : Completion == ESimCompletion::Count ? CompletionCount : ObjectiveCount;
+		}
+
+		bool LoadFromIni(const FSimIniFile& Ini, std::string& OutError);
+		bool LoadFromFile(const std::string& Path, std::string& OutError);
+		bool Validate(std::string& OutError) const;
+
+		static std::shared_ptr<const FSimConfig> LoadShared(const std::string& Path, std::string& OutError);
+	};
+}
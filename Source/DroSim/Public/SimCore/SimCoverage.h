@@ -0,0 +1,61 @@
+#pragma once
+
+#include <cstdint>
+#include <vector>
+
+#include "SimConfig.h"
+#include "SimMath.h"
+#include "SimZones.h"
+
+namespace DroSimCore
+{
+	/**
+	 * Raster of the ground seen by the drones, one bitset per search zone.
+	 *
+	 * Cells are half a vision radius wide and count as covered once their centre was within the vision radius of
+	 * the drone of the zone. A disc is stamped as one span of columns per row, set 64 cells at a time, and the
+	 * number of covered cells is kept up to date from the bits that actually flipped.
+	 *
+	 * It also tells when a simulation is hopeless: every drone that could reach the objective has stopped
+	 * covering new ground for coverage_stall_time, without ever getting close to where the objective can be.
+	 */
+	class FSimCoverage
+	{
+	public:
+		void Reset(const FSimConfig& Config, const std::vector<FSimZone>& Zones);
+
+		void Stamp(int Zone, const FSimVec3& Position, float Time);
+
+		/** Distance a drone may move between two stamps, the coverage is then off by at most a cell. */
+		double GetStampDistance() const { return CellSize / 2; }
+
+		double GetCoverage() const;
+		double GetZoneCoverage(int Zone) const;
+		bool IsHopeless(const FSimVec3& ObjectivePosition, float Time) const;
+
+	private:
+		struct FZoneMap
+		{
+			FSimVec2 Min;
+			FSimVec2 Max;
+			int Rows = 0;
+			int Columns = 0;
+			int WordsPerRow = 0;
+			std::vector<uint64_t> Bits;
+			int CoveredCells = 0;
+			float LastGrowthTime = 0;
+		};
+
+		int SetSpan(FZoneMap& Map, int Row, int FirstColumn, int LastColumn);
+		bool HasCoveredCellIn(const FZoneMap& Map, const FSimVec2& Min, const FSimVec2& Max) const;
+
+		std::vector<FZoneMap> Maps;
+		double CellSize = 0;
+		double VisionRadius = 0;
+		bool IsObjectiveMoving = false;
+		double EnvSizeY = 0;
+		float StallTime = 0;
+		int TotalCells = 0;
+		int TotalCoveredCells = 0;
+	};
+}
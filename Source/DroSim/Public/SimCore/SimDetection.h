@@ -0,0 +1,27 @@
+#pragma once
+
+#include "SimMath.h"
+
+namespace DroSimCore
+{
+	/**
+	 * Continuous detection over one step.
+	 *
+	 * The drone moves linearly from DroneStart to DroneEnd while the objective moves linearly from
+	 * ObjectiveStart to ObjectiveEnd over the same step. Finds the earliest moment the distance between
+	 * them is at most Radius.
+	 *
+	 * @param OutAlpha Fraction of the step, in [0, 1], at which the first contact happens.
+	 * @returns True if the objective is seen at some point during the step.
+	 */
+	bool FindFirstContact(const FSimVec3& DroneStart, const FSimVec3& DroneEnd,
+		const FSimVec3& ObjectiveStart, const FSimVec3& ObjectiveEnd,
+		double Radius, double& OutAlpha);
+
+	/** Same as FindFirstContact for a static objective. */
+	inline bool FindFirstContact(const FSimVec3& DroneStart, const FSimVec3& DroneEnd, const FSimVec3& Objective,
+		const double Radius, double& OutAlpha)
+	{
+		return FindFirstContact(DroneStart, DroneEnd, Objective, Objective, Radius, OutAlpha);
+	}
+}
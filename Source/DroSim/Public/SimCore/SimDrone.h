@@ -0,0 +1,62 @@
+#pragma once
+
+#include <memory>
+
+#include "SimConfig.h"
+#include "SimDroneBatch.h"
+#include "SimMath.h"
+#include "SimRandom.h"
+#include "SimZones.h"
+
+namespace DroSimCore
+{
+	/**
+	 * Engine-free drone, same kinematics as ADrone.
+	 *
+	 * Derived classes implement the strategies of ADroneRandom, ADroneSweep and ADroneSpiral.
+	 * A drone either moves itself with Step, or is attached to a FSimDroneBatch which then owns its
+	 * movement state and only calls back into the drone when it reaches a destination.
+	 */
+	class FSimDrone
+	{
+	public:
+		FSimDrone(const FSimConfig& InConfig, int InID, const FSimZone& InZone, float InSpeed, const FSimRandom& InRandom);
+		virtual ~FSimDrone() = default;
+
+		virtual void Start();
+		void Step();
+
+		void AttachToBatch(FSimDroneBatch& InBatch);
+		void HandleBatchArrival();
+		void SkipToDestination();
+
+		int GetID() const { return ID; }
+		FSimVec3 GetPosition() const { return Batch ? Batch->GetPosition(BatchIndex) : CalculatedPosition; }
+		FSimVec3 GetMoveDirection() const { return Batch ? Batch->GetDirection(BatchIndex) : MoveDirection; }
+		FSimVec3 GetDestination() const { return Batch ? Batch->GetDestination(BatchIndex) : CurrentDestination; }
+		const FSimZone& GetAssignedZone() const { return AssignedZone; }
+
+	protected:
+		virtual void OnDestinationReached();
+		virtual void SetNewDestination() {}
+
+		void SetDestinationManual(const FSimVec3& NewDestination);
+		bool IsOutOfBounds(const FSimVec3& Point) const { return AssignedZone.IsOutOfBounds(Point); }
+
+		const FSimConfig& Config;
+		FSimRandom Random;
+		FSimZone AssignedZone;
+		int ID;
+		float MovementSpeed;
+
+		FSimVec3 CalculatedPosition;
+		FSimVec3 CurrentDestination;
+		FSimVec3 MoveDirection = FSimVec3(1.0, 0, 0);
+
+	private:
+		FSimDroneBatch* Batch = nullptr;
+		int BatchIndex = -1;
+	};
+
+	std::unique_ptr<FSimDrone> MakeSimDrone(ESimStrategy Strategy, const FSimConfig& Config, int ID, const FSimZone& Zone, float Speed, const FSimRandom& Random);
+}
@@ -0,0 +1,63 @@
+#pragma once
+
+#include <cstdint>
+#include <vector>
+
+#include "SimMath.h"
+
+namespace DroSimCore
+{
+	/**
+	 * Movement state of every drone of a simulation, stored as contiguous arrays (structure of arrays).
+	 *
+	 * StepAll advances every drone by one substep and FindFirstContact tests every drone against the
+	 * objective, both with vector instructions. Strategy decisions are left to the caller, which gets
+	 * the list of drones that reached their destination.
+	 */
+	class FSimDroneBatch
+	{
+	public:
+		void Reset();
+		void Reserve(int Count);
+		int Add(const FSimVec3& Position, const FSimVec3& Direction, const FSimVec3& Destination, double Speed);
+
+		int Num() const { return (int)PosX.size(); }
+		int NumActive() const { return ActiveCount; }
+		bool IsActive(const int i) const { return Active[i] != 0; }
+
+		FSimVec3 GetPosition(const int i) const { return FSimVec3(PosX[i], PosY[i], PosZ[i]); }
+		FSimVec3 GetPreviousPosition(const int i) const { return FSimVec3(PrevX[i], PrevY[i], PrevZ[i]); }
+		FSimVec3 GetDirection(const int i) const { return FSimVec3(DirX[i], DirY[i], DirZ[i]); }
+		FSimVec3 GetDestination(const int i) const { return FSimVec3(DestX[i], DestY[i], DestZ[i]); }
+		double GetSpeed(const int i) const { return Speed[i]; }
+
+		void SetPosition(int i, const FSimVec3& V);
+		void SetDirection(int i, const FSimVec3& V);
+		void SetDestination(int i, const FSimVec3& V);
+		void SetSpeed(const int i, const double V) { Speed[i] = V; }
+		void Deactivate(int i);
+
+		void StepAll(double StepDuration, double Tolerance, std::vector<int>& OutArrived);
+		bool FindFirstContact(const FSimVec3& ObjectiveStart, const FSimVec3& ObjectiveEnd, double Radius,
+			double& OutAlpha, int& OutIndex) const;
+
+		static const char* GetInstructionSetName();
+
+	private:
+		template <typename Ops>
+		void StepBlock(int i, double StepDuration, double ToleranceSquared, std::vector<int>& OutArrived);
+
+		template <typename Ops>
+		int DetectBlock(int i, const FSimVec3& ObjectiveStart, const FSimVec3& ObjectiveMove, double RadiusSquared) const;
+
+		std::vector<double> PosX, PosY, PosZ;
+		std::vector<double> PrevX, PrevY, PrevZ;
+		std::vector<double> DirX, DirY, DirZ;
+		std::vector<double> DestX, DestY, DestZ;
+		std::vector<double> Speed;
+
+		// Inactive drones stay where they are and no longer see objectives
+		std::vector<uint8_t> Active;
+		int ActiveCount = 0;
+	};
+}
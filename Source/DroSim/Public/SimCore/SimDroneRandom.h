@@ -0,0 +1,15 @@
+#pragma once
+
+#include "SimDrone.h"
+
+namespace DroSimCore
+{
+	class FSimDroneRandom : public FSimDrone
+	{
+	public:
+		using FSimDrone::FSimDrone;
+
+	protected:
+		virtual void SetNewDestination() override;
+	};
+}
@@ -0,0 +1,27 @@
+#pragma once
+
+#include <vector>
+
+#include "SimDrone.h"
+
+namespace DroSimCore
+{
+	class FSimDroneSpiral : public FSimDrone
+	{
+	public:
+		FSimDroneSpiral(const FSimConfig& InConfig, int InID, const FSimZone& InZone, float InSpeed, const FSimRandom& InRandom);
+
+	protected:
+		virtual void OnDestinationReached() override;
+		virtual void SetNewDestination() override;
+		void SetCircle();
+		void GetRandomDirection();
+
+		int Wander;
+
+		std::vector<FSimVec3> CirclePoints;
+		int CurrentCirclePointId = 0;
+		FSimVec3 CurrentCircleCenter;
+		float CurrentSpiralIncrementFactor = 0;
+	};
+}
@@ -0,0 +1,24 @@
+#pragma once
+
+#include "SimDrone.h"
+
+namespace DroSimCore
+{
+	class FSimDroneSweep : public FSimDrone
+	{
+	public:
+		using FSimDrone::FSimDrone;
+
+		virtual void Start() override;
+
+	protected:
+		virtual void SetNewDestination() override;
+
+		bool GoesUp = true;
+		bool TopToBottom = false;
+		bool LeftToRight = true;
+		int HeightCount = 0;
+		double SweepLength = 0;
+		double LeftYBound = 0;
+	};
+}
@@ -0,0 +1,48 @@
+#pragma once
+
+#include <atomic>
+#include <cstdint>
+#include <string>
+#include <vector>
+
+#include "SimConfig.h"
+#include "SimSearch.h"
+#include "Simulation.h"
+
+namespace DroSimCore
+{
+	/**
+	 * On-disk cache of group outcomes, reused by later sweeps instead of simulating the same groups again.
+	 *
+	 * Content-addressed: an entry is keyed by everything the outcome of a group depends on, that is the seed,
+	 * the group parameters, the ID of its first simulation and every setting of the simulation itself. Search
+	 * settings (drone and speed ranges, search mode) are not part of the key, so a sweep extended to more
+	 * drones finds the groups it shares with the previous one. One file per entry, named after the hash of its
+	 * key, which it also holds in full to rule out collisions. Entries are written atomically and never
+	 * modified, so several processes can share a cache directory.
+	 *
+	 * Bump SimGroupCache::Version whenever a change to the simulation changes outcomes.
+	 */
+	class FSimGroupCache
+	{
+	public:
+		bool Open(const std::string& InDirectory, std::string& OutError);
+		bool IsOpen() const { return !Directory.empty(); }
+
+		bool Find(const FSimConfig& Config, const FSimGroupParams& Params, uint32_t Seed, uint64_t FirstSimulationID,
+			FSimGroupOutcome& OutOutcome);
+		void Add(const FSimConfig& Config, const FSimGroupParams& Params, uint32_t Seed, uint64_t FirstSimulationID,
+			const FSimGroupOutcome& Outcome);
+
+		int GetHits() const { return Hits; }
+		int GetMisses() const { return Misses; }
+
+	private:
+		static std::vector<uint8_t> MakeKey(const FSimConfig& Config, const FSimGroupParams& Params, uint32_t Seed, uint64_t FirstSimulationID);
+		std::string GetEntryPath(const std::vector<uint8_t>& Key) const;
+
+		std::string Directory;
+		std::atomic<int> Hits{0};
+		std::atomic<int> Misses{0};
+	};
+}
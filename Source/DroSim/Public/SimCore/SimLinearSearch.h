@@ -0,0 +1,33 @@
+#pragma once
+
+#include "SimSearch.h"
+
+namespace DroSimCore
+{
+	/**
+	 * Walks speed from min_speed to max_speed in speed_increment steps for every drone count,
+	 * the search AManager originally ran.
+	 */
+	class FSimLinearSearch : public FSimSearch
+	{
+	public:
+		explicit FSimLinearSearch(const FSimConfig& InConfig);
+
+		virtual bool IsFinished() const override { return GroupNumDrones >= Config.MaxNumDrones; }
+		virtual FSimGroupParams GetGroupParams() const override;
+		virtual void ReportGroup(const FSimGroupOutcome& GroupOutcome) override;
+		virtual void Serialize(FSimArchive& Ar) override;
+
+	private:
+		void MutateSimulationParameters(bool IsGroupSuccessful, const FSimGroupOutcome& GroupOutcome);
+
+		float GroupSpeed;
+		int GroupNumDrones;
+		int GroupBatteryCount;
+
+		bool IsCurveFound = false;
+		bool IsMaxFound = false;
+		float PreviousSpeed = -1;
+		int PreviousBatteryCount = -1;
+	};
+}
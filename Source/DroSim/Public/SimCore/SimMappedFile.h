@@ -0,0 +1,36 @@
+#pragma once
+
+#include <cstddef>
+#include <cstdint>
+#include <string>
+
+namespace DroSimCore
+{
+	/**
+	 * Read-only memory mapping of a whole file.
+	 *
+	 * Pages are loaded by the OS on first access, so opening a large file is cheap and
+	 * only the parts actually read cost memory.
+	 */
+	class FSimMappedFile
+	{
+	public:
+		FSimMappedFile() = default;
+		~FSimMappedFile();
+
+		FSimMappedFile(const FSimMappedFile&) = delete;
+		FSimMappedFile& operator=(const FSimMappedFile&) = delete;
+
+		bool Open(const std::string& Path, std::string& OutError);
+		void Close();
+
+		const uint8_t* GetData() const { return Data; }
+		size_t GetSize() const { return Size; }
+
+	private:
+		const uint8_t* Data = nullptr;
+		size_t Size = 0;
+		void* FileHandle = nullptr;
+		void* MappingHandle = nullptr;
+	};
+}
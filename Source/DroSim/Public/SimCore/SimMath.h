@@ -0,0 +1,75 @@
+#pragma once
+
+#include <cmath>
+
+/**
+ * Engine-free simulation core.
+ *
+ * Everything under SimCore/ only depends on the C++ standard library so it can be compiled
+ * both inside the DroSim module and by the headless command line driver (Source/DroSimCli).
+ */
+namespace DroSimCore
+{
+	/** Tolerance used by FSimVec3::Normalize, same value as UE's SMALL_NUMBER. */
+	constexpr double SimSmallNumber = 1.e-8;
+
+	/** Minimal 2D vector, mirrors the parts of FVector2D the simulation needs. */
+	struct FSimVec2
+	{
+		double X = 0;
+		double Y = 0;
+
+		FSimVec2() = default;
+		FSimVec2(const double InX, const double InY) : X(InX), Y(InY) {}
+	};
+
+	/** Minimal 3D vector, mirrors the parts of FVector the simulation needs. */
+	struct FSimVec3
+	{
+		double X = 0;
+		double Y = 0;
+		double Z = 0;
+
+		FSimVec3() = default;
+		FSimVec3(const double InX, const double InY, const double InZ) : X(InX), Y(InY), Z(InZ) {}
+
+		FSimVec3 operator+(const FSimVec3& V) const { return FSimVec3(X + V.X, Y + V.Y, Z + V.Z); }
+		FSimVec3 operator-(const FSimVec3& V) const { return FSimVec3(X - V.X, Y - V.Y, Z - V.Z); }
+		FSimVec3 operator*(const double Scale) const { return FSimVec3(X * Scale, Y * Scale, Z * Scale); }
+		FSimVec3 operator/(const double Scale) const { return FSimVec3(X / Scale, Y / Scale, Z / Scale); }
+		FSimVec3& operator+=(const FSimVec3& V) { X += V.X; Y += V.Y; Z += V.Z; return *this; }
+		bool operator==(const FSimVec3& V) const { return X == V.X && Y == V.Y && Z == V.Z; }
+		bool operator!=(const FSimVec3& V) const { return !(*this == V); }
+
+		double SizeSquared() const { return X * X + Y * Y + Z * Z; }
+		double Size() const { return std::sqrt(SizeSquared()); }
+
+		static double DistSquared(const FSimVec3& A, const FSimVec3& B) { return (A - B).SizeSquared(); }
+		static double Dist(const FSimVec3& A, const FSimVec3& B) { return (A - B).Size(); }
+		static double Dot(const FSimVec3& A, const FSimVec3& B) { return A.X * B.X + A.Y * B.Y + A.Z * B.Z; }
+
+		/** Angle between two directions in radians, 0 if either is too small to have one. */
+		static double Angle(const FSimVec3& A, const FSimVec3& B)
+		{
+			const double SizeProduct = std::sqrt(A.SizeSquared() * B.SizeSquared());
+			if (SizeProduct <= SimSmallNumber) return 0;
+			return std::acos(std::fmax(-1., std::fmin(1., Dot(A, B) / SizeProduct)));
+		}
+
+		/**
+		 * Normalizes the vector in place, leaving it untouched if it is too small (same behaviour as FVector::Normalize).
+		 *
+		 * @returns True if the vector was normalized.
+		 */
+		bool Normalize()
+		{
+			const double SquareSum = SizeSquared();
+			if (SquareSum <= SimSmallNumber) return false;
+			const double Scale = 1.0 / std::sqrt(SquareSum);
+			X *= Scale;
+			Y *= Scale;
+			Z *= Scale;
+			return true;
+		}
+	};
+}
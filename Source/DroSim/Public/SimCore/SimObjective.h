@@ -0,0 +1,29 @@
+#pragma once
+
+#include "SimConfig.h"
+#include "SimMath.h"
+
+namespace DroSimCore
+{
+	/** Altitude the objective is placed at, as in AObjective::BeginPlay. */
+	constexpr double SimObjectiveAltitude = 100.0;
+
+	/**
+	 * Engine-free objective, same movement as AObjective: it bounces along the Y axis of the environment.
+	 */
+	class FSimObjective
+	{
+	public:
+		FSimObjective(const FSimConfig& InConfig, const FSimVec3& SpawnPoint);
+
+		void Step();
+
+		const FSimVec3& GetPosition() const { return Position; }
+		const FSimVec3& GetMoveDirection() const { return MoveDirection; }
+
+	private:
+		const FSimConfig& Config;
+		FSimVec3 Position;
+		FSimVec3 MoveDirection = FSimVec3(0, 1.0, 0);
+	};
+}
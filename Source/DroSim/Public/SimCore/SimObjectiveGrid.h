@@ -0,0 +1,63 @@
+#pragma once
+
+#include <algorithm>
+#include <cstdint>
+#include <vector>
+
+#include "SimConfig.h"
+#include "SimMath.h"
+
+namespace DroSimCore
+{
+	/**
+	 * Uniform grid over the environment indexing the objectives of a simulation, so that detection only tests a
+	 * drone against the objectives of the few cells around its move instead of against every objective.
+	 *
+	 * Objectives are stored sorted by cell in a single array. The grid is loose: it keeps the positions
+	 * objectives were indexed at, and queries are widened by how far they may have moved since. It is only
+	 * rebuilt once that drift exceeds half a cell, every few hundred substeps at the default objective speed.
+	 */
+	class FSimObjectiveGrid
+	{
+	public:
+		void Reset(const FSimConfig& Config);
+		void Refit(const std::vector<FSimVec3>& Positions, const std::vector<uint8_t>& IsFound, double StepDistance);
+
+		/**
+		 * Calls Visit with the index of every objective that may come within Radius of a drone moving from From
+		 * to To over the substep, each one once. Objectives out of reach can be visited too.
+		 */
+		template <typename FVisit>
+		void ForEachNear(const FSimVec3& From, const FSimVec3& To, const double Radius, FVisit&& Visit) const
+		{
+			const double Margin = Radius + Drift;
+			const int MinX = GetCellX(std::min(From.X, To.X) - Margin), MaxX = GetCellX(std::max(From.X, To.X) + Margin);
+			const int MinY = GetCellY(std::min(From.Y, To.Y) - Margin), MaxY = GetCellY(std::max(From.Y, To.Y) + Margin);
+			for (int y = MinY; y <= MaxY; y++)
+			{
+				// Cells of a row are contiguous
+				const int First = CellStarts[y * Columns + MinX], Last = CellStarts[y * Columns + MaxX + 1];
+				for (int i = First; i < Last; i++) Visit(Items[i]);
+			}
+		}
+
+	private:
+		void Build(const std::vector<FSimVec3>& Positions, const std::vector<uint8_t>& IsFound);
+
+		// Positions out of the environment belong to the border cells
+		int GetCellX(const double X) const { return (int)std::clamp(X * InverseCellSize, 0., Columns - 1.); }
+		int GetCellY(const double Y) const { return (int)std::clamp(Y * InverseCellSize, 0., Rows - 1.); }
+
+		double InverseCellSize = 1;
+		int Columns = 1;
+		int Rows = 1;
+		double Slack = 0;
+		double Drift = 0;
+		bool bIsBuilt = false;
+
+		// Objectives of cell c are Items[CellStarts[c]] to Items[CellStarts[c + 1] - 1]
+		std::vector<int> CellStarts;
+		std::vector<int> Items;
+		std::vector<int> ItemCells;
+	};
+}
@@ -0,0 +1,72 @@
+#pragma once
+
+#include <cstdint>
+#include <memory>
+#include <vector>
+
+#include "SimConfig.h"
+#include "SimDrone.h"
+#include "Simulation.h"
+
+namespace DroSimCore
+{
+	/**
+	 * Outcome of a sweep simulation worked out in closed form, without stepping it.
+	 *
+	 * The sweep strategy is deterministic: every drone flies a polyline fixed by its zone, and the objective
+	 * either stays put or bounces along Y. Both are replayed leg by leg rather than substep by substep, with the
+	 * same discretisation as FSimDroneBatch::StepAll: a drone snaps to its destination on the substep it would
+	 * pass it, then moves on for one more substep along its old direction while its strategy picks the next
+	 * destination. The first contact is then solved on every pair of linear pieces of the two paths.
+	 *
+	 * Gives the same outcome as FSimulation::Run for the same seed and simulation ID, up to rounding: positions
+	 * are computed as Start + k * Move instead of being accumulated substep after substep.
+	 */
+	class FSimSweepOracle
+	{
+	public:
+		FSimSweepOracle(const FSimConfig& InConfig, const FSimGroupParams& InParams, uint64_t Seed, uint64_t InSimulationID);
+
+		FSimOutcome Run();
+
+		/** Only sweep simulations of a single objective, without the energy model, are solved. */
+		static bool Supports(const FSimConfig& Config)
+		{
+			return Config.Strategy == ESimStrategy::Sweep && Config.ObjectiveCount == 1 && !Config.EnergyModel;
+		}
+
+	private:
+		/** Linear piece of a path, from Start to End over NumSteps substeps starting at substep FirstStep. */
+		struct FSegment
+		{
+			int64_t FirstStep = 0;
+			int64_t NumSteps = 0;
+			FSimVec3 Start;
+			FSimVec3 End;
+
+			int64_t GetEndStep() const { return FirstStep + NumSteps; }
+			FSimVec3 GetPositionAt(int64_t Step) const;
+		};
+
+		/** Where a drone is along its path, at the start of its next leg. */
+		struct FDroneFlight
+		{
+			int Drone = 0;
+			FSimVec3 Position;
+			int64_t Step = 0;
+			size_t ObjectiveSegment = 0;
+		};
+
+		void BuildObjectivePath(const FSimVec3& SpawnPoint);
+		bool FlyLeg(FDroneFlight& Flight, double& InOutContactStep) const;
+		bool FindSegmentContact(const FSegment& DroneSegment, size_t& InOutObjectiveSegment, double& OutContactStep) const;
+
+		const FSimConfig& Config;
+		FSimGroupParams Params;
+		uint64_t SimulationID;
+		int64_t NumSteps = 0;
+
+		std::vector<FSegment> ObjectivePath;
+		std::vector<std::unique_ptr<FSimDrone>> Drones;
+	};
+}
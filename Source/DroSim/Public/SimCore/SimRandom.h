@@ -0,0 +1,61 @@
+#pragma once
+
+#include <cstdint>
+
+namespace DroSimCore
+{
+	/**
+	 * Counter-based random stream used by the simulation core. Integer ranges include both bounds, as
+	 * FMath::RandRange does, floating point ranges exclude their upper bound.
+	 *
+	 * The n-th draw of a stream is a pure function of (key, n), so streams keyed by (sweep seed, simulation ID,
+	 * drone ID) do not depend on each other, on the order they are consumed in or on the thread they run on:
+	 * any single simulation can be replayed from its ID. Conversions to ranges are done here rather than with
+	 * <random> distributions, whose output differs between standard libraries.
+	 */
+	class FSimRandom
+	{
+	public:
+		explicit FSimRandom(const uint64_t InKey = 0) : Key(Mix(InKey)) {}
+
+		/** Stream of a simulation (DroneID 0) or of one of its drones (DroneID >= 1). */
+		static FSimRandom ForStream(const uint64_t Seed, const uint64_t SimulationID, const uint64_t DroneID = 0)
+		{
+			return FSimRandom(Mix(Mix(Seed) ^ (SimulationID + 0x632BE59BD9B4E019ull)) ^ (DroneID * 0x9E3779B97F4A7C15ull));
+		}
+
+		/** Next 64 random bits. */
+		uint64_t Next() { return Mix(Key + ++Counter * 0x9E3779B97F4A7C15ull); }
+
+		/** Random float in [Min, Max). */
+		float RandRange(const float Min, const float Max)
+		{
+			return Min + (Max - Min) * (float)(Next() >> 40) * (1.0f / 16777216.0f);
+		}
+
+		/** Random double in [Min, Max). */
+		double RandRange(const double Min, const double Max)
+		{
+			return Min + (Max - Min) * (double)(Next() >> 11) * (1.0 / 9007199254740992.0);
+		}
+
+		/** Random integer in [Min, Max]. */
+		int RandRange(const int Min, const int Max)
+		{
+			const uint64_t Range = (uint64_t)((int64_t)Max - Min) + 1;
+			return (int)(Min + (int64_t)(((Next() >> 32) * Range) >> 32));
+		}
+
+	private:
+		/** SplitMix64 finalizer, a bijection spreading every input bit over the output. */
+		static uint64_t Mix(uint64_t Value)
+		{
+			Value = (Value ^ (Value >> 30)) * 0xBF58476D1CE4E5B9ull;
+			Value = (Value ^ (Value >> 27)) * 0x94D049BB133111EBull;
+			return Value ^ (Value >> 31);
+		}
+
+		uint64_t Key;
+		uint64_t Counter = 0;
+	};
+}
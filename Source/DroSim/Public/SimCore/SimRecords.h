@@ -0,0 +1,83 @@
+#pragma once
+
+#include <condition_variable>
+#include <cstdint>
+#include <fstream>
+#include <mutex>
+#include <string>
+#include <thread>
+
+#include "SimConfig.h"
+
+namespace DroSimCore
+{
+	/** One finished simulation, as streamed to the records file. */
+	struct FSimRecord
+	{
+		uint64_t SimulationID = 0;
+		int GroupID = 0;
+		ESimStrategy Strategy = ESimStrategy::Sweep;
+		float Speed = 0;
+		int NumDrones = 0;
+		int BatteryCount = -1;
+		uint32_t Seed = 0;
+		bool Found = false;
+		float TimeToFind = 0;
+		float Consumption = 0;
+	};
+
+	/** Line format of the records file, picked from its extension. */
+	enum class ESimRecordFormat
+	{
+		Csv,
+		Jsonl
+	};
+
+	FSimRecord MakeSimRecord(const FSimConfig& Config, uint64_t SimulationID, int GroupID, float Speed, int NumDrones,
+		uint32_t Seed, bool Found, float FlightTime, float Consumption);
+
+	/**
+	 * Append-only records file, one line per simulation.
+	 *
+	 * Records are formatted into a memory buffer by the caller's thread and written by a background thread,
+	 * in batches of FlushThreshold bytes or every FlushInterval, so simulations never wait on the disk.
+	 * A .jsonl file gets one JSON object per line, anything else is CSV with a header written on creation.
+	 */
+	class FSimRecordWriter
+	{
+	public:
+		FSimRecordWriter() = default;
+		~FSimRecordWriter();
+
+		FSimRecordWriter(const FSimRecordWriter&) = delete;
+		FSimRecordWriter& operator=(const FSimRecordWriter&) = delete;
+
+		bool Open(const std::string& Path, std::string& OutError, int64_t KeepBytes = -1);
+		void Close();
+		bool IsOpen() const { return File.is_open(); }
+
+		void Add(const FSimRecord& Record);
+		uint64_t Sync();
+
+		static std::string FormatRecord(const FSimRecord& Record, ESimRecordFormat Format);
+
+		static constexpr size_t FlushThreshold = 64 * 1024;
+		static constexpr int FlushIntervalMs = 1000;
+
+	private:
+		void FlushLoop();
+		void WriteBatch(std::string& Batch);
+
+		// Held while a batch is swapped out and written, so that batches reach the file in order
+		std::mutex FileMutex;
+		std::ofstream File;
+		uint64_t FileSize = 0;
+		ESimRecordFormat Format = ESimRecordFormat::Csv;
+
+		std::mutex Mutex;
+		std::condition_variable WakeUp;
+		std::string Pending;
+		bool bStopping = false;
+		std::thread Flusher;
+	};
+}
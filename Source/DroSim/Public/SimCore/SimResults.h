@@ -0,0 +1,33 @@
+#pragma once
+
+#include <functional>
+#include <string>
+#include <vector>
+
+namespace DroSimCore
+{
+	/** Receives the progress messages the manager prints with UE_LOG. */
+	using FSimLogger = std::function<void(const std::string&)>;
+
+	std::string SimPrintf(const char* Format, ...);
+
+	/** A configuration retained by the parameter search. */
+	struct FSimConfigResult
+	{
+		float Speed = 0;
+		int NumDrones = 0;
+		int BatteryCount = 0;
+		float Weight = 0;
+	};
+
+	/** Outcome of a full parameter search, written to results.txt by AManager and DroSimCli. */
+	struct FSimResults
+	{
+		bool HasFastConfig = false;
+		FSimConfigResult FastConfig;
+		std::vector<FSimConfigResult> SlowConfigs;
+	};
+
+	std::vector<std::string> FormatResults(const FSimResults& Results);
+	bool WriteResultsToFile(const std::string& Path, const FSimResults& Results, std::string& OutError);
+}
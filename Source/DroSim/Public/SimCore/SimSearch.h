@@ -0,0 +1,77 @@
+#pragma once
+
+#include <cstdint>
+#include <memory>
+#include <vector>
+
+#include "SimCheckpoint.h"
+#include "SimConfig.h"
+#include "SimResults.h"
+#include "Simulation.h"
+
+namespace DroSimCore
+{
+	/** Accumulated outcome of a group of simulations sharing the same parameters. */
+	struct FSimGroupOutcome
+	{
+		int RunSims = 0;
+		int SuccessfulSims = 0;
+		float SummedTimesToFind = 0;
+		// Sum of FSimOutcome::Consumption over the successful simulations
+		float SummedConsumptions = 0;
+		bool IsSuccessful = false;
+
+		// Outcomes of the RunSims replicas, the first one being simulation FirstSimulationID
+		uint64_t FirstSimulationID = 0;
+		std::vector<FSimOutcome> Outcomes;
+	};
+
+	/** Verdict of a group of simulations, possibly reached before all of its replicas ran. */
+	enum class ESimGroupVerdict
+	{
+		Undecided,
+		Success,
+		Fail
+	};
+
+	bool IsGroupSuccessful(int SuccessfulSims, int SimGroupSize);
+	ESimGroupVerdict EvaluateGroup(const FSimConfig& Config, int RunSims, int SuccessfulSims);
+	int FindMinBatteryCount(const FSimConfig& Config, double Consumption, float& OutConsumption);
+
+	/**
+	 * Parameter search over (speed, number of drones).
+	 *
+	 * The caller runs a group with GetGroupParams() and reports its outcome until IsFinished().
+	 * Derived classes decide which group to run next, see Config.SearchMode.
+	 */
+	class FSimSearch
+	{
+	public:
+		explicit FSimSearch(const FSimConfig& InConfig) : Config(InConfig) {}
+		virtual ~FSimSearch() = default;
+
+		static std::unique_ptr<FSimSearch> Make(const FSimConfig& Config);
+
+		void SetLogger(const FSimLogger& InLogger) { Logger = InLogger; }
+
+		virtual bool IsFinished() const = 0;
+		virtual FSimGroupParams GetGroupParams() const = 0;
+		virtual void ReportGroup(const FSimGroupOutcome& GroupOutcome) = 0;
+		virtual void Serialize(FSimArchive& Ar);
+
+		void PrintSimConfigRecap() const;
+		float CalculateMaximumAutonomy(float Speed) const;
+		FSimGroupParams MakeGroupParams(float Speed, int NumDrones) const;
+
+		const FSimResults& GetResults() const { return Results; }
+
+	protected:
+		int CalculateMinBatteryCount(const FSimGroupOutcome& GroupOutcome, float& OutConsumption) const;
+		int LogGroupOutcome(bool IsGroupSuccessful, const FSimGroupOutcome& GroupOutcome) const;
+		void Log(const std::string& Text) const { if (Logger) Logger(Text); }
+
+		const FSimConfig& Config;
+		FSimLogger Logger;
+		FSimResults Results;
+	};
+}
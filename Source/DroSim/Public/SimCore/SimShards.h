@@ -0,0 +1,39 @@
+#pragma once
+
+#include <cstdint>
+#include <vector>
+
+#include "SimConfig.h"
+#include "SimResults.h"
+
+namespace DroSimCore
+{
+	/**
+	 * Part of a parameter sweep that can run on its own: the drone counts in [MinNumDrones, MaxNumDrones).
+	 *
+	 * Speeds and battery counts are what the search walks for a given drone count, so they stay within a shard.
+	 * Every shard draws its simulation IDs from its own range, so a shard gives the same results whichever
+	 * process runs it and however many times it is run again.
+	 *
+	 * A sharded sweep is not the sequential sweep cut in pieces, even with common_random_numbers: the searches
+	 * carry state from one drone count to the next (the linear search its current speed and the speed and
+	 * battery count of its last success, the bisection search its previous threshold), and every shard starts
+	 * a fresh search instead. Each shard walks its first drone count up from min_speed as the first drone count
+	 * of a sweep does, which runs more groups, and the SlowConfigs entry of that drone count can differ from
+	 * the sequential one, as can the following ones while the two searches have not met the same state again.
+	 * The linear search for instance records, at a drone count whose first group fails, the speed and battery
+	 * count of the previous count, which a shard starting there never has.
+	 */
+	struct FSimShard
+	{
+		int Index = 0;
+		int MinNumDrones = 0;
+		int MaxNumDrones = 0;
+		uint64_t FirstSimulationID = 0;
+
+		FSimConfig Apply(const FSimConfig& Config) const;
+	};
+
+	std::vector<FSimShard> MakeShards(const FSimConfig& Config, int NumShards);
+	FSimResults MergeShardResults(const std::vector<FSimResults>& ShardResults);
+}
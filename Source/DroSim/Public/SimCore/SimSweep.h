@@ -0,0 +1,67 @@
+#pragma once
+
+#include <cstdint>
+#include <memory>
+#include <string>
+
+#include "SimCheckpoint.h"
+#include "SimConfig.h"
+#include "SimGroupCache.h"
+#include "SimRecords.h"
+#include "SimResults.h"
+#include "SimSearch.h"
+#include "SimThreadPool.h"
+#include "SimTrajectory.h"
+
+namespace DroSimCore
+{
+	FSimGroupOutcome RunSimulationGroup(const FSimConfig& Config, const FSimGroupParams& Params, uint32_t Seed, uint64_t FirstSimulationID,
+		FSimThreadPool& Pool, FSimTrajectoryWriter* TrajectoryWriter = nullptr);
+
+	/**
+	 * Full headless parameter sweep: runs groups of simulations as dictated by FSimSearch until it is finished.
+	 *
+	 * The replicas of a group run concurrently on Config.WorkerThreads threads.
+	 * With a checkpoint file, the state of the sweep is saved there between two groups every
+	 * Config.CheckpointInterval seconds, and once the search is finished.
+	 * With a group cache, groups already run by a previous sweep are read from it instead of being simulated,
+	 * unless trajectories are recorded.
+	 */
+	class FSimSweep
+	{
+	public:
+		FSimSweep(const FSimConfig& InConfig, uint32_t InSeed);
+
+		uint32_t GetSeed() const { return Seed; }
+
+		void SetLogger(const FSimLogger& InLogger) { Logger = InLogger; }
+		void SetRecordWriter(FSimRecordWriter* InRecordWriter) { RecordWriter = InRecordWriter; }
+		void SetTrajectoryWriter(FSimTrajectoryWriter* InTrajectoryWriter) { TrajectoryWriter = InTrajectoryWriter; }
+		void SetFirstSimulationID(const uint64_t InFirstSimulationID) { NextSimulationID = InFirstSimulationID; }
+		void SetCheckpointFile(const std::string& Path) { CheckpointPath = Path; }
+		void SetGroupCache(FSimGroupCache* InGroupCache) { GroupCache = InGroupCache; }
+
+		bool Resume(const FSimCheckpoint& Checkpoint, std::string& OutError);
+
+		FSimResults Run();
+
+		int GetSimulationCount() const { return SimulationCount; }
+		int GetNumThreads() const { return Pool.GetNumThreads(); }
+
+	private:
+		void SaveCheckpoint();
+
+		const FSimConfig& Config;
+		uint32_t Seed;
+		uint64_t NextSimulationID = 0;
+		int GroupCount = 0;
+		FSimThreadPool Pool;
+		std::unique_ptr<FSimSearch> Search;
+		std::string CheckpointPath;
+		FSimLogger Logger;
+		FSimRecordWriter* RecordWriter = nullptr;
+		FSimTrajectoryWriter* TrajectoryWriter = nullptr;
+		FSimGroupCache* GroupCache = nullptr;
+		int SimulationCount = 0;
+	};
+}
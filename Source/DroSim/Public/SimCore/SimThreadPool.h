@@ -0,0 +1,46 @@
+#pragma once
+
+#include <atomic>
+#include <condition_variable>
+#include <functional>
+#include <mutex>
+#include <thread>
+#include <vector>
+
+namespace DroSimCore
+{
+	/**
+	 * Fixed set of worker threads running index-based parallel loops.
+	 *
+	 * The calling thread takes part in every loop, so a pool of 1 thread runs everything inline.
+	 */
+	class FSimThreadPool
+	{
+	public:
+		explicit FSimThreadPool(int NumThreads = 0);
+		~FSimThreadPool();
+
+		FSimThreadPool(const FSimThreadPool&) = delete;
+		FSimThreadPool& operator=(const FSimThreadPool&) = delete;
+
+		int GetNumThreads() const { return (int)Workers.size() + 1; }
+
+		void ParallelFor(int Count, const std::function<void(int)>& Body);
+
+	private:
+		void WorkerLoop();
+		void RunIndices();
+
+		std::vector<std::thread> Workers;
+		std::mutex Mutex;
+		std::condition_variable WakeUp;
+		std::condition_variable Done;
+
+		const std::function<void(int)>* CurrentBody = nullptr;
+		int CurrentCount = 0;
+		std::atomic<int> NextIndex {0};
+		int BusyWorkers = 0;
+		unsigned Generation = 0;
+		bool bStopping = false;
+	};
+}
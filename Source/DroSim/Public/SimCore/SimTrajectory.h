@@ -0,0 +1,105 @@
+#pragma once
+
+#include <cstdint>
+#include <fstream>
+#include <mutex>
+#include <string>
+#include <unordered_map>
+#include <vector>
+
+#include "SimMappedFile.h"
+#include "SimMath.h"
+
+namespace DroSimCore
+{
+	/*
+	 * Trajectory file layout, little-endian:
+	 *
+	 *   "DSTJ" u32 version
+	 *   one block per simulation:
+	 *     u64 simulation ID, u32 entities, u32 objectives, u32 frames, f32 step, u32 keyframe interval,
+	 *     u32 keyframes, u32 keyframe offsets[keyframes], u32 data size, u8 data[data size]
+	 *   u64 simulations, then per simulation: u64 ID, u64 block offset
+	 *   u64 index offset, "DSTX"
+	 *
+	 * The objectives come first, then the drones by ID. Positions are rounded to the centimetre and every
+	 * coordinate is stored as a zigzag varint of its delta with the previous frame. Keyframes store deltas with
+	 * zero, so any frame can be decoded from the keyframe before it.
+	 */
+
+	/** Summary of one simulation of a trajectory file. */
+	struct FSimTrajectoryInfo
+	{
+		uint64_t SimulationID = 0;
+		int NumEntities = 0;
+		int NumObjectives = 0;
+		int NumFrames = 0;
+		float Step = 0;
+	};
+
+	/**
+	 * Trajectory of a single simulation, encoded frame by frame while it runs.
+	 */
+	class FSimTrajectoryBuilder
+	{
+	public:
+		FSimTrajectoryBuilder(uint64_t InSimulationID, int InNumObjectives, int InNumDrones, float InStep);
+
+		void AddFrame(const std::vector<FSimVec3>& Positions);
+		void Serialize(std::vector<uint8_t>& OutBlock) const;
+
+		static constexpr int KeyframeInterval = 64;
+
+	private:
+		FSimTrajectoryInfo Info;
+		std::vector<int32_t> Previous;
+		std::vector<uint32_t> KeyframeOffsets;
+		std::vector<uint8_t> Data;
+	};
+
+	/**
+	 * Trajectory file being written, shared by the simulations of a sweep.
+	 *
+	 * Simulations hand over their finished block, which is appended under a lock; the index is written on Close.
+	 */
+	class FSimTrajectoryWriter
+	{
+	public:
+		FSimTrajectoryWriter() = default;
+		~FSimTrajectoryWriter();
+
+		FSimTrajectoryWriter(const FSimTrajectoryWriter&) = delete;
+		FSimTrajectoryWriter& operator=(const FSimTrajectoryWriter&) = delete;
+
+		bool Open(const std::string& Path, std::string& OutError);
+		void Close();
+		bool IsOpen() const { return File.is_open(); }
+
+		void AddSimulation(const FSimTrajectoryBuilder& Trajectory);
+
+	private:
+		std::ofstream File;
+		std::mutex Mutex;
+		uint64_t Offset = 0;
+		std::vector<std::pair<uint64_t, uint64_t>> Index;
+		std::vector<uint8_t> Block;
+	};
+
+	/**
+	 * Memory-mapped trajectory file, for scrubbing through recorded simulations without simulating them again.
+	 */
+	class FSimTrajectoryReader
+	{
+	public:
+		bool Open(const std::string& Path, std::string& OutError);
+
+		std::vector<uint64_t> GetSimulationIDs() const;
+		bool GetInfo(uint64_t SimulationID, FSimTrajectoryInfo& OutInfo) const;
+		bool ReadFrame(uint64_t SimulationID, int Frame, std::vector<FSimVec3>& OutPositions) const;
+
+	private:
+		FSimMappedFile File;
+		std::unordered_map<uint64_t, uint64_t> BlockOffsets;
+		std::vector<uint64_t> SimulationIDs;
+	};
+}
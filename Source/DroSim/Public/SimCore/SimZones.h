@@ -0,0 +1,105 @@
+#pragma once
+
+#include <map>
+#include <memory>
+#include <shared_mutex>
+#include <tuple>
+#include <vector>
+
+#include "SimConfig.h"
+#include "SimMath.h"
+
+namespace DroSimCore
+{
+	/**
+	 * Search zone of a drone, as two diagonal points.
+	 *
+	 * TopLeft holds the highest X and lowest Y, BottomRight the lowest X and highest Y.
+	 */
+	struct FSimZone
+	{
+		FSimVec2 TopLeft;
+		FSimVec2 BottomRight;
+
+		bool IsOutOfBounds(const FSimVec3& Point) const
+		{
+			return Point.X < BottomRight.X
+				|| Point.Y < TopLeft.Y
+				|| Point.X > TopLeft.X
+				|| Point.Y > BottomRight.Y;
+		}
+	};
+
+	/**
+	 * Divides the environment in search zones, one per drone: zone i is searched by the drone of ID i + 1.
+	 *
+	 * Derived classes implement the layouts of Config.Partition.
+	 */
+	class FSimZonePartitioner
+	{
+	public:
+		virtual ~FSimZonePartitioner() = default;
+
+		virtual std::vector<FSimZone> Partition(const FSimVec2& EnvSize, int NumDrones) const = 0;
+
+		static std::unique_ptr<FSimZonePartitioner> Make(const FSimConfig& Config);
+	};
+
+	/** Full lines of MaxColumns zones, the remaining zones sharing a last line. */
+	class FSimGridPartitioner : public FSimZonePartitioner
+	{
+	public:
+		explicit FSimGridPartitioner(const int InMaxColumns) : MaxColumns(InMaxColumns) {}
+
+		virtual std::vector<FSimZone> Partition(const FSimVec2& EnvSize, int NumDrones) const override;
+
+	private:
+		int MaxColumns;
+	};
+
+	/** One strip of equal width per drone, across the whole length of the environment. */
+	class FSimStripPartitioner : public FSimZonePartitioner
+	{
+	public:
+		virtual std::vector<FSimZone> Partition(const FSimVec2& EnvSize, int NumDrones) const override;
+	};
+
+	/**
+	 * Same lines as the grid, over the part of the environment the objective can spawn in only, and with line
+	 * heights proportional to their number of zones: every zone has the same chance to hold the objective.
+	 */
+	class FSimBalancedPartitioner : public FSimZonePartitioner
+	{
+	public:
+		FSimBalancedPartitioner(const int InMaxColumns, const double InMinDistanceRatio)
+			: MaxColumns(InMaxColumns)
+			, MinDistanceRatio(InMinDistanceRatio)
+		{
+		}
+
+		virtual std::vector<FSimZone> Partition(const FSimVec2& EnvSize, int NumDrones) const override;
+
+	private:
+		int MaxColumns;
+		double MinDistanceRatio;
+	};
+
+	/**
+	 * Zones already partitioned, kept for the whole run since they only depend on the drone count and settings
+	 * that do not change. Thread-safe, the simulations of a group look their zones up concurrently.
+	 */
+	class FSimZoneCache
+	{
+	public:
+		const std::vector<FSimZone>& Get(const FSimConfig& Config, int NumDrones);
+
+		static FSimZoneCache& Shared();
+
+	private:
+		// Partition, drone count, environment size, max columns, min distance ratio
+		using FKey = std::tuple<ESimPartition, int, double, double, int, float>;
+
+		std::shared_mutex Mutex;
+		std::map<FKey, std::vector<FSimZone>> Entries;
+	};
+}
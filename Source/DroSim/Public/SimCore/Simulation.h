@@ -0,0 +1,127 @@
+#pragma once
+
+#include <memory>
+#include <vector>
+
+#include "SimConfig.h"
+#include "SimCoverage.h"
+#include "SimDrone.h"
+#include "SimDroneBatch.h"
+#include "SimObjective.h"
+#include "SimObjectiveGrid.h"
+#include "SimRandom.h"
+#include "SimTrajectory.h"
+
+namespace DroSimCore
+{
+	/** Parameters shared by every simulation of a group. */
+	struct FSimGroupParams
+	{
+		float Speed = 0;
+		int NumDrones = 0;
+		float MaxTimePerSim = 0;
+		// Batteries each drone carries, which its weight and, with the energy model, its energy come from
+		int BatteryCount = 0;
+	};
+
+	/**
+	 * Outcome of a single simulation.
+	 *
+	 * FlightTime is how long the drones flew: the time to find, the moment the simulation was found hopeless or
+	 * every battery emptied, or the maximum time.
+	 * Consumption is the energy the hungriest drone drew over the flight with the batteries of the group, in Wh:
+	 * integrated substep by substep with the energy model, turns and slowdowns included, and level flight at
+	 * the group speed over FlightTime without it.
+	 */
+	struct FSimOutcome
+	{
+		bool Found = false;
+		float TimeToFind = 0;
+		bool EndedHopeless = false;
+		bool EndedDepleted = false;
+		float FlightTime = 0;
+		float Consumption = 0;
+	};
+
+	/**
+	 * A single simulation: objectives and a set of drones, stepped until enough objectives are found (see
+	 * FSimConfig::RequiredObjectives) or the maximum simulated time is reached. With the energy model, drones
+	 * drop out once their battery is empty, and the simulation ends when every one of them has.
+	 *
+	 * Its random draws only depend on (seed, simulation ID): the objectives draw from the simulation stream
+	 * and every drone from its own stream, see FSimRandom::ForStream.
+	 *
+	 * Engine-free equivalent of what AManager::InitSimulation spawns in the world.
+	 */
+	class FSimulation
+	{
+	public:
+		FSimulation(const FSimConfig& InConfig, const FSimGroupParams& InParams, uint64_t Seed, uint64_t InSimulationID);
+
+		bool Step();
+		FSimOutcome Run();
+
+		static FSimVec3 DrawObjectiveSpawnPoint(const FSimConfig& Config, uint64_t Seed, uint64_t SimulationID);
+		static std::vector<FSimVec3> DrawObjectiveSpawnPoints(const FSimConfig& Config, uint64_t Seed, uint64_t SimulationID);
+
+		void RecordTrajectory(FSimTrajectoryBuilder* InTrajectory);
+		void TrackCoverage();
+
+		uint64_t GetSimulationID() const { return SimulationID; }
+		bool HasEnded() const { return bHasEnded; }
+		float GetCurrentSimulatedTime() const { return CurrentSimulatedTime; }
+		const FSimOutcome& GetOutcome() const { return Outcome; }
+		const std::vector<FSimObjective>& GetObjectives() const { return Objectives; }
+		const std::vector<float>& GetObjectiveFoundTimes() const { return ObjectiveFoundTimes; }
+		int GetNumFoundObjectives() const { return NumFoundObjectives; }
+		const std::vector<std::unique_ptr<FSimDrone>>& GetDrones() const { return Drones; }
+		const FSimDroneBatch& GetDroneBatch() const { return DroneBatch; }
+		bool IsTrackingCoverage() const { return bTracksCoverage; }
+		double GetCoverage() const { return Coverage.GetCoverage(); }
+
+	private:
+		const FSimConfig& Config;
+		FSimGroupParams Params;
+		uint64_t SimulationID;
+
+		// Found times are negative until found, IsObjectiveFound mirrors them for the grid
+		std::vector<FSimObjective> Objectives;
+		std::vector<float> ObjectiveFoundTimes;
+		std::vector<uint8_t> IsObjectiveFound;
+		int NumFoundObjectives = 0;
+		std::vector<FSimVec3> ObjectiveStarts;
+		std::vector<FSimVec3> ObjectiveEnds;
+
+		std::vector<std::unique_ptr<FSimDrone>> Drones;
+		FSimDroneBatch DroneBatch;
+		std::vector<int> ArrivedDrones;
+
+		// Energy model only: energy left in each drone's batteries, in J
+		void DrainBatteries();
+		float MeasureConsumption() const;
+		std::vector<double> DroneEnergies;
+		double HoverStepEnergy = 0;
+		double TurnEnergyPerRadian = 0;
+
+		void FindContacts();
+		bool IsHopeless() const;
+		FSimObjectiveGrid ObjectiveGrid;
+		std::vector<double> ContactAlphas;
+		std::vector<std::pair<double, int>> Contacts;
+
+		void RecordFrame();
+		FSimTrajectoryBuilder* Trajectory = nullptr;
+		std::vector<FSimVec3> FramePositions;
+
+		void StampCoverage();
+		bool bTracksCoverage = false;
+		FSimCoverage Coverage;
+		int CoverageStampInterval = 1;
+		int StepsSinceStamp = 0;
+		float NextHopelessCheck = 0;
+
+		float CurrentSimulatedTime = 0;
+		bool bHasEnded = false;
+		FSimOutcome Outcome;
+	};
+}
@@ -0,0 +1,291 @@
+/**
+ * Benchmarks of the DroSim simulation core.
+ *
+ * For every strategy and every drone count it measures:
+ *  - the stepping loop of the strategy alone: drones moved by FSimDroneBatch, with the strategy picking new
+ *    destinations on arrival, in ns per drone-substep;
+ *  - the zone partition of the configuration, in ns per call, and the cached lookup simulations use instead;
+ *  - full simulations with the other settings of SimConfig.ini, in simulations per second, the sweep strategy
+ *    being also solved by FSimSweepOracle.
+ *
+ * Usage: DroSimBench [--config <SimConfig.ini>] [--output <bench.json>] [--drones <n,n,...>] [--min-time <seconds>] [--seed <n>]
+ *
+ * Results are written as JSON, to the output file if given and to the standard output otherwise.
+ */
+
+#include <chrono>
+#include <cstdio>
+#include <cstdlib>
+#include <cstring>
+#include <string>
+#include <vector>
+
+#include "SimCore/SimConfig.h"
+#include "SimCore/SimDrone.h"
+#include "SimCore/SimDroneBatch.h"
+#include "SimCore/SimOracle.h"
+#include "SimCore/SimResults.h"
+#include "SimCore/SimSearch.h"
+#include "SimCore/SimZones.h"
+#include "SimCore/Simulation.h"
+
+using namespace DroSimCore;
+
+namespace
+{
+	using FClock = std::chrono::steady_clock;
+
+	struct FBenchOptions
+	{
+		std::string ConfigPath = "Content/SimConfig.ini";
+		std::string OutputPath;
+		std::vector<int> DroneCounts = {1, 8, 64, 1024};
+		double MinTime = 0.5;
+		uint32_t Seed = 1;
+	};
+
+	void PrintUsage()
+	{
+		std::fprintf(stderr, "Usage: DroSimBench [--config <SimConfig.ini>] [--output <bench.json>] [--drones <n,n,...>] [--min-time <seconds>] [--seed <n>]\n");
+	}
+
+	bool ParseDroneCounts(const char* Text, std::vector<int>& OutCounts)
+	{
+		OutCounts.clear();
+		for (const char* Cursor = Text; *Cursor;)
+		{
+			char* End;
+			const long Count = std::strtol(Cursor, &End, 10);
+			if (End == Cursor || Count < 1) return false;
+			OutCounts.push_back((int)Count);
+			Cursor = *End == ',' ? End + 1 : End;
+		}
+		return !OutCounts.empty();
+	}
+
+	bool ParseArguments(const int Argc, char** Argv, FBenchOptions& Options)
+	{
+		for (int i = 1; i < Argc; i++)
+		{
+			const char* Arg = Argv[i];
+			const bool HasValue = i + 1 < Argc;
+			if (!std::strcmp(Arg, "--config") && HasValue) Options.ConfigPath = Argv[++i];
+			else if (!std::strcmp(Arg, "--output") && HasValue) Options.OutputPath = Argv[++i];
+			else if (!std::strcmp(Arg, "--drones") && HasValue)
+			{
+				if (!ParseDroneCounts(Argv[++i], Options.DroneCounts)) return false;
+			}
+			else if (!std::strcmp(Arg, "--min-time") && HasValue) Options.MinTime = std::atof(Argv[++i]);
+			else if (!std::strcmp(Arg, "--seed") && HasValue) Options.Seed = (uint32_t)std::strtoul(Argv[++i], nullptr, 10);
+			else return false;
+		}
+		return Options.MinTime > 0;
+	}
+
+	const char* StrategyName(const ESimStrategy Strategy)
+	{
+		switch (Strategy)
+		{
+		case ESimStrategy::Random: return "random";
+		case ESimStrategy::Sweep: return "sweep";
+		case ESimStrategy::Spiral: return "spiral";
+		default: return "unknown";
+		}
+	}
+
+	const char* PartitionName(const ESimPartition Partition)
+	{
+		switch (Partition)
+		{
+		case ESimPartition::Grid: return "grid";
+		case ESimPartition::Strips: return "strips";
+		case ESimPartition::Balanced: return "balanced";
+		default: return "unknown";
+		}
+	}
+
+	double SecondsSince(const FClock::time_point Start)
+	{
+		return std::chrono::duration<double>(FClock::now() - Start).count();
+	}
+
+
+	/**
+	 * Times the stepping loop of a strategy, the way FSimulation::Step runs it but without the objective.
+	 *
+	 * Substeps are run in rounds until MinTime is reached, every round starting from fresh drones so that
+	 * strategies which run out of zone to search are measured while they still search.
+	 */
+	std::string BenchKernel(const FSimConfig& Config, const ESimStrategy Strategy, const int NumDrones, const float Speed,
+		const FBenchOptions& Options)
+	{
+		const std::vector<FSimZone>& Zones = FSimZoneCache::Shared().Get(Config, NumDrones);
+		const int SubstepsPerRound = 1000;
+		std::vector<int> ArrivedDrones;
+		uint64_t DroneSubsteps = 0;
+		double Elapsed = 0;
+
+		for (uint64_t Round = 0; Elapsed < Options.MinTime; Round++)
+		{
+			std::vector<std::unique_ptr<FSimDrone>> Drones;
+			FSimDroneBatch Batch;
+			Batch.Reserve(NumDrones);
+			for (int i = 0; i < NumDrones; i++)
+			{
+				Drones.push_back(MakeSimDrone(Strategy, Config, i + 1, Zones[i], Speed, FSimRandom::ForStream(Options.Seed, Round, i + 1)));
+				Drones.back()->Start();
+				Drones.back()->AttachToBatch(Batch);
+			}
+
+			const FClock::time_point Start = FClock::now();
+			for (int Substep = 0; Substep < SubstepsPerRound; Substep++)
+			{
+				Batch.StepAll(Config.Step, Config.MovementTolerance, ArrivedDrones);
+				for (const int i : ArrivedDrones) Drones[i]->HandleBatchArrival();
+			}
+			Elapsed += SecondsSince(Start);
+			DroneSubsteps += (uint64_t)NumDrones * SubstepsPerRound;
+		}
+
+		return SimPrintf("{\"strategy\":\"%s\",\"drones\":%d,\"drone_substeps\":%llu,\"seconds\":%.6f,\"ns_per_drone_substep\":%.3f}",
+			StrategyName(Strategy), NumDrones, (unsigned long long)DroneSubsteps, Elapsed, Elapsed * 1e9 / (double)DroneSubsteps);
+	}
+
+
+	/**
+	 * Times the partition of the environment in one search zone per drone, then the cached lookup of the same zones.
+	 */
+	std::string BenchZones(const FSimConfig& Config, const int NumDrones, const FBenchOptions& Options)
+	{
+		const std::unique_ptr<FSimZonePartitioner> Partitioner = FSimZonePartitioner::Make(Config);
+		uint64_t Calls = 0;
+		size_t Checksum = 0;
+		FClock::time_point Start = FClock::now();
+		double Elapsed = 0;
+		while (Elapsed < Options.MinTime)
+		{
+			for (int i = 0; i < 100; i++) Checksum += Partitioner->Partition(Config.EnvSize, NumDrones).size();
+			Calls += 100;
+			Elapsed = SecondsSince(Start);
+		}
+
+		uint64_t Lookups = 0;
+		Start = FClock::now();
+		double LookupElapsed = 0;
+		while (LookupElapsed < Options.MinTime)
+		{
+			for (int i = 0; i < 100; i++) Checksum += FSimZoneCache::Shared().Get(Config, NumDrones).size();
+			Lookups += 100;
+			LookupElapsed = SecondsSince(Start);
+		}
+
+		return SimPrintf("{\"drones\":%d,\"calls\":%llu,\"seconds\":%.6f,\"ns_per_call\":%.1f,\"ns_per_cached_lookup\":%.1f,\"zones\":%llu}",
+			NumDrones, (unsigned long long)Calls, Elapsed, Elapsed * 1e9 / (double)Calls, LookupElapsed * 1e9 / (double)Lookups,
+			(unsigned long long)(Checksum / (Calls + Lookups)));
+	}
+
+
+	/**
+	 * Runs full simulations until MinTime is reached, with consecutive simulation IDs, stepped or solved by the oracle.
+	 */
+	std::string BenchSimulations(const FSimConfig& Config, const int NumDrones, const float Speed, const bool UsesOracle,
+		const FBenchOptions& Options)
+	{
+		const FSimGroupParams Params = FSimSearch::Make(Config)->MakeGroupParams(Speed, NumDrones);
+
+		uint64_t Simulations = 0;
+		uint64_t Found = 0;
+		const FClock::time_point Start = FClock::now();
+		double Elapsed = 0;
+		while (Elapsed < Options.MinTime)
+		{
+			const uint64_t SimulationID = Simulations++;
+			const FSimOutcome Outcome = UsesOracle ? FSimSweepOracle(Config, Params, Options.Seed, SimulationID).Run()
+				: FSimulation(Config, Params, Options.Seed, SimulationID).Run();
+			if (Outcome.Found) Found++;
+			Elapsed = SecondsSince(Start);
+		}
+
+		return SimPrintf("{\"strategy\":\"%s\",\"oracle\":%s,\"drones\":%d,\"speed\":%g,\"simulations\":%llu,\"seconds\":%.6f,"
+			"\"sims_per_second\":%.2f,\"found_ratio\":%.3f}",
+			StrategyName(Config.Strategy), UsesOracle ? "true" : "false", NumDrones, Speed, (unsigned long long)Simulations, Elapsed,
+			(double)Simulations / Elapsed, (double)Found / (double)Simulations);
+	}
+
+
+	std::string JoinArray(const std::vector<std::string>& Items)
+	{
+		std::string Text = "[";
+		for (size_t i = 0; i < Items.size(); i++) Text += (i ? ",\n    " : "\n    ") + Items[i];
+		return Text + "\n  ]";
+	}
+}
+
+
+int main(int Argc, char** Argv)
+{
+	FBenchOptions Options;
+	if (!ParseArguments(Argc, Argv, Options))
+	{
+		PrintUsage();
+		return 2;
+	}
+
+	FSimConfig Config;
+	std::string Error;
+	if (!Config.LoadFromFile(Options.ConfigPath, Error))
+	{
+		std::fprintf(stderr, "%s\n", Error.c_str());
+		return 1;
+	}
+
+	// Drones fly at the middle of the speed range of the sweep
+	const float Speed = (Config.MinSpeed + Config.MaxSpeed) / 2;
+	const ESimStrategy Strategies[] = {ESimStrategy::Random, ESimStrategy::Sweep, ESimStrategy::Spiral};
+
+	std::vector<std::string> Kernels, Zones, Simulations;
+	for (const int NumDrones : Options.DroneCounts)
+	{
+		for (const ESimStrategy Strategy : Strategies)
+		{
+			Kernels.push_back(BenchKernel(Config, Strategy, NumDrones, Speed, Options));
+			std::fprintf(stderr, "kernel %s\n", Kernels.back().c_str());
+		}
+		Zones.push_back(BenchZones(Config, NumDrones, Options));
+		std::fprintf(stderr, "zones %s\n", Zones.back().c_str());
+
+		// Full simulations keep every other setting of the configuration
+		for (const ESimStrategy Strategy : Strategies)
+		{
+			FSimConfig StrategyConfig = Config;
+			StrategyConfig.Strategy = Strategy;
+			Simulations.push_back(BenchSimulations(StrategyConfig, NumDrones, Speed, false, Options));
+			std::fprintf(stderr, "simulations %s\n", Simulations.back().c_str());
+			if (!FSimSweepOracle::Supports(StrategyConfig)) continue;
+			Simulations.push_back(BenchSimulations(StrategyConfig, NumDrones, Speed, true, Options));
+			std::fprintf(stderr, "simulations %s\n", Simulations.back().c_str());
+		}
+	}
+
+	const std::string Json = SimPrintf("{\n  \"config\":\"%s\",\n  \"instruction_set\":\"%s\",\n  \"partition\":\"%s\",\n  \"seed\":%u,\n  \"step\":%g,\n",
+		Options.ConfigPath.c_str(), FSimDroneBatch::GetInstructionSetName(), PartitionName(Config.Partition), Options.Seed, Config.Step)
+		+ "  \"kernels\":" + JoinArray(Kernels) + ",\n"
+		+ "  \"zones\":" + JoinArray(Zones) + ",\n"
+		+ "  \"simulations\":" + JoinArray(Simulations) + "\n}\n";
+
+	if (Options.OutputPath.empty())
+	{
+		std::fputs(Json.c_str(), stdout);
+		return 0;
+	}
+
+	FILE* File = std::fopen(Options.OutputPath.c_str(), "wb");
+	if (!File)
+	{
+		std::fprintf(stderr, "Cannot open %s for writing\n", Options.OutputPath.c_str());
+		return 1;
+	}
+	std::fputs(Json.c_str(), File);
+	std::fclose(File);
+	return 0;
+}
@@ -0,0 +1,555 @@
+/**
+ * Headless driver for the DroSim simulation core.
+ *
+ * Runs the same parameter search as AManager without the engine and writes the fast/slow
+ * configurations to a results file.
+ *
+ * Usage: DroSimCli [--config <SimConfig.ini>] [--output <results.txt>] [--records <file.csv|file.jsonl>] [--trajectory <file>] [--seed <n>] [--threads <n>] [--checkpoint <file> [--resume]] [--cache <dir>] [--quiet]
+ *        DroSimCli [--config <SimConfig.ini>] --seed <n> --replay <simulation id> --speed <m/s> --drones <n>
+ *        DroSimCli --inspect <trajectory file> [--sim <simulation id> [--frame <n>]]
+ *        DroSimCli [--config <SimConfig.ini>] [--seed <n>] --check-oracle <simulations>
+ *        DroSimCli [--config <SimConfig.ini>] [--seed <n>] [--threads <n>] --compare-search
+ *        DroSimCli [--config <SimConfig.ini>] [--output <results.txt>] [--records <file>] [--trajectory <file>] [--seed <n>] [--threads <n>] --workers <n> [--shards <n>] [--cache <dir>] [--quiet]
+ *
+ * With a checkpoint file, the state of the sweep is saved there as it goes, and --resume continues the sweep
+ * it holds, with the seed it was saved with. The records file is cut back to its length at the checkpoint.
+ * A trajectory file has no such point to be cut back to, so --resume refuses to record trajectories.
+ * With a cache directory, groups already run by a previous sweep with the same seed and simulation settings
+ * are read from it instead of being simulated again (see FSimGroupCache), except when recording trajectories.
+ * The replay form runs a single simulation of a sweep again, from the seed and the simulation ID it logged.
+ * The inspect form reads a trajectory file recorded with --trajectory: it lists its simulations, or prints
+ * the positions of the objectives and the drones of one simulation, at every frame or at a single one.
+ * The check-oracle form runs sweep simulations both stepped and with FSimSweepOracle, for every drone count
+ * and speed of the configuration, and reports the simulations whose outcomes differ. The strategy is forced to
+ * sweep, other settings the oracle does not support (see FSimSweepOracle::Supports) are refused.
+ * The compare-search form runs the sweep with both search modes, linear and bisection, and reports where
+ * their curves differ and how many simulations each one took. Groups only have the same outcome in both
+ * with common_random_numbers, otherwise their simulation IDs differ.
+ * The workers form splits the sweep in shards of drone counts, run by that many worker processes started
+ * from this executable (see FSimCoordinator). --threads is then per worker, hardware threads / workers by
+ * default, and records and trajectories are written to one file per shard. Every shard starts its own search,
+ * so from the first drone count of each shard but the first, slow configurations may differ from a plain run
+ * (see FSimShard). Shards are not checkpointed: --checkpoint, --resume and checkpoint_file are refused there.
+ */
+
+#include <algorithm>
+#include <chrono>
+#include <cmath>
+#include <cstdio>
+#include <cstdlib>
+#include <cstring>
+#include <random>
+#include <string>
+#include <thread>
+
+#include "DroSimCoordinator.h"
+#include "SimCore/SimCheckpoint.h"
+#include "SimCore/SimConfig.h"
+#include "SimCore/SimGroupCache.h"
+#include "SimCore/SimOracle.h"
+#include "SimCore/SimResults.h"
+#include "SimCore/SimSweep.h"
+#include "SimCore/Simulation.h"
+
+using namespace DroSimCli;
+using namespace DroSimCore;
+
+namespace
+{
+	struct FCliOptions
+	{
+		std::string ConfigPath = "Content/SimConfig.ini";
+		std::string OutputPath = "results.txt";
+		bool HasRecordsPath = false;
+		std::string RecordsPath;
+		bool HasTrajectoryPath = false;
+		std::string TrajectoryPath;
+		bool HasCheckpointPath = false;
+		std::string CheckpointPath;
+		bool IsResume = false;
+		bool HasCacheDir = false;
+		std::string CacheDir;
+		bool HasSeed = false;
+		uint32_t Seed = 0;
+		int Threads = -1;
+		bool Quiet = false;
+
+		bool IsReplay = false;
+		uint64_t ReplayID = 0;
+		float ReplaySpeed = 0;
+		int ReplayNumDrones = 0;
+
+		std::string InspectPath;
+		bool HasInspectID = false;
+		uint64_t InspectID = 0;
+		int InspectFrame = -1;
+
+		int OracleCheckSims = 0;
+		bool IsCompareSearch = false;
+
+		int Workers = 0;
+		int Shards = 0;
+		bool IsWorker = false;
+	};
+
+	void PrintUsage()
+	{
+		std::fprintf(stderr, "Usage: DroSimCli [--config <SimConfig.ini>] [--output <results.txt>] [--records <file.csv|file.jsonl>] [--trajectory <file>] [--seed <n>] [--threads <n>] [--checkpoint <file> [--resume]] [--cache <dir>] [--quiet]\n");
+		std::fprintf(stderr, "       DroSimCli [--config <SimConfig.ini>] --seed <n> --replay <simulation id> --speed <m/s> --drones <n>\n");
+		std::fprintf(stderr, "       DroSimCli --inspect <trajectory file> [--sim <simulation id> [--frame <n>]]\n");
+		std::fprintf(stderr, "       DroSimCli [--config <SimConfig.ini>] [--seed <n>] --check-oracle <simulations>\n");
+		std::fprintf(stderr, "       DroSimCli [--config <SimConfig.ini>] [--seed <n>] [--threads <n>] --compare-search\n");
+		std::fprintf(stderr, "       DroSimCli [--config <SimConfig.ini>] [--output <results.txt>] [--records <file>] [--trajectory <file>] [--seed <n>] [--threads <n>] --workers <n> [--shards <n>] [--cache <dir>] [--quiet]\n");
+	}
+
+	bool ParseArguments(const int Argc, char** Argv, FCliOptions& Options)
+	{
+		for (int i = 1; i < Argc; i++)
+		{
+			const char* Arg = Argv[i];
+			const bool HasValue = i + 1 < Argc;
+			if (!std::strcmp(Arg, "--config") && HasValue) Options.ConfigPath = Argv[++i];
+			else if (!std::strcmp(Arg, "--output") && HasValue) Options.OutputPath = Argv[++i];
+			else if (!std::strcmp(Arg, "--records") && HasValue)
+			{
+				Options.HasRecordsPath = true;
+				Options.RecordsPath = Argv[++i];
+			}
+			else if (!std::strcmp(Arg, "--trajectory") && HasValue)
+			{
+				Options.HasTrajectoryPath = true;
+				Options.TrajectoryPath = Argv[++i];
+			}
+			else if (!std::strcmp(Arg, "--checkpoint") && HasValue)
+			{
+				Options.HasCheckpointPath = true;
+				Options.CheckpointPath = Argv[++i];
+			}
+			else if (!std::strcmp(Arg, "--resume")) Options.IsResume = true;
+			else if (!std::strcmp(Arg, "--cache") && HasValue)
+			{
+				Options.HasCacheDir = true;
+				Options.CacheDir = Argv[++i];
+			}
+			else if (!std::strcmp(Arg, "--seed") && HasValue)
+			{
+				Options.HasSeed = true;
+				Options.Seed = (uint32_t)std::strtoul(Argv[++i], nullptr, 10);
+			}
+			else if (!std::strcmp(Arg, "--threads") && HasValue) Options.Threads = std::atoi(Argv[++i]);
+			else if (!std::strcmp(Arg, "--quiet")) Options.Quiet = true;
+			else if (!std::strcmp(Arg, "--replay") && HasValue)
+			{
+				Options.IsReplay = true;
+				Options.ReplayID = std::strtoull(Argv[++i], nullptr, 10);
+			}
+			else if (!std::strcmp(Arg, "--speed") && HasValue) Options.ReplaySpeed = (float)std::atof(Argv[++i]);
+			else if (!std::strcmp(Arg, "--drones") && HasValue) Options.ReplayNumDrones = std::atoi(Argv[++i]);
+			else if (!std::strcmp(Arg, "--inspect") && HasValue) Options.InspectPath = Argv[++i];
+			else if (!std::strcmp(Arg, "--sim") && HasValue)
+			{
+				Options.HasInspectID = true;
+				Options.InspectID = std::strtoull(Argv[++i], nullptr, 10);
+			}
+			else if (!std::strcmp(Arg, "--frame") && HasValue) Options.InspectFrame = std::atoi(Argv[++i]);
+			else if (!std::strcmp(Arg, "--check-oracle") && HasValue)
+			{
+				Options.OracleCheckSims = std::atoi(Argv[++i]);
+				if (Options.OracleCheckSims < 1) return false;
+			}
+			else if (!std::strcmp(Arg, "--compare-search")) Options.IsCompareSearch = true;
+			else if (!std::strcmp(Arg, "--workers") && HasValue)
+			{
+				Options.Workers = std::atoi(Argv[++i]);
+				if (Options.Workers < 1) return false;
+			}
+			else if (!std::strcmp(Arg, "--shards") && HasValue)
+			{
+				Options.Shards = std::atoi(Argv[++i]);
+				if (Options.Shards < 1) return false;
+			}
+			else if (!std::strcmp(Arg, "--worker")) Options.IsWorker = true;
+			else return false;
+		}
+		if (Options.Shards > 0 && Options.Workers == 0) return false;
+		return !Options.IsReplay || (Options.HasSeed && Options.ReplaySpeed > 0 && Options.ReplayNumDrones > 0);
+	}
+
+
+	/**
+	 * Runs a single simulation of a sweep again and prints its outcome, with the coverage of the zones
+	 * every 10 simulated minutes.
+	 */
+	int Replay(const FSimConfig& Config, const FCliOptions& Options)
+	{
+		const FSimGroupParams Params = FSimSearch::Make(Config)->MakeGroupParams(Options.ReplaySpeed, Options.ReplayNumDrones);
+
+		FSimulation Simulation(Config, Params, Options.Seed, Options.ReplayID);
+		const FSimVec3 ObjectiveStart = Simulation.GetObjectives()[0].GetPosition();
+		std::printf("Simulation %llu of seed %u : %d drone%s at %d m/s, objective spawned at (%d, %d)\n",
+			(unsigned long long)Options.ReplayID, Options.Seed, Params.NumDrones, Params.NumDrones > 1 ? "s" : "",
+			(int)Params.Speed, (int)ObjectiveStart.X, (int)ObjectiveStart.Y);
+		if (Config.ObjectiveCount > 1)
+			std::printf("%d objectives, %d to find\n", Config.ObjectiveCount, Config.RequiredObjectives());
+
+		Simulation.TrackCoverage();
+		int ReportedMinutes = 0;
+		while (Simulation.Step())
+			if (Simulation.GetCurrentSimulatedTime() >= (ReportedMinutes + 10) * 60.f)
+			{
+				ReportedMinutes += 10;
+				std::printf("%3d min : %5.1f%% covered\n", ReportedMinutes, Simulation.GetCoverage() * 100);
+			}
+
+		const FSimOutcome& Outcome = Simulation.GetOutcome();
+		std::printf("Coverage : %.1f%%\n", Simulation.GetCoverage() * 100);
+		if (Config.ObjectiveCount > 1)
+		{
+			const std::vector<float>& FoundTimes = Simulation.GetObjectiveFoundTimes();
+			std::printf("%d/%d objectives found\n", Simulation.GetNumFoundObjectives(), Config.ObjectiveCount);
+			for (size_t i = 0; i < FoundTimes.size(); i++)
+				if (FoundTimes[i] >= 0) std::printf("Objective %zu found after %.1f simulated seconds\n", i, FoundTimes[i]);
+		}
+		if (Outcome.Found) std::printf("Found after %.1f simulated seconds\n", Outcome.TimeToFind);
+		else if (Outcome.EndedHopeless)
+			std::printf("Hopeless after %.1f simulated seconds, not found within %.1f\n", Simulation.GetCurrentSimulatedTime(), Params.MaxTimePerSim);
+		else if (Outcome.EndedDepleted)
+			std::printf("Every battery empty after %.1f simulated seconds, not found\n", Simulation.GetCurrentSimulatedTime());
+		else std::printf("Not found within %.1f simulated seconds\n", Params.MaxTimePerSim);
+		return 0;
+	}
+
+
+	/**
+	 * Runs the same sweep simulations stepped and with the oracle, and compares their outcomes.
+	 *
+	 * Times to find may differ by rounding only, a thousandth of a substep is allowed.
+	 */
+	int CheckOracle(FSimConfig Config, const FCliOptions& Options)
+	{
+		Config.Strategy = ESimStrategy::Sweep;
+		if (!FSimSweepOracle::Supports(Config))
+		{
+			std::fprintf(stderr, "--check-oracle needs a config the oracle supports : objective_count = 1 and energy_model = false\n");
+			return 2;
+		}
+		const std::unique_ptr<FSimSearch> Search = FSimSearch::Make(Config);
+		const double Tolerance = Config.Step * 1e-3;
+
+		int Simulations = 0;
+		int Mismatches = 0;
+		double SteppedSeconds = 0;
+		double OracleSeconds = 0;
+		uint64_t SimulationID = 0;
+		for (int NumDrones = Config.MinNumDrones; NumDrones <= Config.MaxNumDrones; NumDrones += Config.DroneIncrement)
+			for (float Speed = Config.MinSpeed; Speed <= Config.MaxSpeed; Speed += Config.SpeedIncrement)
+			{
+				const FSimGroupParams Params = Search->MakeGroupParams(Speed, NumDrones);
+
+				for (int i = 0; i < Options.OracleCheckSims; i++, SimulationID++)
+				{
+					auto Start = std::chrono::steady_clock::now();
+					const FSimOutcome Stepped = FSimulation(Config, Params, Options.Seed, SimulationID).Run();
+					SteppedSeconds += std::chrono::duration<double>(std::chrono::steady_clock::now() - Start).count();
+
+					Start = std::chrono::steady_clock::now();
+					const FSimOutcome Oracle = FSimSweepOracle(Config, Params, Options.Seed, SimulationID).Run();
+					OracleSeconds += std::chrono::duration<double>(std::chrono::steady_clock::now() - Start).count();
+
+					Simulations++;
+					if (Stepped.Found == Oracle.Found && (!Stepped.Found || std::abs(Stepped.TimeToFind - Oracle.TimeToFind) <= Tolerance))
+						continue;
+					Mismatches++;
+					std::printf("Simulation %llu, %d drone%s at %g m/s : stepped %s %.3f, oracle %s %.3f\n", (unsigned long long)SimulationID,
+						NumDrones, NumDrones > 1 ? "s" : "", Speed, Stepped.Found ? "found after" : "not found,", Stepped.TimeToFind,
+						Oracle.Found ? "found after" : "not found,", Oracle.TimeToFind);
+				}
+			}
+
+		std::printf("%d/%d simulations agree\n", Simulations - Mismatches, Simulations);
+		std::printf("Stepped : %.1f us per simulation, oracle : %.1f us per simulation\n",
+			SteppedSeconds * 1e6 / Simulations, OracleSeconds * 1e6 / Simulations);
+		return Mismatches == 0 ? 0 : 1;
+	}
+
+
+	std::string FormatConfigResult(const bool HasConfig, const FSimConfigResult& Result)
+	{
+		if (!HasConfig) return "none";
+		return SimPrintf("%g m/s, %d batter%s", Result.Speed, Result.BatteryCount, Result.BatteryCount > 1 ? "ies" : "y");
+	}
+
+
+	/**
+	 * Runs the sweep with the linear and the bisection search, and prints where their curves differ.
+	 */
+	int CompareSearches(FSimConfig Config, const FCliOptions& Options)
+	{
+		const ESimSearchMode Modes[] = {ESimSearchMode::Linear, ESimSearchMode::Bisection};
+		const char* ModeNames[] = {"linear", "bisection"};
+		FSimResults Results[2];
+		for (int i = 0; i < 2; i++)
+		{
+			Config.SearchMode = Modes[i];
+			FSimSweep Sweep(Config, Options.Seed);
+			Results[i] = Sweep.Run();
+			std::printf("%s search : %d simulations\n", ModeNames[i], Sweep.GetSimulationCount());
+		}
+
+		int Differences = 0;
+		const FSimResults& Linear = Results[0];
+		const FSimResults& Bisection = Results[1];
+		const auto IsSame = [](const FSimConfigResult& A, const FSimConfigResult& B)
+		{
+			return A.Speed == B.Speed && A.BatteryCount == B.BatteryCount;
+		};
+		if (Linear.HasFastConfig != Bisection.HasFastConfig || (Linear.HasFastConfig && !IsSame(Linear.FastConfig, Bisection.FastConfig)))
+		{
+			Differences++;
+			std::printf("Fast config : linear %s, bisection %s\n", FormatConfigResult(Linear.HasFastConfig, Linear.FastConfig).c_str(),
+				FormatConfigResult(Bisection.HasFastConfig, Bisection.FastConfig).c_str());
+		}
+
+		// Slow configs are in drone count order, without the counts a search found nothing for
+		const auto FindSlowConfig = [](const FSimResults& SearchResults, const int NumDrones) -> const FSimConfigResult*
+		{
+			for (const FSimConfigResult& Result : SearchResults.SlowConfigs)
+				if (Result.NumDrones == NumDrones) return &Result;
+			return nullptr;
+		};
+		for (int NumDrones = Config.MinNumDrones; NumDrones < Config.MaxNumDrones; NumDrones += Config.DroneIncrement)
+		{
+			const FSimConfigResult* LinearConfig = FindSlowConfig(Linear, NumDrones);
+			const FSimConfigResult* BisectionConfig = FindSlowConfig(Bisection, NumDrones);
+			if (!LinearConfig && !BisectionConfig) continue;
+			if (LinearConfig && BisectionConfig && IsSame(*LinearConfig, *BisectionConfig)) continue;
+
+			Differences++;
+			std::printf("%d drone%s : linear %s, bisection %s\n", NumDrones, NumDrones > 1 ? "s" : "",
+				FormatConfigResult(LinearConfig != nullptr, LinearConfig ? *LinearConfig : FSimConfigResult()).c_str(),
+				FormatConfigResult(BisectionConfig != nullptr, BisectionConfig ? *BisectionConfig : FSimConfigResult()).c_str());
+		}
+
+		if (Differences == 0) std::printf("Same curve\n");
+		else std::printf("%d difference%s\n", Differences, Differences > 1 ? "s" : "");
+		return Differences == 0 ? 0 : 1;
+	}
+
+
+	/**
+	 * Prints the results of a sweep and writes them to the output file.
+	 */
+	int ReportResults(const FSimResults& Results, const int SimulationCount, const double Elapsed, const FCliOptions& Options)
+	{
+		std::printf("----------------------------\n");
+		std::printf("%d simulations in %.2f s\n", SimulationCount, Elapsed);
+		for (const std::string& Line : FormatResults(Results)) std::printf("%s\n", Line.c_str());
+
+		std::string Error;
+		if (!WriteResultsToFile(Options.OutputPath, Results, Error))
+		{
+			std::fprintf(stderr, "%s\n", Error.c_str());
+			return 1;
+		}
+		return 0;
+	}
+
+
+	/**
+	 * Runs the sweep across worker processes, each one being this executable started with --worker.
+	 */
+	int RunSharded(const FSimConfig& Config, const FCliOptions& Options)
+	{
+		// Workers share the machine unless told otherwise
+		const int Threads = Options.Threads >= 0 ? Options.Threads
+			: std::max(1, (int)std::thread::hardware_concurrency() / Options.Workers);
+
+		FWorkerCommand Command;
+		Command.Executable = "/proc/self/exe";
+		Command.Arguments = {"--config", Options.ConfigPath, "--seed", std::to_string(Options.Seed), "--threads", std::to_string(Threads)};
+		if (Options.HasRecordsPath) Command.Arguments.insert(Command.Arguments.end(), {"--records", Options.RecordsPath});
+		if (Options.HasTrajectoryPath) Command.Arguments.insert(Command.Arguments.end(), {"--trajectory", Options.TrajectoryPath});
+		if (Options.HasCacheDir) Command.Arguments.insert(Command.Arguments.end(), {"--cache", Options.CacheDir});
+
+		FSimCoordinator Coordinator(Config, Command, Options.Workers, Options.Shards > 0 ? Options.Shards : Options.Workers);
+		std::printf("Seed : %u, %d worker%s of %d thread%s, %d shard%s\n", Options.Seed, Options.Workers, Options.Workers > 1 ? "s" : "",
+			Threads, Threads > 1 ? "s" : "", Coordinator.GetNumShards(), Coordinator.GetNumShards() > 1 ? "s" : "");
+		if (!Options.Quiet) Coordinator.SetLogger([](const std::string& Text) { std::printf("%s\n", Text.c_str()); });
+
+		const auto Start = std::chrono::steady_clock::now();
+		FSimResults Results;
+		std::string Error;
+		if (!Coordinator.Run(Results, Error))
+		{
+			std::fprintf(stderr, "%s\n", Error.c_str());
+			return 1;
+		}
+		const double Elapsed = std::chrono::duration<double>(std::chrono::steady_clock::now() - Start).count();
+		return ReportResults(Results, Coordinator.GetSimulationCount(), Elapsed, Options);
+	}
+
+
+	void PrintFrame(const int Frame, const float Step, const std::vector<FSimVec3>& Positions)
+	{
+		std::printf("%d %.1f", Frame, Frame * Step);
+		for (const FSimVec3& Position : Positions) std::printf(" %d,%d,%d", (int)Position.X, (int)Position.Y, (int)Position.Z);
+		std::printf("\n");
+	}
+
+
+	/**
+	 * Prints the content of a trajectory file, without simulating anything.
+	 */
+	int Inspect(const FCliOptions& Options)
+	{
+		FSimTrajectoryReader Reader;
+		std::string Error;
+		if (!Reader.Open(Options.InspectPath, Error))
+		{
+			std::fprintf(stderr, "%s\n", Error.c_str());
+			return 1;
+		}
+
+		FSimTrajectoryInfo Info;
+		if (!Options.HasInspectID)
+		{
+			for (const uint64_t SimulationID : Reader.GetSimulationIDs())
+				if (Reader.GetInfo(SimulationID, Info))
+				{
+					const int NumDrones = Info.NumEntities - Info.NumObjectives;
+					std::printf("Simulation %llu : %d drone%s, %d objective%s, %d frames (%.1f simulated seconds)\n", (unsigned long long)SimulationID,
+						NumDrones, NumDrones > 1 ? "s" : "", Info.NumObjectives, Info.NumObjectives > 1 ? "s" : "", Info.NumFrames,
+						(Info.NumFrames - 1) * Info.Step);
+				}
+			return 0;
+		}
+
+		if (!Reader.GetInfo(Options.InspectID, Info))
+		{
+			std::fprintf(stderr, "Simulation %llu is not in %s\n", (unsigned long long)Options.InspectID, Options.InspectPath.c_str());
+			return 1;
+		}
+
+		// One line per frame: frame, simulated time, then objective and drone positions, objectives first
+		std::vector<FSimVec3> Positions;
+		const int FirstFrame = Options.InspectFrame >= 0 ? Options.InspectFrame : 0;
+		const int LastFrame = Options.InspectFrame >= 0 ? Options.InspectFrame : Info.NumFrames - 1;
+		for (int Frame = FirstFrame; Frame <= LastFrame; Frame++)
+		{
+			if (!Reader.ReadFrame(Options.InspectID, Frame, Positions))
+			{
+				std::fprintf(stderr, "Cannot read frame %d of simulation %llu\n", Frame, (unsigned long long)Options.InspectID);
+				return 1;
+			}
+			PrintFrame(Frame, Info.Step, Positions);
+		}
+		return 0;
+	}
+}
+
+
+int main(int Argc, char** Argv)
+{
+	FCliOptions Options;
+	if (!ParseArguments(Argc, Argv, Options))
+	{
+		PrintUsage();
+		return 2;
+	}
+	if (!Options.InspectPath.empty()) return Inspect(Options);
+
+	FSimConfig Config;
+	std::string Error;
+	if (!Config.LoadFromFile(Options.ConfigPath, Error))
+	{
+		std::fprintf(stderr, "%s\n", Error.c_str());
+		return 1;
+	}
+
+	if (Options.Threads >= 0) Config.WorkerThreads = Options.Threads;
+	if (Options.HasCheckpointPath) Config.CheckpointFile = Options.CheckpointPath;
+	if (Options.HasCacheDir) Config.CacheDir = Options.CacheDir;
+	if (Options.Workers > 0 && (Options.IsResume || !Config.CheckpointFile.empty()))
+	{
+		std::fprintf(stderr, "--workers does not support checkpoints, remove --checkpoint, --resume and checkpoint_file\n");
+		return 2;
+	}
+	FSimCheckpoint Checkpoint;
+	if (Options.IsResume)
+	{
+		if (Options.HasTrajectoryPath ? !Options.TrajectoryPath.empty() : !Config.TrajectoryFile.empty())
+		{
+			std::fprintf(stderr, "--resume cannot record trajectories, the trajectory file would be overwritten\n");
+			return 2;
+		}
+		if (Config.CheckpointFile.empty())
+		{
+			std::fprintf(stderr, "--resume needs a checkpoint file\n");
+			return 2;
+		}
+		if (!Checkpoint.Load(Config.CheckpointFile, Error))
+		{
+			std::fprintf(stderr, "%s\n", Error.c_str());
+			return 1;
+		}
+		if (!Options.HasSeed) Options.Seed = Checkpoint.Seed;
+		Options.HasSeed = true;
+	}
+	if (!Options.HasSeed) Options.Seed = Config.Seed != 0 ? Config.Seed : std::random_device()();
+	if (Options.IsReplay) return Replay(Config, Options);
+	if (Options.OracleCheckSims > 0) return CheckOracle(Config, Options);
+	if (Options.IsCompareSearch) return CompareSearches(Config, Options);
+	if (Options.IsWorker)
+		return RunWorker(Config, Options.Seed, Options.HasRecordsPath ? Options.RecordsPath : Config.RecordsFile,
+			Options.HasTrajectoryPath ? Options.TrajectoryPath : Config.TrajectoryFile);
+	if (Options.Workers > 0) return RunSharded(Config, Options);
+
+	FSimSweep Sweep(Config, Options.Seed);
+	std::printf("Seed : %u, %d thread%s\n", Options.Seed, Sweep.GetNumThreads(), Sweep.GetNumThreads() > 1 ? "s" : "");
+	if (!Options.Quiet) Sweep.SetLogger([](const std::string& Text) { std::printf("%s\n", Text.c_str()); });
+	if (!Config.CheckpointFile.empty()) Sweep.SetCheckpointFile(Config.CheckpointFile);
+	if (Options.IsResume && !Sweep.Resume(Checkpoint, Error))
+	{
+		std::fprintf(stderr, "%s\n", Error.c_str());
+		return 1;
+	}
+	if (Options.HasRecordsPath) Config.RecordsFile = Options.RecordsPath;
+	FSimRecordWriter RecordWriter;
+	if (!Config.RecordsFile.empty())
+	{
+		if (!RecordWriter.Open(Config.RecordsFile, Error, Options.IsResume ? Checkpoint.RecordsSize : -1))
+		{
+			std::fprintf(stderr, "%s\n", Error.c_str());
+			return 1;
+		}
+		Sweep.SetRecordWriter(&RecordWriter);
+	}
+	if (Options.HasTrajectoryPath) Config.TrajectoryFile = Options.TrajectoryPath;
+	FSimTrajectoryWriter TrajectoryWriter;
+	if (!Config.TrajectoryFile.empty())
+	{
+		if (!TrajectoryWriter.Open(Config.TrajectoryFile, Error))
+		{
+			std::fprintf(stderr, "%s\n", Error.c_str());
+			return 1;
+		}
+		Sweep.SetTrajectoryWriter(&TrajectoryWriter);
+	}
+	FSimGroupCache GroupCache;
+	if (!Config.CacheDir.empty())
+	{
+		if (!GroupCache.Open(Config.CacheDir, Error))
+		{
+			std::fprintf(stderr, "%s\n", Error.c_str());
+			return 1;
+		}
+		Sweep.SetGroupCache(&GroupCache);
+	}
+
+	const auto Start = std::chrono::steady_clock::now();
+	const FSimResults Results = Sweep.Run();
+	const double Elapsed = std::chrono::duration<double>(std::chrono::steady_clock::now() - Start).count();
+	if (GroupCache.IsOpen()) std::printf("Group cache : %d hit%s, %d miss%s\n", GroupCache.GetHits(), GroupCache.GetHits() != 1 ? "s" : "",
+		GroupCache.GetMisses(), GroupCache.GetMisses() != 1 ? "es" : "");
+	return ReportResults(Results, Sweep.GetSimulationCount(), Elapsed, Options);
+}
@@ -0,0 +1,372 @@
+#include "DroSimCoordinator.h"
+
+#include <algorithm>
+#include <cerrno>
+#include <csignal>
+#include <cstdio>
+#include <cstring>
+#include <fcntl.h>
+#include <iostream>
+#include <poll.h>
+#include <sys/wait.h>
+#include <unistd.h>
+
+#include "SimCore/SimGroupCache.h"
+#include "SimCore/SimRecords.h"
+#include "SimCore/SimSweep.h"
+#include "SimCore/SimTrajectory.h"
+
+using namespace DroSimCore;
+
+namespace DroSimCli
+{
+	namespace
+	{
+		void CloseDescriptor(int& Descriptor)
+		{
+			if (Descriptor < 0) return;
+			close(Descriptor);
+			Descriptor = -1;
+		}
+
+
+		std::string DescribeStatus(const int Status)
+		{
+			if (WIFSIGNALED(Status)) return SimPrintf("killed by signal %d", WTERMSIG(Status));
+			return SimPrintf("exited with status %d", WEXITSTATUS(Status));
+		}
+	}
+
+
+	/**
+	 * Path of the file a shard writes instead of Path, "records.csv" becoming "records.shard2.csv".
+	 */
+	std::string ShardPath(const std::string& Path, const int ShardIndex)
+	{
+		const size_t Slash = Path.find_last_of("/\\");
+		const size_t Dot = Path.find_last_of('.');
+		const bool HasExtension = Dot != std::string::npos && (Slash == std::string::npos || Dot > Slash) && Dot > 0;
+		const std::string Suffix = SimPrintf(".shard%d", ShardIndex);
+		return HasExtension ? Path.substr(0, Dot) + Suffix + Path.substr(Dot) : Path + Suffix;
+	}
+
+
+	/**
+	 * Worker side of the protocol: runs the shards read from stdin and writes their results to stdout.
+	 *
+	 * Records and trajectories of a shard go to their own files, see ShardPath, started over when the shard
+	 * is run again after a crash. Workers share the group cache of Config.CacheDir, if any.
+	 *
+	 * @returns 0 once stdin is closed, 1 on a malformed message or a file that cannot be opened.
+	 */
+	int RunWorker(const FSimConfig& Config, const uint32_t Seed, const std::string& RecordsPath, const std::string& TrajectoryPath)
+	{
+		FSimGroupCache GroupCache;
+		std::string CacheError;
+		if (!Config.CacheDir.empty() && !GroupCache.Open(Config.CacheDir, CacheError))
+		{
+			std::fprintf(stderr, "%s\n", CacheError.c_str());
+			return 1;
+		}
+
+		std::string Line;
+		while (std::getline(std::cin, Line))
+		{
+			FSimShard Shard;
+			unsigned long long FirstSimulationID;
+			if (std::sscanf(Line.c_str(), "shard %d %d %d %llu", &Shard.Index, &Shard.MinNumDrones, &Shard.MaxNumDrones, &FirstSimulationID) != 4)
+			{
+				std::fprintf(stderr, "Unexpected message from the coordinator: %s\n", Line.c_str());
+				return 1;
+			}
+			Shard.FirstSimulationID = FirstSimulationID;
+
+			const FSimConfig ShardConfig = Shard.Apply(Config);
+			FSimSweep Sweep(ShardConfig, Seed);
+			Sweep.SetFirstSimulationID(Shard.FirstSimulationID);
+			if (GroupCache.IsOpen()) Sweep.SetGroupCache(&GroupCache);
+
+			std::string Error;
+			FSimRecordWriter RecordWriter;
+			if (!RecordsPath.empty())
+			{
+				const std::string Path = ShardPath(RecordsPath, Shard.Index);
+				std::remove(Path.c_str());
+				if (!RecordWriter.Open(Path, Error))
+				{
+					std::fprintf(stderr, "%s\n", Error.c_str());
+					return 1;
+				}
+				Sweep.SetRecordWriter(&RecordWriter);
+			}
+			FSimTrajectoryWriter TrajectoryWriter;
+			if (!TrajectoryPath.empty())
+			{
+				if (!TrajectoryWriter.Open(ShardPath(TrajectoryPath, Shard.Index), Error))
+				{
+					std::fprintf(stderr, "%s\n", Error.c_str());
+					return 1;
+				}
+				Sweep.SetTrajectoryWriter(&TrajectoryWriter);
+			}
+
+			const FSimResults Results = Sweep.Run();
+			RecordWriter.Close();
+			TrajectoryWriter.Close();
+
+			// Floats with 9 significant digits are read back exactly
+			if (Results.HasFastConfig)
+				std::printf("fast %.9g %d %.9g\n", Results.FastConfig.Speed, Results.FastConfig.BatteryCount, Results.FastConfig.Weight);
+			for (const FSimConfigResult& sc : Results.SlowConfigs)
+				std::printf("slow %.9g %d %d %.9g\n", sc.Speed, sc.NumDrones, sc.BatteryCount, sc.Weight);
+			std::printf("done %d %d\n", Shard.Index, Sweep.GetSimulationCount());
+			std::fflush(stdout);
+		}
+		return 0;
+	}
+
+
+	FSimCoordinator::FSimCoordinator(const FSimConfig& Config, const FWorkerCommand& InCommand, const int InNumWorkers, const int NumShards)
+		: Command(InCommand)
+		, Shards(MakeShards(Config, NumShards))
+		, Attempts(Shards.size(), 0)
+		, ShardResults(Shards.size())
+	{
+		NumWorkers = std::max(1, std::min(InNumWorkers, (int)Shards.size()));
+		for (const FSimShard& Shard : Shards) PendingShards.push_back(Shard.Index);
+		RemainingShards = (int)Shards.size();
+	}
+
+
+	/**
+	 * Runs every shard and merges their results.
+	 *
+	 * @returns False if a worker cannot be started or a shard failed MaxAttempts times.
+	 */
+	bool FSimCoordinator::Run(FSimResults& OutResults, std::string& OutError)
+	{
+		// A worker dying while being written to must not take the coordinator with it
+		std::signal(SIGPIPE, SIG_IGN);
+
+		std::vector<FWorker> Workers(NumWorkers);
+		bool IsFailed = false;
+		for (FWorker& Worker : Workers)
+		{
+			if (!Spawn(Worker, OutError))
+			{
+				IsFailed = true;
+				break;
+			}
+			AssignNext(Worker);
+		}
+
+		std::vector<pollfd> Descriptors;
+		std::vector<FWorker*> Polled;
+		while (RemainingShards > 0 && !IsFailed)
+		{
+			Descriptors.clear();
+			Polled.clear();
+			for (FWorker& Worker : Workers)
+				if (Worker.Output >= 0)
+				{
+					Descriptors.push_back({Worker.Output, POLLIN, 0});
+					Polled.push_back(&Worker);
+				}
+
+			if (poll(Descriptors.data(), Descriptors.size(), -1) < 0)
+			{
+				if (errno == EINTR) continue;
+				OutError = SimPrintf("poll failed: %s", std::strerror(errno));
+				IsFailed = true;
+				break;
+			}
+
+			for (size_t i = 0; i < Descriptors.size() && !IsFailed; i++)
+			{
+				if (!Descriptors[i].revents) continue;
+				FWorker& Worker = *Polled[i];
+
+				char Buffer[4096];
+				const ssize_t Size = read(Worker.Output, Buffer, sizeof(Buffer));
+				if (Size < 0 && errno == EINTR) continue;
+				if (Size > 0)
+				{
+					Worker.Received.append(Buffer, (size_t)Size);
+					size_t LineEnd;
+					while (!IsFailed && (LineEnd = Worker.Received.find('\n')) != std::string::npos)
+					{
+						const std::string Line = Worker.Received.substr(0, LineEnd);
+						Worker.Received.erase(0, LineEnd + 1);
+						IsFailed = !HandleLine(Worker, Line, OutError);
+					}
+					continue;
+				}
+
+				// End of output: the worker exited, idle ones once their stdin is closed
+				const int Shard = Worker.Shard;
+				const int Status = Reap(Worker);
+				if (Shard < 0) continue;
+
+				if (Attempts[Shard] >= MaxAttempts)
+				{
+					OutError = SimPrintf("Shard %d failed %d times, last worker %s", Shard, Attempts[Shard], DescribeStatus(Status).c_str());
+					IsFailed = true;
+					break;
+				}
+				Log(SimPrintf("Worker of shard %d %s, restarting the shard", Shard, DescribeStatus(Status).c_str()));
+				PendingShards.push_front(Shard);
+				if (!Spawn(Worker, OutError))
+				{
+					IsFailed = true;
+					break;
+				}
+				AssignNext(Worker);
+			}
+		}
+
+		for (FWorker& Worker : Workers)
+		{
+			if (IsFailed && Worker.Pid > 0) kill(Worker.Pid, SIGTERM);
+			Reap(Worker);
+		}
+		if (IsFailed) return false;
+
+		OutResults = MergeShardResults(ShardResults);
+		return true;
+	}
+
+
+	/**
+	 * Starts a worker process, with pipes to its stdin and from its stdout. Its stderr is the coordinator's.
+	 */
+	bool FSimCoordinator::Spawn(FWorker& Worker, std::string& OutError) const
+	{
+		std::vector<char*> Argv;
+		Argv.push_back(const_cast<char*>(Command.Executable.c_str()));
+		for (const std::string& Argument : Command.Arguments) Argv.push_back(const_cast<char*>(Argument.c_str()));
+		Argv.push_back(const_cast<char*>("--worker"));
+		Argv.push_back(nullptr);
+
+		int ToWorker[2];
+		int FromWorker[2];
+		if (pipe(ToWorker) != 0)
+		{
+			OutError = SimPrintf("Cannot create a worker pipe: %s", std::strerror(errno));
+			return false;
+		}
+		if (pipe(FromWorker) != 0)
+		{
+			OutError = SimPrintf("Cannot create a worker pipe: %s", std::strerror(errno));
+			close(ToWorker[0]);
+			close(ToWorker[1]);
+			return false;
+		}
+
+		// Later workers must not inherit this one's pipes, it would never see the end of its stdin
+		fcntl(ToWorker[1], F_SETFD, FD_CLOEXEC);
+		fcntl(FromWorker[0], F_SETFD, FD_CLOEXEC);
+
+		const pid_t Pid = fork();
+		if (Pid < 0)
+		{
+			OutError = SimPrintf("Cannot start a worker: %s", std::strerror(errno));
+			for (const int Descriptor : {ToWorker[0], ToWorker[1], FromWorker[0], FromWorker[1]}) close(Descriptor);
+			return false;
+		}
+		if (Pid == 0)
+		{
+			dup2(ToWorker[0], STDIN_FILENO);
+			dup2(FromWorker[1], STDOUT_FILENO);
+			for (const int Descriptor : {ToWorker[0], ToWorker[1], FromWorker[0], FromWorker[1]}) close(Descriptor);
+			execvp(Argv[0], Argv.data());
+			_exit(127);
+		}
+
+		close(ToWorker[0]);
+		close(FromWorker[1]);
+		Worker.Pid = Pid;
+		Worker.Input = ToWorker[1];
+		Worker.Output = FromWorker[0];
+		Worker.Shard = -1;
+		Worker.Received.clear();
+		return true;
+	}
+
+
+	/**
+	 * Hands the next pending shard to an idle worker, or closes its stdin so that it exits if none is left.
+	 *
+	 * A failed write is not handled here: the worker is gone, and the end of its output restarts the shard.
+	 */
+	void FSimCoordinator::AssignNext(FWorker& Worker)
+	{
+		if (PendingShards.empty())
+		{
+			Worker.Shard = -1;
+			CloseDescriptor(Worker.Input);
+			return;
+		}
+
+		const FSimShard& Shard = Shards[PendingShards.front()];
+		PendingShards.pop_front();
+		Worker.Shard = Shard.Index;
+		Worker.Results = FSimResults();
+		Attempts[Shard.Index]++;
+
+		const std::string Message = SimPrintf("shard %d %d %d %llu\n", Shard.Index, Shard.MinNumDrones, Shard.MaxNumDrones,
+			(unsigned long long)Shard.FirstSimulationID);
+		if (write(Worker.Input, Message.data(), Message.size()) != (ssize_t)Message.size())
+			CloseDescriptor(Worker.Input);
+	}
+
+
+	/**
+	 * Reads one line of a worker's output into the results of its shard.
+	 */
+	bool FSimCoordinator::HandleLine(FWorker& Worker, const std::string& Line, std::string& OutError)
+	{
+		FSimConfigResult Result;
+		int Shard;
+		int Simulations;
+		if (Worker.Shard >= 0 && std::sscanf(Line.c_str(), "fast %f %d %f", &Result.Speed, &Result.BatteryCount, &Result.Weight) == 3)
+		{
+			Worker.Results.HasFastConfig = true;
+			Worker.Results.FastConfig = Result;
+		}
+		else if (Worker.Shard >= 0 && std::sscanf(Line.c_str(), "slow %f %d %d %f", &Result.Speed, &Result.NumDrones, &Result.BatteryCount, &Result.Weight) == 4)
+			Worker.Results.SlowConfigs.push_back(Result);
+		else if (std::sscanf(Line.c_str(), "done %d %d", &Shard, &Simulations) == 2 && Shard == Worker.Shard)
+		{
+			const FSimShard& Done = Shards[Shard];
+			ShardResults[Shard] = Worker.Results;
+			SimulationCount += Simulations;
+			RemainingShards--;
+			Log(SimPrintf("Shard %d (drone counts from %d, below %d) done, %d simulations, %d shard%s left", Shard, Done.MinNumDrones,
+				Done.MaxNumDrones, Simulations, RemainingShards, RemainingShards != 1 ? "s" : ""));
+			AssignNext(Worker);
+		}
+		else
+		{
+			OutError = "Unexpected message from a worker: " + Line;
+			return false;
+		}
+		return true;
+	}
+
+
+	/**
+	 * Closes the pipes of a worker and waits for its process to exit.
+	 *
+	 * @returns The wait status of the process, 0 if there was none.
+	 */
+	int FSimCoordinator::Reap(FWorker& Worker)
+	{
+		CloseDescriptor(Worker.Input);
+		CloseDescriptor(Worker.Output);
+		int Status = 0;
+		if (Worker.Pid > 0)
+			while (waitpid(Worker.Pid, &Status, 0) < 0 && errno == EINTR) {}
+		Worker.Pid = -1;
+		return Status;
+	}
+}
@@ -0,0 +1,86 @@
+#pragma once
+
+#include <cstdint>
+#include <deque>
+#include <string>
+#include <sys/types.h>
+#include <vector>
+
+#include "SimCore/SimConfig.h"
+#include "SimCore/SimResults.h"
+#include "SimCore/SimShards.h"
+
+namespace DroSimCli
+{
+	/*
+	 * Coordinator to worker protocol, one line per message over the worker's stdin and stdout:
+	 *
+	 *   shard <index> <min drones> <max drones> <first simulation id>     coordinator to worker
+	 *   fast <speed> <batteries> <weight>                                 worker to coordinator, if found
+	 *   slow <speed> <drones> <batteries> <weight>                        worker to coordinator, one per slow config
+	 *   done <index> <simulations>                                        worker to coordinator, shard finished
+	 *
+	 * A worker runs shards until its stdin is closed. Nothing else ties it to the coordinator, so a worker
+	 * command can just as well start the worker on another machine, as long as it has the same configuration.
+	 */
+
+	/** How a worker process is started, its executable and the arguments it needs besides --worker. */
+	struct FWorkerCommand
+	{
+		std::string Executable;
+		std::vector<std::string> Arguments;
+	};
+
+	std::string ShardPath(const std::string& Path, int ShardIndex);
+	int RunWorker(const DroSimCore::FSimConfig& Config, uint32_t Seed, const std::string& RecordsPath, const std::string& TrajectoryPath);
+
+	/**
+	 * Runs a parameter sweep split in shards across local worker processes, see DroSimCore::MakeShards.
+	 *
+	 * At most NumWorkers processes run at a time, each being handed a new shard as soon as it reports the last
+	 * one. A worker that exits or crashes with a shard in progress is replaced, and the shard is run again from
+	 * its start, up to MaxAttempts times. Shards are deterministic: the merged results do not depend on which
+	 * worker ran what, nor on restarts.
+	 */
+	class FSimCoordinator
+	{
+	public:
+		FSimCoordinator(const DroSimCore::FSimConfig& Config, const FWorkerCommand& InCommand, int InNumWorkers, int NumShards);
+
+		void SetLogger(const DroSimCore::FSimLogger& InLogger) { Logger = InLogger; }
+
+		bool Run(DroSimCore::FSimResults& OutResults, std::string& OutError);
+
+		int GetNumShards() const { return (int)Shards.size(); }
+		int GetSimulationCount() const { return SimulationCount; }
+
+		static constexpr int MaxAttempts = 3;
+
+	private:
+		struct FWorker
+		{
+			pid_t Pid = -1;
+			int Input = -1;
+			int Output = -1;
+			int Shard = -1;
+			std::string Received;
+			DroSimCore::FSimResults Results;
+		};
+
+		bool Spawn(FWorker& Worker, std::string& OutError) const;
+		void AssignNext(FWorker& Worker);
+		bool HandleLine(FWorker& Worker, const std::string& Line, std::string& OutError);
+		int Reap(FWorker& Worker);
+		void Log(const std::string& Text) const { if (Logger) Logger(Text); }
+
+		FWorkerCommand Command;
+		int NumWorkers;
+		std::vector<DroSimCore::FSimShard> Shards;
+		std::deque<int> PendingShards;
+		std::vector<int> Attempts;
+		std::vector<DroSimCore::FSimResults> ShardResults;
+		DroSimCore::FSimLogger Logger;
+		int RemainingShards = 0;
+		int SimulationCount = 0;
+	};
+}
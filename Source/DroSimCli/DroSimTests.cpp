@@ -0,0 +1,417 @@
+/**
+ * Tests of the DroSim simulation core, run by ctest.
+ *
+ * Each test checks one part of the core against values worked out by hand: swept-sphere detection, the
+ * independence of the random streams, group verdicts, the coverage map, the zone partitioners, and the round
+ * trips of checkpoints, the group cache and trajectory files.
+ *
+ * Usage: DroSimTests [<test name>...]
+ *
+ * Every test runs when no name is given. Files are written to a DroSimTests.tmp directory in the working
+ * directory, removed once done.
+ */
+
+#include <algorithm>
+#include <cmath>
+#include <cstdio>
+#include <cstring>
+#include <filesystem>
+#include <functional>
+#include <string>
+#include <vector>
+
+#include "SimCore/SimCheckpoint.h"
+#include "SimCore/SimConfig.h"
+#include "SimCore/SimCoverage.h"
+#include "SimCore/SimDetection.h"
+#include "SimCore/SimGroupCache.h"
+#include "SimCore/SimOracle.h"
+#include "SimCore/SimRandom.h"
+#include "SimCore/SimSearch.h"
+#include "SimCore/SimTrajectory.h"
+#include "SimCore/SimZones.h"
+#include "SimCore/Simulation.h"
+
+using namespace DroSimCore;
+
+namespace
+{
+	int Failures = 0;
+	const std::string TempDirectory = "DroSimTests.tmp";
+
+	void Check(const bool Condition, const char* Text, const char* File, const int Line)
+	{
+		if (Condition) return;
+		Failures++;
+		std::printf("  %s:%d: check failed: %s\n", File, Line, Text);
+	}
+
+#define DROSIM_CHECK(Condition) Check((Condition), #Condition, __FILE__, __LINE__)
+#define DROSIM_CHECK_NEAR(Value, Expected, Tolerance) Check(std::abs((Value) - (Expected)) <= (Tolerance), #Value " near " #Expected, __FILE__, __LINE__)
+
+
+	double ZoneArea(const FSimZone& Zone)
+	{
+		return (Zone.TopLeft.X - Zone.BottomRight.X) * (Zone.BottomRight.Y - Zone.TopLeft.Y);
+	}
+
+
+	double OverlapArea(const FSimZone& A, const FSimZone& B)
+	{
+		const double X = std::min(A.TopLeft.X, B.TopLeft.X) - std::max(A.BottomRight.X, B.BottomRight.X);
+		const double Y = std::min(A.BottomRight.Y, B.BottomRight.Y) - std::max(A.TopLeft.Y, B.TopLeft.Y);
+		return X > 0 && Y > 0 ? X * Y : 0;
+	}
+
+
+	void TestDetection()
+	{
+		double Alpha = -1;
+
+		// Passing by a static objective 10 away with a radius of 20: contact at 50 - sqrt(20² - 10²)
+		DROSIM_CHECK(FindFirstContact(FSimVec3(0, 0, 0), FSimVec3(100, 0, 0), FSimVec3(50, 10, 0), 20, Alpha));
+		DROSIM_CHECK_NEAR(Alpha, (50 - std::sqrt(300.0)) / 100, 1e-9);
+		DROSIM_CHECK(!FindFirstContact(FSimVec3(0, 0, 0), FSimVec3(100, 0, 0), FSimVec3(50, 30, 0), 20, Alpha));
+
+		// Already in contact at the start of the step
+		DROSIM_CHECK(FindFirstContact(FSimVec3(0, 0, 0), FSimVec3(100, 0, 0), FSimVec3(5, 0, 0), 20, Alpha));
+		DROSIM_CHECK_NEAR(Alpha, 0.0, 1e-9);
+
+		// A step far longer than the radius does not tunnel through the objective
+		DROSIM_CHECK(FindFirstContact(FSimVec3(0, 0, 0), FSimVec3(100000, 0, 0), FSimVec3(50000, 5, 0), 10, Alpha));
+
+		// Head-on: 100 apart closing at 200 per step, in contact once 10 apart
+		DROSIM_CHECK(FindFirstContact(FSimVec3(0, 0, 0), FSimVec3(100, 0, 0), FSimVec3(100, 0, 0), FSimVec3(0, 0, 0), 10, Alpha));
+		DROSIM_CHECK_NEAR(Alpha, 0.45, 1e-9);
+
+		// Moving the same way at the same speed, never closer than 50
+		DROSIM_CHECK(!FindFirstContact(FSimVec3(0, 0, 0), FSimVec3(100, 0, 0), FSimVec3(0, 50, 0), FSimVec3(100, 50, 0), 20, Alpha));
+	}
+
+
+	void TestRandomStreams()
+	{
+		// Streams replay the same draws whatever was drawn from the others in between
+		FSimRandom A = FSimRandom::ForStream(7, 3, 1);
+		FSimRandom B = FSimRandom::ForStream(7, 3, 2);
+		std::vector<uint64_t> DrawsA, DrawsB;
+		for (int i = 0; i < 16; i++)
+		{
+			DrawsA.push_back(A.Next());
+			if (i % 3 == 0) DrawsB.push_back(B.Next());
+		}
+		FSimRandom ReplayA = FSimRandom::ForStream(7, 3, 1);
+		FSimRandom ReplayB = FSimRandom::ForStream(7, 3, 2);
+		for (const uint64_t Draw : DrawsA) DROSIM_CHECK(ReplayA.Next() == Draw);
+		for (const uint64_t Draw : DrawsB) DROSIM_CHECK(ReplayB.Next() == Draw);
+
+		// Any part of the key gives another stream
+		const uint64_t First = FSimRandom::ForStream(7, 3, 1).Next();
+		DROSIM_CHECK(FSimRandom::ForStream(8, 3, 1).Next() != First);
+		DROSIM_CHECK(FSimRandom::ForStream(7, 4, 1).Next() != First);
+		DROSIM_CHECK(FSimRandom::ForStream(7, 3, 0).Next() != First);
+
+		// Integer ranges reach both bounds, floating point ones never their upper bound
+		FSimRandom Random(42);
+		bool HasMin = false, HasMax = false, IsInRange = true;
+		for (int i = 0; i < 1000; i++)
+		{
+			const int Value = Random.RandRange(0, 3);
+			HasMin |= Value == 0;
+			HasMax |= Value == 3;
+			IsInRange &= Value >= 0 && Value <= 3;
+			const float Float = Random.RandRange(1.f, 2.f);
+			const double Double = Random.RandRange(1., 2.);
+			IsInRange &= Float >= 1 && Float < 2 && Double >= 1 && Double < 2;
+		}
+		DROSIM_CHECK(HasMin && HasMax && IsInRange);
+	}
+
+
+	void TestEvaluateGroup()
+	{
+		FSimConfig Config;
+		Config.SimGroupSize = 6;
+
+		// Without early stopping, only a full group is decided, at half of it successful
+		Config.EarlyStopping = ESimEarlyStopping::None;
+		DROSIM_CHECK(EvaluateGroup(Config, 5, 5) == ESimGroupVerdict::Undecided);
+		DROSIM_CHECK(EvaluateGroup(Config, 6, 3) == ESimGroupVerdict::Success);
+		DROSIM_CHECK(EvaluateGroup(Config, 6, 2) == ESimGroupVerdict::Fail);
+
+		// Settled: as soon as the remaining replicas cannot change the vote
+		Config.EarlyStopping = ESimEarlyStopping::Settled;
+		DROSIM_CHECK(EvaluateGroup(Config, 0, 0) == ESimGroupVerdict::Undecided);
+		DROSIM_CHECK(EvaluateGroup(Config, 3, 3) == ESimGroupVerdict::Success);
+		DROSIM_CHECK(EvaluateGroup(Config, 4, 0) == ESimGroupVerdict::Fail);
+		DROSIM_CHECK(EvaluateGroup(Config, 4, 1) == ESimGroupVerdict::Undecided);
+
+		// SPRT, 0.3 against 0.7: each outcome moves the log-likelihood ratio by ln(7/3), the bounds are at ±ln(19)
+		Config.EarlyStopping = ESimEarlyStopping::Sprt;
+		Config.SimGroupSize = 20;
+		DROSIM_CHECK(EvaluateGroup(Config, 3, 3) == ESimGroupVerdict::Undecided);
+		DROSIM_CHECK(EvaluateGroup(Config, 4, 4) == ESimGroupVerdict::Success);
+		DROSIM_CHECK(EvaluateGroup(Config, 4, 0) == ESimGroupVerdict::Fail);
+		DROSIM_CHECK(EvaluateGroup(Config, 5, 4) == ESimGroupVerdict::Undecided);
+		DROSIM_CHECK(EvaluateGroup(Config, 20, 10) == ESimGroupVerdict::Success);
+	}
+
+
+	void TestCoverage()
+	{
+		FSimConfig Config;
+		Config.EnvSize = FSimVec2(10000, 10000);
+		Config.VisionRadius = 1000;
+		Config.ObjectiveIsMoving = false;
+		Config.CoverageStallTime = 100;
+		const std::vector<FSimZone> Zones = FSimStripPartitioner().Partition(Config.EnvSize, 2);
+
+		FSimCoverage Coverage;
+		Coverage.Reset(Config, Zones);
+		DROSIM_CHECK(Coverage.GetCoverage() == 0);
+
+		// A disc of radius 1000 in a zone of 10000 x 5000 covers about π / 50 of it
+		Coverage.Stamp(0, FSimVec3(5000, 2500, 0), 0);
+		DROSIM_CHECK_NEAR(Coverage.GetZoneCoverage(0), 3.14159 / 50, .01);
+		DROSIM_CHECK(Coverage.GetZoneCoverage(1) == 0);
+
+		// Stamping the same place again covers nothing new
+		const double Covered = Coverage.GetCoverage();
+		Coverage.Stamp(0, FSimVec3(5000, 2500, 0), 10);
+		DROSIM_CHECK(Coverage.GetCoverage() == Covered);
+
+		// Hopeless once both drones stalled for coverage_stall_time away from the objective, not if one saw it
+		const FSimVec3 Objective(9000, 9000, 0);
+		Coverage.Stamp(1, FSimVec3(1000, 6000, 0), 0);
+		DROSIM_CHECK(!Coverage.IsHopeless(Objective, 50));
+		DROSIM_CHECK(Coverage.IsHopeless(Objective, 150));
+		DROSIM_CHECK(!Coverage.IsHopeless(FSimVec3(5000, 2500, 0), 150));
+	}
+
+
+	void TestZonePartitioners()
+	{
+		const FSimVec2 EnvSize(15000, 12000);
+		const double MinDistanceRatio = .3;
+		const std::unique_ptr<FSimZonePartitioner> Partitioners[] = {
+			std::make_unique<FSimGridPartitioner>(3),
+			std::make_unique<FSimStripPartitioner>(),
+			std::make_unique<FSimBalancedPartitioner>(3, MinDistanceRatio)};
+
+		for (int p = 0; p < 3; p++)
+			for (int NumDrones = 1; NumDrones <= 10; NumDrones++)
+			{
+				const std::vector<FSimZone> Zones = Partitioners[p]->Partition(EnvSize, NumDrones);
+				DROSIM_CHECK((int)Zones.size() == NumDrones);
+
+				// Zones tile the environment, or the band the objective spawns in for the balanced partition
+				const bool IsBalanced = p == 2;
+				const double Area = EnvSize.Y * EnvSize.X * (IsBalanced ? 1 - MinDistanceRatio : 1);
+				double SummedArea = 0;
+				for (size_t i = 0; i < Zones.size(); i++)
+				{
+					DROSIM_CHECK(Zones[i].BottomRight.X >= -1e-6 && Zones[i].TopLeft.X <= EnvSize.X + 1e-6);
+					DROSIM_CHECK(Zones[i].TopLeft.Y >= -1e-6 && Zones[i].BottomRight.Y <= EnvSize.Y + 1e-6);
+					if (IsBalanced) DROSIM_CHECK_NEAR(ZoneArea(Zones[i]), Area / NumDrones, 1e-3);
+					SummedArea += ZoneArea(Zones[i]);
+					for (size_t j = i + 1; j < Zones.size(); j++) DROSIM_CHECK(OverlapArea(Zones[i], Zones[j]) < 1e-3);
+				}
+				DROSIM_CHECK_NEAR(SummedArea, Area, 1e-3);
+			}
+
+		// The shared cache hands out the zones of the configured partitioner, and the same ones every time
+		FSimConfig Config;
+		Config.Partition = ESimPartition::Strips;
+		const std::vector<FSimZone>& Cached = FSimZoneCache::Shared().Get(Config, 4);
+		DROSIM_CHECK(&Cached == &FSimZoneCache::Shared().Get(Config, 4));
+		DROSIM_CHECK(Cached.size() == 4 && Cached[1].TopLeft.Y == Config.EnvSize.Y / 4);
+	}
+
+
+	void TestSweepOracle()
+	{
+		FSimConfig Config;
+		const FSimGroupParams Params = FSimSearch::Make(Config)->MakeGroupParams(Config.MinSpeed, 3);
+		for (uint64_t SimulationID = 0; SimulationID < 8; SimulationID++)
+		{
+			const FSimOutcome Stepped = FSimulation(Config, Params, 1, SimulationID).Run();
+			const FSimOutcome Oracle = FSimSweepOracle(Config, Params, 1, SimulationID).Run();
+			DROSIM_CHECK(Stepped.Found == Oracle.Found);
+			DROSIM_CHECK_NEAR(Stepped.TimeToFind, Oracle.TimeToFind, Config.Step * 1e-3f);
+		}
+	}
+
+
+	void TestCheckpoint()
+	{
+		FSimConfig Config;
+		Config.IniHash = 1234;
+		Config.SearchMode = ESimSearchMode::Bisection;
+
+		FSimCheckpoint Saved;
+		Saved.Producer = ESimCheckpointProducer::Cli;
+		Saved.SearchMode = Config.SearchMode;
+		Saved.ConfigHash = Config.IniHash;
+		Saved.Seed = 99;
+		Saved.NextSimulationID = 1ull << 33;
+		Saved.GroupCount = 12;
+		Saved.SimulationCount = 70;
+		Saved.RecordsSize = 4096;
+		Saved.SearchState = {1, 2, 3, 250};
+
+		std::string Error;
+		const std::string Path = TempDirectory + "/checkpoint.bin";
+		DROSIM_CHECK(Saved.Save(Path, Error));
+		FSimCheckpoint Loaded;
+		DROSIM_CHECK(Loaded.Load(Path, Error));
+		DROSIM_CHECK(Loaded.Seed == 99 && Loaded.NextSimulationID == 1ull << 33 && Loaded.GroupCount == 12);
+		DROSIM_CHECK(Loaded.SimulationCount == 70 && Loaded.RecordsSize == 4096 && Loaded.SearchState == Saved.SearchState);
+		DROSIM_CHECK(Loaded.Matches(ESimCheckpointProducer::Cli, Config, Error));
+		DROSIM_CHECK(!Loaded.Matches(ESimCheckpointProducer::Engine, Config, Error));
+		Config.IniHash = 4321;
+		DROSIM_CHECK(!Loaded.Matches(ESimCheckpointProducer::Cli, Config, Error));
+
+		// A truncated file is refused rather than read back wrong
+		std::filesystem::resize_file(Path, std::filesystem::file_size(Path) - 1);
+		DROSIM_CHECK(!Loaded.Load(Path, Error));
+	}
+
+
+	void TestGroupCache()
+	{
+		FSimConfig Config;
+		Config.SimGroupSize = 2;
+		const FSimGroupParams Params = FSimSearch::Make(Config)->MakeGroupParams(16, 2);
+
+		FSimGroupOutcome Outcome;
+		Outcome.RunSims = 2;
+		Outcome.SuccessfulSims = 1;
+		Outcome.SummedTimesToFind = 1500;
+		Outcome.SummedConsumptions = 420;
+		Outcome.IsSuccessful = true;
+		Outcome.FirstSimulationID = 6;
+		Outcome.Outcomes.resize(2);
+		Outcome.Outcomes[0].Found = true;
+		Outcome.Outcomes[0].TimeToFind = Outcome.Outcomes[0].FlightTime = 1500;
+		Outcome.Outcomes[0].Consumption = 420;
+		Outcome.Outcomes[1].EndedHopeless = true;
+		Outcome.Outcomes[1].FlightTime = 900;
+
+		FSimGroupCache Cache;
+		std::string Error;
+		DROSIM_CHECK(Cache.Open(TempDirectory + "/cache", Error));
+		Cache.Add(Config, Params, 5, 6, Outcome);
+
+		FSimGroupOutcome Found;
+		DROSIM_CHECK(Cache.Find(Config, Params, 5, 6, Found));
+		DROSIM_CHECK(Found.RunSims == 2 && Found.SuccessfulSims == 1 && Found.IsSuccessful && Found.FirstSimulationID == 6);
+		DROSIM_CHECK(Found.SummedTimesToFind == 1500 && Found.SummedConsumptions == 420 && Found.Outcomes.size() == 2);
+		DROSIM_CHECK(Found.Outcomes[0].Found && Found.Outcomes[0].Consumption == 420);
+		DROSIM_CHECK(Found.Outcomes[1].EndedHopeless && Found.Outcomes[1].FlightTime == 900);
+
+		// Another seed, other simulation IDs or other parameters are other groups
+		DROSIM_CHECK(!Cache.Find(Config, Params, 4, 6, Found));
+		DROSIM_CHECK(!Cache.Find(Config, Params, 5, 12, Found));
+		DROSIM_CHECK(!Cache.Find(Config, FSimSearch::Make(Config)->MakeGroupParams(18, 2), 5, 6, Found));
+		DROSIM_CHECK(Cache.GetHits() == 1 && Cache.GetMisses() == 3);
+	}
+
+
+	void TestTrajectory()
+	{
+		// Two simulations of an objective and two drones, long enough to go past a keyframe
+		const int NumFrames = FSimTrajectoryBuilder::KeyframeInterval * 2 + 5;
+		const auto PositionAt = [](const uint64_t SimulationID, const int Frame, const int Entity)
+		{
+			return FSimVec3(100.0 * Frame + Entity, 7.0 * SimulationID - 3.0 * Frame * Entity, 250.0 * Entity);
+		};
+
+		std::string Error;
+		const std::string Path = TempDirectory + "/trajectory.bin";
+		{
+			FSimTrajectoryWriter Writer;
+			DROSIM_CHECK(Writer.Open(Path, Error));
+			for (const uint64_t SimulationID : {3ull, 11ull})
+			{
+				FSimTrajectoryBuilder Builder(SimulationID, 1, 2, 1);
+				std::vector<FSimVec3> Positions(3);
+				for (int Frame = 0; Frame < NumFrames; Frame++)
+				{
+					for (int Entity = 0; Entity < 3; Entity++) Positions[Entity] = PositionAt(SimulationID, Frame, Entity);
+					Builder.AddFrame(Positions);
+				}
+				Writer.AddSimulation(Builder);
+			}
+			Writer.Close();
+		}
+
+		FSimTrajectoryReader Reader;
+		DROSIM_CHECK(Reader.Open(Path, Error));
+		std::vector<uint64_t> IDs = Reader.GetSimulationIDs();
+		std::sort(IDs.begin(), IDs.end());
+		DROSIM_CHECK(IDs == std::vector<uint64_t>({3, 11}));
+
+		FSimTrajectoryInfo Info;
+		DROSIM_CHECK(Reader.GetInfo(11, Info));
+		DROSIM_CHECK(Info.NumEntities == 3 && Info.NumObjectives == 1 && Info.NumFrames == NumFrames && Info.Step == 1);
+		DROSIM_CHECK(!Reader.GetInfo(4, Info));
+
+		// Frames decode from the keyframe before them, to the centimetre
+		std::vector<FSimVec3> Positions;
+		for (const int Frame : {0, 1, FSimTrajectoryBuilder::KeyframeInterval, NumFrames - 1})
+		{
+			DROSIM_CHECK(Reader.ReadFrame(11, Frame, Positions) && Positions.size() == 3);
+			for (int Entity = 0; Entity < (int)Positions.size(); Entity++)
+				DROSIM_CHECK(FSimVec3::Dist(Positions[Entity], PositionAt(11, Frame, Entity)) < .01);
+		}
+		DROSIM_CHECK(!Reader.ReadFrame(11, NumFrames, Positions));
+	}
+
+
+	struct FTest
+	{
+		const char* Name;
+		std::function<void()> Run;
+	};
+}
+
+
+int main(int Argc, char** Argv)
+{
+	const std::vector<FTest> Tests = {
+		{"detection", TestDetection},
+		{"random_streams", TestRandomStreams},
+		{"evaluate_group", TestEvaluateGroup},
+		{"coverage", TestCoverage},
+		{"zone_partitioners", TestZonePartitioners},
+		{"sweep_oracle", TestSweepOracle},
+		{"checkpoint", TestCheckpoint},
+		{"group_cache", TestGroupCache},
+		{"trajectory", TestTrajectory},
+	};
+
+	std::error_code FileError;
+	std::filesystem::remove_all(TempDirectory, FileError);
+	std::filesystem::create_directories(TempDirectory, FileError);
+
+	int RunTests = 0;
+	for (const FTest& Test : Tests)
+	{
+		const bool IsSelected = Argc < 2 || std::any_of(Argv + 1, Argv + Argc, [&Test](const char* Name) { return !std::strcmp(Name, Test.Name); });
+		if (!IsSelected) continue;
+		const int PreviousFailures = Failures;
+		std::printf("%s\n", Test.Name);
+		Test.Run();
+		std::printf("  %s\n", Failures == PreviousFailures ? "ok" : "FAILED");
+		RunTests++;
+	}
+
+	std::filesystem::remove_all(TempDirectory, FileError);
+	if (RunTests == 0)
+	{
+		std::fprintf(stderr, "Unknown test name\n");
+		return 2;
+	}
+	std::printf("%d check%s failed\n", Failures, Failures != 1 ? "s" : "");
+	return Failures == 0 ? 0 : 1;
+}